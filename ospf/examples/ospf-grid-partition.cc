@@ -77,7 +77,7 @@ CompareLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetLsdbHash ();
+  uint64_t hash = app->GetLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -30,6 +30,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ospf-app-helper.h"
 #include "ns3/ospf-app.h"
+#include "ns3/ospf-convergence-monitor.h"
 
 #include <cassert>
 #include <fstream>
@@ -77,7 +78,7 @@ CompareLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetLsdbHash ();
+  uint64_t hash = app->GetLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -257,6 +258,10 @@ main (int argc, char *argv[])
     }
   Simulator::Schedule (Seconds (SIM_SECONDS), CompareLsdb, c);
   Simulator::Schedule (Seconds (SIM_SECONDS), VerifyNeighbor, c);
+
+  // Exact convergence times, independent of the polls above
+  OspfConvergenceMonitor convergence;
+  convergence.Install (c);
   // Enable Pcap
   AsciiTraceHelper ascii;
   p2p.EnableAsciiAll (ascii.CreateFileStream (dirName / "ascii.tr"));
@@ -274,6 +279,10 @@ main (int argc, char *argv[])
     }
 
   Simulator::Run ();
+  std::cout << "LSDBs converged: " << convergence.IsLsdbConverged () << " at "
+            << convergence.GetLsdbConvergenceTime () << std::endl;
+  std::cout << "FIBs converged: " << convergence.IsFibConverged () << " at "
+            << convergence.GetFibConvergenceTime () << std::endl;
   Simulator::Destroy ();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+//
+// SPF kernel benchmark: binary heap vs bucket queue on the grid topologies
+// of the other examples, with random link metrics in [1, maxMetric].
+// No simulation is run; the SPF graph is built directly.
+
+#include "ns3/core-module.h"
+#include "ns3/ospf-spf-graph.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OspfSpfBenchmark");
+
+struct GridSize
+{
+  std::string name;
+  uint32_t width;
+  uint32_t height;
+};
+
+void
+BuildGrid (OspfSpfGraph &graph, uint32_t width, uint32_t height, uint32_t maxMetric,
+           std::mt19937 &rng)
+{
+  std::uniform_int_distribution<uint32_t> metric (1, maxMetric);
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> edges (width * height);
+  auto link = [&] (uint32_t a, uint32_t b) {
+    uint32_t m = metric (rng);
+    edges[a].emplace_back (b + 1, m);
+    edges[b].emplace_back (a + 1, m);
+  };
+  for (uint32_t i = 0; i < height; i++)
+    {
+      for (uint32_t j = 0; j < width; j++)
+        {
+          uint32_t v = i * width + j;
+          if (j + 1 < width)
+            {
+              link (v, v + 1);
+            }
+          if (i + 1 < height)
+            {
+              link (v, v + width);
+            }
+        }
+    }
+  graph.Clear ();
+  for (uint32_t v = 0; v < edges.size (); v++)
+    {
+      graph.SetEdges (v + 1, edges[v]);
+    }
+}
+
+// Mean microseconds per run, from every root in turn
+double
+TimeQueue (OspfSpfGraph &graph, OspfSpfGraph::Queue queue, uint32_t runs)
+{
+  graph.SetQueue (queue);
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t r = 0; r < runs; r++)
+    {
+      graph.ComputeShortestPaths (r % graph.GetNVertices ());
+    }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count () / runs;
+}
+
+bool
+SameResult (OspfSpfGraph &graph)
+{
+  uint32_t n = graph.GetNVertices ();
+  for (uint32_t root = 0; root < n; root += 1 + n / 16)
+    {
+      graph.SetQueue (OspfSpfGraph::BINARY_HEAP);
+      graph.ComputeShortestPaths (root);
+      std::vector<uint32_t> distance, parent;
+      for (uint32_t v = 0; v < n; v++)
+        {
+          distance.push_back (graph.GetDistance (v));
+          parent.push_back (graph.GetParent (v));
+        }
+      graph.SetQueue (OspfSpfGraph::BUCKET_QUEUE);
+      graph.ComputeShortestPaths (root);
+      for (uint32_t v = 0; v < n; v++)
+        {
+          if (graph.GetDistance (v) != distance[v] || graph.GetParent (v) != parent[v])
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t runs = 200;
+  uint32_t maxMetric = 10;
+  uint32_t seed = 1;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("Runs", "SPF runs per topology and queue", runs);
+  cmd.AddValue ("MaxMetric", "Largest random link metric", maxMetric);
+  cmd.AddValue ("Seed", "Seed of the link metrics", seed);
+  cmd.AddValue ("Width", "Width of an extra grid, 0 for none", width);
+  cmd.AddValue ("Height", "Height of an extra grid", height);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (runs == 0 || maxMetric == 0, "Runs and MaxMetric must be positive");
+
+  std::vector<GridSize> grids = {{"ospf-grid", 2, 10},
+                                 {"ospf-grid-random-node-out", 4, 4},
+                                 {"ospf-grid-seam", 5, 5},
+                                 {"ospf-grid-random-error", 6, 6},
+                                 {"ospf-grid-partition", 10, 5},
+                                 {"ospf-grid-area", 72, 22},
+                                 {"100x100", 100, 100}};
+  if (width > 0 && height > 0)
+    {
+      grids.push_back ({std::to_string (width) + "x" + std::to_string (height), width, height});
+    }
+
+  std::mt19937 rng (seed);
+  OspfSpfGraph graph;
+  std::cout << "MaxMetric " << maxMetric << ", " << runs << " runs per queue" << std::endl;
+  std::cout << std::left << std::setw (28) << "Topology" << std::setw (10) << "Routers"
+            << std::setw (14) << "Heap (us)" << std::setw (14) << "Bucket (us)" << std::setw (10)
+            << "Speedup"
+            << "Match" << std::endl;
+  for (auto &grid : grids)
+    {
+      BuildGrid (graph, grid.width, grid.height, maxMetric, rng);
+      if (!graph.CanUseBucketQueue ())
+        {
+          std::cout << std::setw (28) << grid.name << "metrics above "
+                    << OspfSpfGraph::MAX_BUCKET_METRIC << ", heap only" << std::endl;
+          continue;
+        }
+      bool match = SameResult (graph);
+      double heap = TimeQueue (graph, OspfSpfGraph::BINARY_HEAP, runs);
+      double bucket = TimeQueue (graph, OspfSpfGraph::BUCKET_QUEUE, runs);
+      std::cout << std::setw (28) << grid.name << std::setw (10) << graph.GetNVertices ()
+                << std::setw (14) << std::fixed << std::setprecision (2) << heap << std::setw (14)
+                << bucket << std::setw (10) << heap / bucket << (match ? "yes" : "NO")
+                << std::endl;
+    }
+  return 0;
+}
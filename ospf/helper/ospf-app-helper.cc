@@ -27,6 +27,7 @@
 #include "ns3/lsa.h"
 #include "ns3/area-lsa.h"
 #include "ospf-app-helper.h"
+#include "ospf-routing-helper.h"
 
 #include <map>
 #include <set>
@@ -241,7 +242,7 @@ OspfAppHelper::Preload (NodeContainer c)
       auto l1 = app->FetchLsa (l1Key);
       if (l1.second != nullptr)
         {
-          lsaList[app->GetArea ()].emplace_back (l1.first.Copy (), l1.second->Copy ());
+          lsaList[app->GetArea ()].emplace_back (l1);
         }
     }
 
@@ -294,6 +295,11 @@ OspfAppHelper::InstallPriv (Ptr<Node> node, Ptr<Ipv4StaticRouting> routing,
   Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
   app->SetRouterId (
       ipv4->GetAddress (1, 0).GetAddress ()); // default to the first interface address
+  Ptr<OspfRoutingProtocol> ospfRouting = OspfRoutingHelper::GetOspfRouting (ipv4);
+  if (ospfRouting != nullptr)
+    {
+      app->SetOspfRouting (ospfRouting);
+    }
   node->AddApplication (app);
   app->SetBoundNetDevices (devs);
 
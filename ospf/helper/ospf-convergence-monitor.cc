@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ospf-convergence-monitor.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OspfConvergenceMonitor");
+
+OspfConvergenceMonitor::OspfConvergenceMonitor ()
+  : m_nSplit (0),
+    m_lsdbConvergenceTime (Seconds (0)),
+    m_fibConverged (true),
+    m_lastFibChange (Seconds (0)),
+    m_fibConvergenceTime (Seconds (0)),
+    m_stopOnConvergence (false)
+{
+}
+
+void
+OspfConvergenceMonitor::Install (Ptr<OspfApp> app)
+{
+  uint32_t routerId = app->GetRouterId ().Get ();
+  NS_ASSERT_MSG (m_routers.find (routerId) == m_routers.end (),
+                 "Router " << app->GetRouterId () << " is already monitored");
+  Router &router = m_routers[routerId];
+  router.app = app;
+  router.area = app->GetArea ();
+  router.l1Digest = app->GetL1LsdbDigest ();
+  router.l2Digest = app->GetL2LsdbDigest ();
+  AddDigest (m_l1Digests[router.area], router.l1Digest);
+  AddDigest (m_l2Digests, router.l2Digest);
+  if (!IsLsdbConverged ())
+    {
+      m_fibConverged = false;
+    }
+
+  app->TraceConnectWithoutContext (
+      "LsdbChanged", MakeCallback (&OspfConvergenceMonitor::LsdbChanged, this));
+  app->TraceConnectWithoutContext ("FibChanged",
+                                   MakeCallback (&OspfConvergenceMonitor::FibChanged, this));
+}
+
+void
+OspfConvergenceMonitor::Install (NodeContainer c)
+{
+  for (uint32_t i = 0; i < c.GetN (); i++)
+    {
+      Ptr<Node> node = c.Get (i);
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<OspfApp> app = DynamicCast<OspfApp> (node->GetApplication (j));
+          if (app != nullptr)
+            {
+              Install (app);
+            }
+        }
+    }
+}
+
+void
+OspfConvergenceMonitor::SetStopOnConvergence (bool stop)
+{
+  m_stopOnConvergence = stop;
+}
+
+bool
+OspfConvergenceMonitor::IsLsdbConverged () const
+{
+  return m_nSplit == 0;
+}
+
+Time
+OspfConvergenceMonitor::GetLsdbConvergenceTime () const
+{
+  return m_lsdbConvergenceTime;
+}
+
+bool
+OspfConvergenceMonitor::IsFibConverged () const
+{
+  return m_fibConverged;
+}
+
+Time
+OspfConvergenceMonitor::GetFibConvergenceTime () const
+{
+  return m_fibConvergenceTime;
+}
+
+uint32_t
+OspfConvergenceMonitor::GetNLsdbs (uint32_t area) const
+{
+  auto it = m_l1Digests.find (area);
+  return it == m_l1Digests.end () ? 0 : it->second.size ();
+}
+
+uint32_t
+OspfConvergenceMonitor::GetNL2Lsdbs () const
+{
+  return m_l2Digests.size ();
+}
+
+void
+OspfConvergenceMonitor::AddDigest (Digests &digests, uint64_t digest)
+{
+  if (digests[digest]++ == 0 && digests.size () == 2)
+    {
+      m_nSplit++;
+    }
+}
+
+void
+OspfConvergenceMonitor::RemoveDigest (Digests &digests, uint64_t digest)
+{
+  auto it = digests.find (digest);
+  NS_ASSERT (it != digests.end ());
+  if (--it->second == 0)
+    {
+      digests.erase (it);
+      if (digests.size () == 1)
+        {
+          m_nSplit--;
+        }
+    }
+}
+
+void
+OspfConvergenceMonitor::LsdbChanged (Ipv4Address routerId, uint64_t digest)
+{
+  auto it = m_routers.find (routerId.Get ());
+  if (it == m_routers.end ())
+    {
+      return;
+    }
+  Router &router = it->second;
+  bool converged = IsLsdbConverged ();
+  RemoveDigest (m_l1Digests[router.area], router.l1Digest);
+  RemoveDigest (m_l2Digests, router.l2Digest);
+  // The combined digest cannot tell an L1 split within an area from an L2
+  // split across areas; the area may also have been reconfigured
+  router.area = router.app->GetArea ();
+  router.l1Digest = router.app->GetL1LsdbDigest ();
+  router.l2Digest = router.app->GetL2LsdbDigest ();
+  AddDigest (m_l1Digests[router.area], router.l1Digest);
+  AddDigest (m_l2Digests, router.l2Digest);
+
+  if (IsLsdbConverged ())
+    {
+      if (!converged)
+        {
+          NS_LOG_INFO ("[" << Simulator::Now () << "] LSDBs converged");
+        }
+      m_lsdbConvergenceTime = Simulator::Now ();
+      // The SPF runs the change triggered are scheduled by now
+      ScheduleFibCheck (Seconds (0));
+    }
+  else
+    {
+      m_fibConverged = false;
+      m_fibCheck.Cancel ();
+    }
+}
+
+void
+OspfConvergenceMonitor::FibChanged (Ipv4Address routerId)
+{
+  if (m_routers.find (routerId.Get ()) == m_routers.end ())
+    {
+      return;
+    }
+  m_lastFibChange = Simulator::Now ();
+  m_fibConverged = false;
+  if (IsLsdbConverged ())
+    {
+      ScheduleFibCheck (Seconds (0));
+    }
+}
+
+void
+OspfConvergenceMonitor::ScheduleFibCheck (Time delay)
+{
+  m_fibCheck.Cancel ();
+  m_fibCheck = Simulator::Schedule (delay, &OspfConvergenceMonitor::CheckFib, this);
+}
+
+void
+OspfConvergenceMonitor::CheckFib ()
+{
+  if (!IsLsdbConverged ())
+    {
+      return;
+    }
+  // Wake up with the earliest pending SPF run, FIB write batch or LSA
+  // origination instead of polling
+  Time delay = Time::Max ();
+  for (auto &[routerId, router] : m_routers)
+    {
+      delay = std::min (delay, router.app->GetRoutingDelayLeft ());
+    }
+  if (delay != Time::Max ())
+    {
+      m_fibConverged = false;
+      ScheduleFibCheck (delay);
+      return;
+    }
+  if (m_fibConverged)
+    {
+      return;
+    }
+  m_fibConverged = true;
+  m_fibConvergenceTime = m_lastFibChange;
+  NS_LOG_INFO ("[" << Simulator::Now () << "] FIBs converged at " << m_fibConvergenceTime);
+  if (m_stopOnConvergence)
+    {
+      Simulator::Stop ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+#ifndef OSPF_CONVERGENCE_MONITOR_H
+#define OSPF_CONVERGENCE_MONITOR_H
+
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ospf-app.h"
+
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ * \brief Records when the LSDBs and routing tables of a set of OspfApps converge.
+ *
+ * The monitor listens to the LsdbChanged and FibChanged trace sources instead
+ * of polling. The LSDBs have converged when every area has a single distinct
+ * L1 LSDB digest among the monitored routers and all monitored routers share
+ * a single L2 LSDB digest. The FIBs have converged when, in addition, no
+ * monitored router has routing work or an LSA origination pending (see
+ * OspfApp::GetRoutingDelayLeft); the FIB convergence time is the time of the
+ * last routing table write.
+ *
+ * The monitor must outlive Simulator::Run ().
+ */
+class OspfConvergenceMonitor
+{
+public:
+  OspfConvergenceMonitor ();
+
+  /**
+   * \brief Monitor an OspfApp. Its router ID and area must already be set.
+   * \param app the application
+   */
+  void Install (Ptr<OspfApp> app);
+
+  /**
+   * \brief Monitor every OspfApp installed on the nodes.
+   * \param c the nodes
+   */
+  void Install (NodeContainer c);
+
+  /**
+   * \brief Call Simulator::Stop () as soon as the FIBs converge.
+   * \param stop whether to stop
+   */
+  void SetStopOnConvergence (bool stop);
+
+  /**
+   * \return true if every area has a single distinct L1 LSDB and there is a
+   * single distinct L2 LSDB
+   */
+  bool IsLsdbConverged () const;
+
+  /**
+   * \return the time the L1 LSDBs last became identical within every area
+   * and the L2 LSDBs across areas
+   */
+  Time GetLsdbConvergenceTime () const;
+
+  /**
+   * \return true if the LSDBs converged and no routing work is pending
+   */
+  bool IsFibConverged () const;
+
+  /**
+   * \return the time of the last routing table write before the FIBs converged
+   */
+  Time GetFibConvergenceTime () const;
+
+  /**
+   * \param area the area ID
+   * \return the number of distinct L1 LSDBs among the routers of the area
+   */
+  uint32_t GetNLsdbs (uint32_t area) const;
+
+  /**
+   * \return the number of distinct L2 LSDBs among all monitored routers
+   */
+  uint32_t GetNL2Lsdbs () const;
+
+private:
+  /// Routers per distinct LSDB digest
+  typedef std::unordered_map<uint64_t, uint32_t> Digests;
+
+  void LsdbChanged (Ipv4Address routerId, uint64_t digest);
+  void FibChanged (Ipv4Address routerId);
+  void AddDigest (Digests &digests, uint64_t digest);
+  void RemoveDigest (Digests &digests, uint64_t digest);
+  void ScheduleFibCheck (Time delay);
+  void CheckFib ();
+
+  struct Router
+  {
+    Ptr<OspfApp> app;
+    uint32_t area;
+    uint64_t l1Digest;
+    uint64_t l2Digest;
+  };
+
+  std::unordered_map<uint32_t, Router> m_routers; //!< Monitored routers by router ID
+  std::unordered_map<uint32_t, Digests> m_l1Digests; //!< L1 LSDB digests, per area
+  Digests m_l2Digests; //!< L2 LSDB digests of every router
+  uint32_t m_nSplit; //!< Digest sets with more than one distinct LSDB
+
+  Time m_lsdbConvergenceTime;
+  bool m_fibConverged;
+  Time m_lastFibChange;
+  Time m_fibConvergenceTime;
+  EventId m_fibCheck;
+  bool m_stopOnConvergence;
+};
+
+} // namespace ns3
+
+#endif /* OSPF_CONVERGENCE_MONITOR_H */
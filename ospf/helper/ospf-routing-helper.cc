@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/log.h"
+#include "ospf-routing-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OspfRoutingHelper");
+
+OspfRoutingHelper::OspfRoutingHelper ()
+{
+  m_factory.SetTypeId (OspfRoutingProtocol::GetTypeId ());
+}
+
+void
+OspfRoutingHelper::Set (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+OspfRoutingHelper *
+OspfRoutingHelper::Copy (void) const
+{
+  return new OspfRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+OspfRoutingHelper::Create (Ptr<Node> node) const
+{
+  return m_factory.Create<OspfRoutingProtocol> ();
+}
+
+Ptr<OspfRoutingProtocol>
+OspfRoutingHelper::Install (Ptr<Node> node, int16_t priority) const
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4 != nullptr, "OspfRoutingHelper: install an internet stack first");
+  Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+  NS_ASSERT_MSG (list != nullptr, "OspfRoutingHelper: the node needs Ipv4ListRouting");
+  Ptr<OspfRoutingProtocol> routing = GetOspfRouting (ipv4);
+  if (routing != nullptr)
+    {
+      NS_LOG_WARN ("Node " << node->GetId () << " already has an OspfRoutingProtocol");
+      return routing;
+    }
+  routing = DynamicCast<OspfRoutingProtocol> (Create (node));
+  list->AddRoutingProtocol (routing, priority);
+  return routing;
+}
+
+void
+OspfRoutingHelper::Install (NodeContainer c) const
+{
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Install (*i);
+    }
+}
+
+Ptr<OspfRoutingProtocol>
+OspfRoutingHelper::GetOspfRouting (Ptr<Ipv4> ipv4)
+{
+  Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+  if (list == nullptr)
+    {
+      return nullptr;
+    }
+  for (uint32_t i = 0; i < list->GetNRoutingProtocols (); i++)
+    {
+      int16_t priority;
+      Ptr<OspfRoutingProtocol> routing =
+          DynamicCast<OspfRoutingProtocol> (list->GetRoutingProtocol (i, priority));
+      if (routing != nullptr)
+        {
+          return routing;
+        }
+    }
+  return nullptr;
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+#ifndef OSPF_ROUTING_HELPER_H
+#define OSPF_ROUTING_HELPER_H
+
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/ospf-routing-protocol.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ * \brief Helper for adding an ns3::OspfRoutingProtocol that OSPF programs directly.
+ *
+ * Install it before OspfAppHelper::Install. The table is added to the
+ * node's Ipv4ListRouting in front of Ipv4StaticRouting, and OspfApp then
+ * installs its routes there only, leaving the static routing table with the
+ * connected routes.
+ */
+class OspfRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  OspfRoutingHelper ();
+
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of ns3::OspfRoutingProtocol
+   */
+  void Set (std::string name, const AttributeValue &value);
+
+  /**
+   * \returns pointer to clone of this OspfRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  OspfRoutingHelper *Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * Add an OspfRoutingProtocol to the Ipv4ListRouting of a node.
+   *
+   * \param node the node, with an internet stack using Ipv4ListRouting
+   * \param priority the priority in the list, above Ipv4StaticRouting's 0
+   * \returns the table added
+   */
+  Ptr<OspfRoutingProtocol> Install (Ptr<Node> node, int16_t priority = 10) const;
+
+  /**
+   * Add an OspfRoutingProtocol to the Ipv4ListRouting of each node.
+   *
+   * \param c the nodes
+   */
+  void Install (NodeContainer c) const;
+
+  /**
+   * Find the OspfRoutingProtocol of a node.
+   *
+   * \param ipv4 the Ptr<Ipv4> of the node
+   * \returns the table, or nullptr if none was installed
+   */
+  static Ptr<OspfRoutingProtocol> GetOspfRouting (Ptr<Ipv4> ipv4);
+
+private:
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+} // namespace ns3
+
+#endif /* OSPF_ROUTING_HELPER_H */
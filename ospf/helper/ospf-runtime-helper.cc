@@ -63,7 +63,7 @@ CompareLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetLsdbHash ();
+  uint64_t hash = app->GetLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -85,7 +85,7 @@ CompareL1SummaryLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetL1SummaryLsdbHash ();
+  uint64_t hash = app->GetL1SummaryLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -107,7 +107,7 @@ CompareAreaLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetAreaLsdbHash ();
+  uint64_t hash = app->GetAreaLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -129,7 +129,7 @@ CompareL2SummaryLsdb (NodeContainer nodes)
 {
   NS_ASSERT (nodes.GetN () > 0);
   Ptr<OspfApp> app = DynamicCast<OspfApp> (nodes.Get (0)->GetApplication (0));
-  uint32_t hash = app->GetL2SummaryLsdbHash ();
+  uint64_t hash = app->GetL2SummaryLsdbHash ();
 
   for (uint32_t i = 1; i < nodes.GetN (); i++)
     {
@@ -59,6 +59,7 @@ AreaLsa::AreaLsa (Ptr<Packet> packet)
 void
 AreaLsa::AddLink (AreaLink link)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_links.emplace_back (link);
 }
 
@@ -76,6 +77,7 @@ AreaLsa::GetLink (uint32_t index)
 void
 AreaLsa::ClearLinks ()
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_links.clear ();
 }
 
@@ -45,6 +45,7 @@ L1SummaryLsa::L1SummaryLsa (Ptr<Packet> packet)
 void
 L1SummaryLsa::AddRoute (SummaryRoute route)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_routes.insert (route);
 }
 
@@ -64,6 +65,7 @@ L1SummaryLsa::GetRoutes ()
 void
 L1SummaryLsa::ClearRoutes ()
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_routes.clear ();
 }
 
@@ -49,6 +49,7 @@ L2SummaryLsa::L2SummaryLsa (Ptr<Packet> packet)
 void
 L2SummaryLsa::AddRoute (SummaryRoute route)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_routes.insert (route);
 }
 
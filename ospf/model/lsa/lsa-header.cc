@@ -149,7 +149,7 @@ LsaHeader::GetAdvertisingRouter (void) const
 
 // Get the unique key <LS Type, Link-State ID, Advertising Router>
 LsaHeader::LsaKey
-LsaHeader::GetKey ()
+LsaHeader::GetKey () const
 {
   return std::make_tuple (m_type, m_lsId, m_advertisingRouter);
 }
@@ -102,7 +102,7 @@ public:
   void SetAdvertisingRouter (uint32_t advertisingRouter);
   uint32_t GetAdvertisingRouter (void) const;
 
-  LsaKey GetKey ();
+  LsaKey GetKey () const;
 
   static std::string GetKeyString (LsaKey);
 
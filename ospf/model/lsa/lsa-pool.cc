@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/buffer.h"
+#include "lsa-pool.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LsaPool");
+
+namespace {
+
+// Same as Lsa::PoolKey
+typedef std::tuple<uint8_t, uint32_t, uint32_t, uint16_t, uint32_t, uint64_t> PoolKey;
+
+struct PoolKeyHash
+{
+  size_t
+  operator() (const PoolKey &key) const
+  {
+    // The digest already mixes the body; fold in the rest of the key
+    uint64_t h = std::get<5> (key);
+    h ^= (uint64_t (std::get<0> (key)) << 56) ^ (uint64_t (std::get<1> (key)) << 24) ^
+         std::get<2> (key) ^ (uint64_t (std::get<3> (key)) << 40) ^ std::get<4> (key);
+    h *= 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 32);
+  }
+};
+
+typedef std::unordered_map<PoolKey, Lsa *, PoolKeyHash> Pool;
+
+Pool &
+GetPool ()
+{
+  // Never destroyed, so bodies released during static destruction still
+  // find it
+  static Pool *pool = new Pool ();
+  return *pool;
+}
+
+PoolKey
+MakeKey (const LsaHeader &header, uint32_t size, uint64_t digest)
+{
+  return std::make_tuple (header.GetType (), header.GetLsId (), header.GetAdvertisingRouter (),
+                          header.GetSeqNum (), size, digest);
+}
+
+} // namespace
+
+uint64_t
+LsaPool::Digest (const uint8_t *data, uint32_t size)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      h ^= data[i];
+      h *= 0x100000001b3ULL;
+    }
+  return h;
+}
+
+Ptr<Lsa>
+LsaPool::Find (const LsaHeader &header, uint32_t size, uint64_t digest)
+{
+  Pool &pool = GetPool ();
+  auto it = pool.find (MakeKey (header, size, digest));
+  if (it == pool.end ())
+    {
+      return nullptr;
+    }
+  return Ptr<Lsa> (it->second);
+}
+
+Ptr<Lsa>
+LsaPool::Intern (const LsaHeader &header, Ptr<Lsa> lsa, uint32_t size, uint64_t digest)
+{
+  if (lsa == nullptr || lsa->m_interned)
+    {
+      return lsa;
+    }
+  auto [it, inserted] = GetPool ().emplace (MakeKey (header, size, digest), PeekPointer (lsa));
+  if (!inserted)
+    {
+      NS_LOG_LOGIC ("Sharing the interned body of LSA " << uint32_t (header.GetType ()) << "/"
+                                                        << header.GetLsId () << " seq "
+                                                        << header.GetSeqNum ());
+      return Ptr<Lsa> (it->second);
+    }
+  lsa->m_interned = true;
+  lsa->m_poolKey = it->first;
+  return lsa;
+}
+
+Ptr<Lsa>
+LsaPool::Intern (const LsaHeader &header, Ptr<Lsa> lsa)
+{
+  if (lsa == nullptr || lsa->m_interned)
+    {
+      return lsa;
+    }
+  uint32_t size = lsa->GetSerializedSize ();
+  Buffer buffer;
+  buffer.AddAtStart (size);
+  lsa->Serialize (buffer.Begin ());
+  std::vector<uint8_t> data (size);
+  buffer.CopyData (data.data (), size);
+  return Intern (header, lsa, size, Digest (data.data (), size));
+}
+
+uint32_t
+LsaPool::GetNLsas (void)
+{
+  return GetPool ().size ();
+}
+
+void
+LsaPool::Release (Lsa *lsa)
+{
+  Pool &pool = GetPool ();
+  auto it = pool.find (lsa->m_poolKey);
+  NS_ASSERT (it != pool.end () && it->second == lsa);
+  pool.erase (it);
+}
+
+} // namespace ns3
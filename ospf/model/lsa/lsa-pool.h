@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef LSA_POOL_H
+#define LSA_POOL_H
+
+#include "lsa.h"
+#include "lsa-header.h"
+
+namespace ns3 {
+/**
+ * \ingroup ospf
+ *
+ * \brief Process-wide pool of immutable LSA bodies
+ *
+ * Every router holding the same LSA instance holds the same body. Bodies are
+ * keyed by LSA key, sequence number and a digest of their encoding; the LSA
+ * checksum is not computed, and a restarted router reuses sequence numbers.
+ * The pool does not own its bodies: one leaves the pool when the last router
+ * drops it. Only the simulation thread may use it.
+ */
+class LsaPool
+{
+public:
+  /**
+   * \brief Digest of an encoded LSA body
+   * \param data the body, without the LSA header
+   * \param size its length in bytes
+   * \return 64-bit FNV-1a digest
+   */
+  static uint64_t Digest (const uint8_t *data, uint32_t size);
+
+  /**
+   * \brief Find the interned body of an encoded LSA
+   * \param header the LSA header
+   * \param size body length in bytes
+   * \param digest body digest
+   * \return the body, or nullptr if no router holds it
+   */
+  static Ptr<Lsa> Find (const LsaHeader &header, uint32_t size, uint64_t digest);
+
+  /**
+   * \brief Intern a body whose encoding is already known
+   * \param header the LSA header
+   * \param lsa the body
+   * \param size body length in bytes
+   * \param digest body digest
+   * \return the interned body, which is lsa unless an equal one was interned
+   */
+  static Ptr<Lsa> Intern (const LsaHeader &header, Ptr<Lsa> lsa, uint32_t size,
+                          uint64_t digest);
+
+  /**
+   * \brief Intern a body, encoding it to compute the digest
+   * \param header the LSA header
+   * \param lsa the body
+   * \return the interned body, which is lsa unless an equal one was interned
+   */
+  static Ptr<Lsa> Intern (const LsaHeader &header, Ptr<Lsa> lsa);
+
+  template <typename T>
+  static Ptr<T>
+  Intern (const LsaHeader &header, Ptr<T> lsa)
+  {
+    return DynamicCast<T> (Intern (header, Ptr<Lsa> (lsa)));
+  }
+
+  /**
+   * \return the number of bodies in the pool
+   */
+  static uint32_t GetNLsas (void);
+
+private:
+  friend class Lsa;
+  static void Release (Lsa *lsa);
+};
+
+} // namespace ns3
+
+#endif /* LSA_POOL_H */
@@ -24,6 +24,7 @@
 #include "ns3/header.h"
 #include "ns3/packet.h"
 #include "lsa.h"
+#include "lsa-pool.h"
 
 namespace ns3 {
 
@@ -31,6 +32,14 @@ NS_LOG_COMPONENT_DEFINE ("Lsa");
 
 NS_OBJECT_ENSURE_REGISTERED (Lsa);
 
+Lsa::~Lsa ()
+{
+  if (m_interned)
+    {
+      LsaPool::Release (this);
+    }
+}
+
 uint32_t
 Lsa::GetSerializedSize (void) const
 {
@@ -76,4 +85,10 @@ Lsa::Copy ()
   return nullptr;
 }
 
+bool
+Lsa::IsInterned (void) const
+{
+  return m_interned;
+}
+
 } // namespace ns3
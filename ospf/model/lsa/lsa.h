@@ -26,6 +26,8 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/packet.h"
 
+#include <tuple>
+
 namespace ns3 {
 /**
  * \ingroup ospf
@@ -36,6 +38,7 @@ namespace ns3 {
 class Lsa : public Object
 {
 public:
+  virtual ~Lsa ();
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
   virtual uint32_t GetSerializedSize (void) const;
@@ -43,6 +46,23 @@ public:
   virtual uint32_t Deserialize (Buffer::Iterator start);
   virtual uint32_t Deserialize (Ptr<Packet> packet);
   virtual Ptr<Lsa> Copy ();
+
+  /**
+   * \brief Whether the body is shared through LsaPool
+   *
+   * An interned body may be held by any number of routers and must not
+   * change; Copy () gives a private, mutable one.
+   * \return true if interned
+   */
+  bool IsInterned (void) const;
+
+private:
+  friend class LsaPool;
+  // <type, Link-State ID, advertising router, seq, body size, body digest>
+  typedef std::tuple<uint8_t, uint32_t, uint32_t, uint16_t, uint32_t, uint64_t> PoolKey;
+
+  bool m_interned = false;
+  PoolKey m_poolKey;
 };
 
 } // namespace ns3
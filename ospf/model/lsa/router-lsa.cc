@@ -58,6 +58,7 @@ RouterLsa::RouterLsa (bool bitV, bool bitE, bool bitB) : m_bitV (bitV), m_bitE (
 void
 RouterLsa::SetBitV (bool bitV)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_bitV = bitV;
 }
 
@@ -70,6 +71,7 @@ RouterLsa::GetBitV (void) const
 void
 RouterLsa::SetBitE (bool bitE)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_bitE = bitE;
 }
 
@@ -82,6 +84,7 @@ RouterLsa::GetBitE (void) const
 void
 RouterLsa::SetBitB (bool bitB)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_bitB = bitB;
 }
 
@@ -94,6 +97,7 @@ RouterLsa::GetBitB (void) const
 void
 RouterLsa::AddLink (RouterLink link)
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_links.emplace_back (link);
 }
 
@@ -111,6 +115,7 @@ RouterLsa::GetLink (uint32_t index)
 void
 RouterLsa::ClearLinks ()
 {
+  NS_ASSERT_MSG (!IsInterned (), "Interned LSA bodies are shared; modify a Copy ()");
   m_links.clear ();
 }
 
@@ -23,6 +23,10 @@ OspfAreaLeaderController::ScheduleInitialLeadershipAttempt ()
 void
 OspfAreaLeaderController::UpdateLeadershipEligibility ()
 {
+  if (m_app.m_routerLsdb.empty ())
+    {
+      return;
+    }
   // Start leadership begin timer if it's a leader (lowest router ID)
   if (m_app.m_routerLsdb.begin ()->first == m_app.m_routerId.Get ())
     {
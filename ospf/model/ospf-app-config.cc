@@ -1,6 +1,8 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "ospf-app-private.h"
+#include "ospf-app-lsa-aging.h"
+#include "ospf-app-routing-engine.h"
 
 #include "ns3/channel.h"
 #include "ns3/ipv4.h"
@@ -13,6 +15,23 @@ OspfApp::SetRouting (Ptr<Ipv4StaticRouting> routing)
   m_routing = routing;
 }
 
+Ptr<OspfRoutingProtocol>
+OspfApp::GetMultipathRouting () const
+{
+  return m_multipathRouting;
+}
+
+void
+OspfApp::SetOspfRouting (Ptr<OspfRoutingProtocol> routing)
+{
+  m_multipathRouting = routing;
+  m_ospfRoutingOnly = routing != nullptr;
+  if (routing != nullptr)
+    {
+      routing->SetHashSeed (m_routerId.Get ());
+    }
+}
+
 void
 OspfApp::SetBoundNetDevices (NetDeviceContainer devs)
 {
@@ -258,6 +277,10 @@ OspfApp::SyncInterfacesFromIpv4 ()
         }
     }
 
+  if (changed)
+    {
+      m_routingEngine->ResetAdjacencies ();
+    }
   return changed;
 }
 
@@ -363,6 +386,58 @@ OspfApp::SetAreaLeader (bool isLeader)
   m_isAreaLeader = isLeader;
 }
 
+void
+OspfApp::AddAreaRange (Ipv4Address network, Ipv4Mask mask, bool advertise)
+{
+  m_areaRanges[std::make_pair (network.CombineMask (mask).Get (), mask.Get ())] = advertise;
+  if (m_enableAreaProxy && m_isAreaLeader)
+    {
+      ThrottledRecomputeL2SummaryLsa ();
+    }
+}
+
+void
+OspfApp::RemoveAreaRange (Ipv4Address network, Ipv4Mask mask)
+{
+  if (m_areaRanges.erase (std::make_pair (network.CombineMask (mask).Get (), mask.Get ())) > 0 &&
+      m_enableAreaProxy && m_isAreaLeader)
+    {
+      ThrottledRecomputeL2SummaryLsa ();
+    }
+}
+
+void
+OspfApp::ClearAreaRanges ()
+{
+  if (m_areaRanges.empty ())
+    {
+      return;
+    }
+  m_areaRanges.clear ();
+  if (m_enableAreaProxy && m_isAreaLeader)
+    {
+      ThrottledRecomputeL2SummaryLsa ();
+    }
+}
+
+void
+OspfApp::SetPrefixPriority (Ipv4Address network, Ipv4Mask mask, uint32_t priority)
+{
+  m_prefixPriorities[std::make_pair (network.CombineMask (mask).Get (), mask.Get ())] = priority;
+}
+
+void
+OspfApp::RemovePrefixPriority (Ipv4Address network, Ipv4Mask mask)
+{
+  m_prefixPriorities.erase (std::make_pair (network.CombineMask (mask).Get (), mask.Get ()));
+}
+
+void
+OspfApp::ClearPrefixPriorities ()
+{
+  m_prefixPriorities.clear ();
+}
+
 void
 OspfApp::SetDoInitialize (bool doInitialize)
 {
@@ -416,25 +491,29 @@ OspfApp::GetRouterId ()
 std::map<uint32_t, std::pair<LsaHeader, Ptr<RouterLsa>>>
 OspfApp::GetLsdb ()
 {
-  return m_routerLsdb;
+  return std::map<uint32_t, std::pair<LsaHeader, Ptr<RouterLsa>>> (m_routerLsdb.begin (),
+                                                                     m_routerLsdb.end ());
 }
 
 std::map<uint32_t, std::pair<LsaHeader, Ptr<L1SummaryLsa>>>
 OspfApp::GetL1SummaryLsdb ()
 {
-  return m_l1SummaryLsdb;
+  return std::map<uint32_t, std::pair<LsaHeader, Ptr<L1SummaryLsa>>> (m_l1SummaryLsdb.begin (),
+                                                                        m_l1SummaryLsdb.end ());
 }
 
 std::map<uint32_t, std::pair<LsaHeader, Ptr<AreaLsa>>>
 OspfApp::GetAreaLsdb ()
 {
-  return m_areaLsdb;
+  return std::map<uint32_t, std::pair<LsaHeader, Ptr<AreaLsa>>> (m_areaLsdb.begin (),
+                                                                   m_areaLsdb.end ());
 }
 
 std::map<uint32_t, std::pair<LsaHeader, Ptr<L2SummaryLsa>>>
 OspfApp::GetL2SummaryLsdb ()
 {
-  return m_l2SummaryLsdb;
+  return std::map<uint32_t, std::pair<LsaHeader, Ptr<L2SummaryLsa>>> (m_l2SummaryLsdb.begin (),
+                                                                        m_l2SummaryLsdb.end ());
 }
 
 void
@@ -532,6 +611,10 @@ OspfApp::PrintRouting (std::filesystem::path dirName, std::string filename)
       Ptr<OutputStreamWrapper> routingStream =
           Create<OutputStreamWrapper> (dirName / filename, std::ios::out);
       m_routing->PrintRoutingTable (routingStream);
+      if (m_ospfRoutingOnly)
+        {
+          m_multipathRouting->PrintRoutingTable (routingStream);
+        }
     }
   catch (const std::filesystem::filesystem_error &e)
     {
@@ -550,75 +633,70 @@ OspfApp::PrintAreas ()
   std::cout << std::endl;
 }
 
-uint32_t
+uint64_t
 OspfApp::GetLsdbHash ()
 {
-  std::stringstream ss;
-  for (auto &pair : m_routerLsdb)
-    {
-      ss << Ipv4Address (pair.first) << std::endl;
-      for (uint32_t i = 0; i < pair.second.second->GetNLink (); i++)
-        {
-          RouterLink link = pair.second.second->GetLink (i);
-          ss << "  (" << Ipv4Address (link.m_linkData) << Ipv4Address (link.m_metric) << ")"
-             << std::endl;
-        }
-    }
-  std::hash<std::string> hasher;
-  return hasher (ss.str ());
+  return m_lsdb.GetDigest<RouterLsa> ();
 }
 
-uint32_t
+uint64_t
 OspfApp::GetL1SummaryLsdbHash ()
 {
-  std::stringstream ss;
-  for (auto &pair : m_l1SummaryLsdb)
-    {
-      ss << Ipv4Address (pair.first) << std::endl;
-      Ptr<L1SummaryLsa> lsa = pair.second.second;
-      for (auto route : lsa->GetRoutes ())
-        {
-          ss << "    (" << Ipv4Address (route.m_address) << ", " << Ipv4Mask (route.m_mask) << ", "
-             << route.m_metric << ")" << std::endl;
-        }
-    }
-  std::hash<std::string> hasher;
-  return hasher (ss.str ());
+  return m_lsdb.GetDigest<L1SummaryLsa> ();
 }
 
-uint32_t
+uint64_t
 OspfApp::GetAreaLsdbHash ()
 {
-  std::stringstream ss;
-  for (auto &pair : m_areaLsdb)
-    {
-      ss << Ipv4Address (pair.first) << std::endl;
-      for (uint32_t i = 0; i < pair.second.second->GetNLink (); i++)
-        {
-          AreaLink link = pair.second.second->GetLink (i);
-          ss << "  (" << link.m_areaId << link.m_ipAddress << link.m_metric << ")" << std::endl;
-        }
-    }
-  std::hash<std::string> hasher;
-  return hasher (ss.str ());
+  return m_lsdb.GetDigest<AreaLsa> ();
 }
 
-uint32_t
+uint64_t
 OspfApp::GetL2SummaryLsdbHash ()
 {
-  std::stringstream ss;
-  for (auto &pair : m_l2SummaryLsdb)
+  return m_lsdb.GetDigest<L2SummaryLsa> ();
+}
+
+uint64_t
+OspfApp::GetLsdbDigest ()
+{
+  return m_lsdb.GetDigest ();
+}
+
+uint64_t
+OspfApp::GetL1LsdbDigest ()
+{
+  return m_lsdb.GetL1Digest ();
+}
+
+uint64_t
+OspfApp::GetL2LsdbDigest ()
+{
+  return m_lsdb.GetL2Digest ();
+}
+
+uint32_t
+OspfApp::GetNAgingTimers () const
+{
+  return m_aging->GetNTimers ();
+}
+
+uint32_t
+OspfApp::GetNLsdbKeys () const
+{
+  return m_lsdb.GetNKeys ();
+}
+
+void
+OspfApp::NotifyLsdbChanged ()
+{
+  uint64_t digest = m_lsdb.GetDigest ();
+  if (digest == m_notifiedLsdbDigest)
     {
-      ss << Ipv4Address (pair.first) << std::endl;
-      Ptr<L2SummaryLsa> lsa = pair.second.second;
-      for (auto route : lsa->GetRoutes ())
-        {
-          ss << "    (" << Ipv4Address (route.m_address) << ", " << Ipv4Mask (route.m_mask) << ", "
-             << route.m_metric << ")" << std::endl;
-        }
+      return;
     }
-  std::hash<std::string> hasher;
-  return hasher (ss.str ());
+  m_notifiedLsdbDigest = digest;
+  m_lsdbChangedTrace (m_routerId, digest);
 }
 
 void
@@ -644,14 +722,16 @@ OspfApp::AddNeighbor (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor)
 
   Ptr<OspfInterface> ospfInterface = m_ospfInterfaces[ifIndex];
   ospfInterface->AddNeighbor (neighbor);
+  m_routingEngine->NotifyNeighborState (ifIndex, neighbor);
 }
 
 void
 OspfApp::InjectLsa (std::vector<std::pair<LsaHeader, Ptr<Lsa>>> lsaList)
 {
+  // The same list is injected into every router; share one body per LSA
   for (auto &[header, lsa] : lsaList)
     {
-      ProcessLsa (header.Copy (), lsa->Copy ());
+      ProcessLsa (header, LsaPool::Intern (header, lsa));
     }
 }
 
@@ -3,7 +3,9 @@
 #include "ospf-app-private.h"
 #include "ospf-app-area-leader-controller.h"
 #include "ospf-app-logging.h"
+#include "ospf-app-lsa-aging.h"
 #include "ospf-app-rng.h"
+#include "ospf-app-routing-engine.h"
 #include "ospf-app-sockets.h"
 
 #include "ns3/ipv4.h"
@@ -14,6 +16,11 @@ void
 OspfApp::DoDispose (void)
 {
   // NS_LOG_FUNCTION (this);
+  // Also drops a batched SPF run still waiting for its flush
+  m_routingEngine->ResetSpfState ();
+  // The OSPF table may outlive us
+  m_routingEngine->DetachLazyFib ();
+  m_aging->Clear ();
   Application::DoDispose ();
 }
 
@@ -77,9 +84,26 @@ OspfApp::Enable ()
   m_enabled = true;
   if (m_protocolRunning)
     {
+      // Calls off a drain in progress
+      if (m_draining)
+        {
+          m_drainEvent.Remove ();
+          m_drainCheckEvent.Remove ();
+          m_draining = false;
+          EndStubRouter ();
+        }
       return;
     }
   m_protocolRunning = true;
+  m_aging->Resume ();
+
+  // No transit traffic until its own routes are in (RFC 6987)
+  if (m_stubRouterPeriod.IsStrictlyPositive ())
+    {
+      m_stubRouter = true;
+      m_stubRouterEvent =
+          Simulator::Schedule (m_stubRouterPeriod, &OspfApp::EndStubRouter, this);
+    }
 
   StartInterfaceSyncIfEnabled ();
   InitializeSockets ();
@@ -113,7 +137,14 @@ OspfApp::Disable ()
     {
       return;
     }
+  // Withdraw our LSAs while the sockets are still open
+  m_aging->FlushSelfOriginated ();
   m_protocolRunning = false;
+  m_drainEvent.Remove ();
+  m_drainCheckEvent.Remove ();
+  m_draining = false;
+  m_stubRouterEvent.Remove ();
+  m_stubRouter = false;
 
   StopInterfaceSync ();
   m_helloEvent.Remove ();
@@ -132,6 +163,161 @@ OspfApp::IsEnabled () const
   return m_protocolRunning;
 }
 
+void
+OspfApp::Drain ()
+{
+  if (!m_protocolRunning)
+    {
+      Disable ();
+      return;
+    }
+  if (m_draining)
+    {
+      return;
+    }
+  // Traffic moves around the router before it goes
+  m_draining = true;
+  m_stubRouterEvent.Remove ();
+  if (!m_stubRouter)
+    {
+      m_stubRouter = true;
+      ReoriginateRouterLsa ();
+    }
+  m_drainStart = Simulator::Now ();
+  m_drainRerouted = false;
+  // DrainTime is only the upper bound
+  m_drainEvent = Simulator::Schedule (m_drainTime, &OspfApp::Disable, this);
+  CheckDrain ();
+}
+
+void
+OspfApp::CheckDrain ()
+{
+  m_drainCheckEvent.Remove ();
+  if (!m_draining || m_drainRerouted)
+    {
+      return;
+    }
+  // Wait out SPF runs, FIB write batches and deferred originations first
+  Time left = Simulator::GetDelayLeft (m_drainEvent);
+  Time pending = GetRoutingDelayLeft ();
+  if (pending < left)
+    {
+      m_drainCheckEvent = Simulator::Schedule (pending, &OspfApp::CheckDrain, this);
+      return;
+    }
+  // HandleLsAck checks again on every ack
+  if (!IsRouterLsaAcked ())
+    {
+      return;
+    }
+  // Every neighbor has had the LSA since no later than now. Give them as
+  // long again as this router took to get here before disabling it.
+  m_drainRerouted = true;
+  Time hold = Simulator::Now () - m_drainStart;
+  if (hold < left)
+    {
+      m_drainEvent.Remove ();
+      m_drainEvent = Simulator::Schedule (hold, &OspfApp::Disable, this);
+    }
+}
+
+bool
+OspfApp::IsRouterLsaAcked () const
+{
+  auto lsaKey =
+      std::make_tuple (LsaHeader::LsType::RouterLSAs, m_routerId.Get (), m_routerId.Get ());
+  for (uint32_t i = 1; i < m_ospfInterfaces.size (); i++)
+    {
+      if (m_ospfInterfaces[i] == nullptr)
+        {
+          continue;
+        }
+      for (auto &neighbor : m_ospfInterfaces[i]->GetNeighbors ())
+        {
+          if (neighbor->GetState () == OspfNeighbor::Full && neighbor->HasKeyedTimeout (lsaKey))
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+bool
+OspfApp::IsDraining () const
+{
+  return m_draining;
+}
+
+bool
+OspfApp::IsStubRouter () const
+{
+  return m_stubRouter;
+}
+
+void
+OspfApp::EndStubRouter ()
+{
+  m_stubRouterEvent.Remove ();
+  if (!m_stubRouter || m_draining)
+    {
+      return;
+    }
+  m_stubRouter = false;
+  ReoriginateRouterLsa ();
+}
+
+void
+OspfApp::NotifyL1RoutesInstalled ()
+{
+  if (m_stubRouter && !m_draining && m_stubRouterUntilSync && IsLsdbSynchronized ())
+    {
+      // Not from within the SPF run that installed them
+      Simulator::ScheduleNow (&OspfApp::EndStubRouter, this);
+    }
+}
+
+bool
+OspfApp::IsLsdbSynchronized () const
+{
+  // Some adjacency is FULL and none is still exchanging databases
+  bool full = false;
+  for (uint32_t i = 1; i < m_ospfInterfaces.size (); i++)
+    {
+      if (m_ospfInterfaces[i] == nullptr)
+        {
+          continue;
+        }
+      for (auto &neighbor : m_ospfInterfaces[i]->GetNeighbors ())
+        {
+          OspfNeighbor::NeighborState state = neighbor->GetState ();
+          if (state == OspfNeighbor::Full)
+            {
+              full = true;
+            }
+          else if (state >= OspfNeighbor::ExStart)
+            {
+              return false;
+            }
+        }
+    }
+  return full;
+}
+
+void
+OspfApp::ReoriginateRouterLsa ()
+{
+  if (!m_protocolRunning || m_routerLsdb.find (m_routerId.Get ()) == m_routerLsdb.end ())
+    {
+      // The first Router-LSA is built when an adjacency comes up
+      return;
+    }
+  ThrottledRecomputeRouterLsa ();
+  // Cross-area links may have changed their metrics too
+  ProcessLsa (m_routerLsdb[m_routerId.Get ()]);
+}
+
 void
 OspfApp::FlushOspfRoutes ()
 {
@@ -143,6 +329,10 @@ OspfApp::FlushOspfRoutes ()
     {
       m_routing->RemoveRoute (m_boundDevices.GetN ());
     }
+  if (m_multipathRouting != nullptr)
+    {
+      m_multipathRouting->Clear ();
+    }
 }
 
 void
@@ -177,30 +367,22 @@ OspfApp::ResetStateForRestart ()
   FlushOspfRoutes ();
 
   m_isAreaLeader = false;
-  m_seqNumbers.clear ();
 
-  m_routerLsdb.clear ();
-  m_l1SummaryLsdb.clear ();
+  // Also cancels pending LSA regeneration events and clears throttling state
+  m_lsdb.Clear ();
+  m_aging->Clear ();
+  NotifyLsdbChanged ();
   m_nextHopToShortestBorderRouter.clear ();
   m_advertisingPrefixes.clear ();
   m_l1NextHop.clear ();
+  m_l1BackupNextHop.clear ();
   m_l1Addresses.clear ();
+  m_routingEngine->ResetSpfState ();
+  m_routingEngine->ResetPrefixIndex ();
+  m_routingEngine->ResetAdjacencies ();
 
-  m_areaLsdb.clear ();
-  m_l2SummaryLsdb.clear ();
   m_l2NextHop.clear ();
 
-  // Cancel pending LSA regeneration events and clear throttling state
-  for (auto &pair : m_pendingLsaRegeneration)
-    {
-      if (pair.second.IsRunning ())
-        {
-          Simulator::Cancel (pair.second);
-        }
-    }
-  m_pendingLsaRegeneration.clear ();
-  m_lastLsaOriginationTime.clear ();
-
   m_doInitialize = true;
 }
 
@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ospf-app-lsa-aging.h"
+
+#include "ospf-app-private.h"
+
+namespace ns3 {
+
+namespace {
+
+// LS ages are in seconds; a wheel revolution covers a few minutes
+constexpr uint32_t WHEEL_SLOTS = 256;
+
+LsaHeader::LsaKey
+GetLsaKey (OspfLsdb::Key key)
+{
+  return std::make_tuple (OspfLsdb::GetType (key), OspfLsdb::GetLsId (key), 0u);
+}
+
+} // namespace
+
+OspfLsaAging::OspfLsaAging (OspfApp &app)
+  : m_app (app),
+    m_wheel (Seconds (1), WHEEL_SLOTS)
+{
+  m_wheel.SetExpireCallback (MakeCallback (&OspfLsaAging::Expire, this));
+}
+
+void
+OspfLsaAging::Track (const LsaHeader &header)
+{
+  OspfLsdb::Key key = OspfLsdb::PackKey (header.GetType (), header.GetLsId ());
+  auto installed = m_app.m_lsdb.Fetch (header.GetKey ());
+  if (installed.second == nullptr)
+    {
+      m_born.erase (key);
+      m_wheel.Cancel (key);
+      return;
+    }
+  // Another instance won
+  if (installed.first.GetAdvertisingRouter () != header.GetAdvertisingRouter () ||
+      installed.first.GetSeqNum () != header.GetSeqNum ())
+    {
+      return;
+    }
+  Time born = Simulator::Now () - Seconds (std::min (header.GetLsAge (), GetMaxAge ()));
+  m_born[key] = born;
+  Schedule (key, installed.first, born);
+}
+
+void
+OspfLsaAging::TrackAll ()
+{
+  std::vector<LsaHeader> headers;
+  for (auto &[lsId, lsa] : m_app.m_routerLsdb)
+    {
+      headers.push_back (lsa.first);
+    }
+  for (auto &[lsId, lsa] : m_app.m_l1SummaryLsdb)
+    {
+      headers.push_back (lsa.first);
+    }
+  for (auto &[lsId, lsa] : m_app.m_areaLsdb)
+    {
+      headers.push_back (lsa.first);
+    }
+  for (auto &[lsId, lsa] : m_app.m_l2SummaryLsdb)
+    {
+      headers.push_back (lsa.first);
+    }
+  for (const LsaHeader &header : headers)
+    {
+      if (m_born.find (OspfLsdb::PackKey (header.GetType (), header.GetLsId ())) == m_born.end ())
+        {
+          Track (header);
+        }
+    }
+}
+
+void
+OspfLsaAging::Resume ()
+{
+  for (auto &[key, born] : m_born)
+    {
+      auto installed = m_app.m_lsdb.Fetch (GetLsaKey (key));
+      if (installed.second != nullptr)
+        {
+          Schedule (key, installed.first, born);
+        }
+    }
+}
+
+void
+OspfLsaAging::Clear ()
+{
+  m_wheel.Clear ();
+  m_born.clear ();
+}
+
+uint16_t
+OspfLsaAging::GetMaxAge () const
+{
+  return static_cast<uint16_t> (std::min (m_app.m_maxAge.GetSeconds (), 65535.0));
+}
+
+bool
+OspfLsaAging::IsMaxAge (const LsaHeader &header) const
+{
+  return header.GetLsAge () >= GetMaxAge ();
+}
+
+LsaHeader
+OspfLsaAging::GetAged (const LsaHeader &header) const
+{
+  auto it = m_born.find (OspfLsdb::PackKey (header.GetType (), header.GetLsId ()));
+  if (it == m_born.end ())
+    {
+      return header;
+    }
+  LsaHeader aged = header;
+  double age = (Simulator::Now () - it->second).GetSeconds ();
+  aged.SetLsAge (static_cast<uint16_t> (std::min (age, static_cast<double> (GetMaxAge ()))));
+  return aged;
+}
+
+void
+OspfLsaAging::FlushSelfOriginated ()
+{
+  std::vector<std::pair<LsaHeader, Ptr<Lsa>>> own;
+  for (auto &[lsId, lsa] : m_app.m_routerLsdb)
+    {
+      own.emplace_back (lsa.first, lsa.second);
+    }
+  for (auto &[lsId, lsa] : m_app.m_l1SummaryLsdb)
+    {
+      own.emplace_back (lsa.first, lsa.second);
+    }
+  for (auto &[lsId, lsa] : m_app.m_areaLsdb)
+    {
+      own.emplace_back (lsa.first, lsa.second);
+    }
+  for (auto &[lsId, lsa] : m_app.m_l2SummaryLsdb)
+    {
+      own.emplace_back (lsa.first, lsa.second);
+    }
+  for (auto &[header, lsa] : own)
+    {
+      if (header.GetAdvertisingRouter () != m_app.m_routerId.Get ())
+        {
+          continue;
+        }
+      LsaHeader flushed = header;
+      flushed.SetLsAge (GetMaxAge ());
+      NS_LOG_INFO ("Flushing " << LsaHeader::GetKeyString (flushed.GetKey ()));
+      Flood (flushed, lsa);
+    }
+}
+
+void
+OspfLsaAging::HandleSelfOriginated (const LsaHeader &header, Ptr<Lsa> lsa)
+{
+  LsaHeader::LsaKey lsaKey = header.GetKey ();
+  if (IsMaxAge (header) || header.GetSeqNum () <= m_app.m_lsdb.GetSeqNum (lsaKey))
+    {
+      return;
+    }
+  // Left over from before a restart
+  m_app.m_lsdb.SetSeqNum (lsaKey, header.GetSeqNum ());
+  auto installed = m_app.m_lsdb.Fetch (lsaKey);
+  if (installed.second != nullptr &&
+      installed.first.GetAdvertisingRouter () == header.GetAdvertisingRouter ())
+    {
+      NS_LOG_INFO ("Re-originating past " << LsaHeader::GetKeyString (header.GetSeqNum (), lsaKey));
+      Refresh (installed.first, installed.second);
+    }
+  else
+    {
+      NS_LOG_INFO ("Flushing " << LsaHeader::GetKeyString (header.GetSeqNum (), lsaKey));
+      LsaHeader flushed = header;
+      flushed.SetLsAge (GetMaxAge ());
+      Flood (flushed, lsa);
+    }
+}
+
+void
+OspfLsaAging::Remove (const LsaHeader &header)
+{
+  OspfLsdb::Key key = OspfLsdb::PackKey (header.GetType (), header.GetLsId ());
+  m_born.erase (key);
+  m_wheel.Cancel (key);
+
+  auto installed = m_app.m_lsdb.Fetch (header.GetKey ());
+  if (installed.second == nullptr ||
+      installed.first.GetAdvertisingRouter () != header.GetAdvertisingRouter ())
+    {
+      ForgetSeqNum (header);
+      return;
+    }
+  uint32_t lsId = header.GetLsId ();
+  bool leader = m_app.m_enableAreaProxy && m_app.m_isAreaLeader;
+  switch (header.GetType ())
+    {
+    case LsaHeader::RouterLSAs:
+      m_app.m_routerLsdb.erase (lsId);
+      if (leader)
+        {
+          m_app.ThrottledRecomputeAreaLsa ();
+        }
+      m_app.ScheduleUpdateL1ShortestPath ();
+      break;
+    case LsaHeader::L1SummaryLSAs:
+      m_app.m_l1SummaryLsdb.erase (lsId);
+      if (leader)
+        {
+          m_app.ThrottledRecomputeL2SummaryLsa ();
+        }
+      m_app.UpdateL1SummaryRoutes (lsId);
+      break;
+    case LsaHeader::AreaLSAs:
+      m_app.m_areaLsdb.erase (lsId);
+      m_app.ScheduleUpdateL2ShortestPath ();
+      break;
+    case LsaHeader::L2SummaryLSAs:
+      m_app.m_l2SummaryLsdb.erase (lsId);
+      m_app.UpdateL2SummaryRoutes (lsId);
+      break;
+    default:
+      break;
+    }
+  ForgetSeqNum (header);
+  m_app.NotifyLsdbChanged ();
+}
+
+void
+OspfLsaAging::ForgetSeqNum (const LsaHeader &header)
+{
+  // Ours continue from where they were; the others leave no state behind,
+  // so the LSDB does not grow with every router that ever left
+  if (header.GetAdvertisingRouter () != m_app.m_routerId.Get ())
+    {
+      m_app.m_lsdb.EraseSeqNum (header.GetKey ());
+    }
+}
+
+uint32_t
+OspfLsaAging::GetNTimers () const
+{
+  return m_wheel.GetN ();
+}
+
+void
+OspfLsaAging::Expire (OspfLsdb::Key key)
+{
+  // Aging stops with the protocol; Resume () picks it up again
+  if (!m_app.m_protocolRunning)
+    {
+      return;
+    }
+  auto born = m_born.find (key);
+  if (born == m_born.end ())
+    {
+      return;
+    }
+  auto installed = m_app.m_lsdb.Fetch (GetLsaKey (key));
+  if (installed.second == nullptr)
+    {
+      m_born.erase (born);
+      return;
+    }
+
+  LsaHeader header = installed.first;
+  Time age = Simulator::Now () - born->second;
+  if (header.GetAdvertisingRouter () == m_app.m_routerId.Get () && age >= GetLifetime (header))
+    {
+      Refresh (header, installed.second);
+    }
+  else if (age >= m_app.m_maxAge)
+    {
+      NS_LOG_INFO ("MaxAge reached by " << LsaHeader::GetKeyString (header.GetKey ()));
+      header.SetLsAge (GetMaxAge ());
+      Flood (header, installed.second);
+      Remove (header);
+    }
+  else
+    {
+      Schedule (key, header, born->second);
+    }
+}
+
+void
+OspfLsaAging::Refresh (LsaHeader header, Ptr<Lsa> lsa)
+{
+  LsaHeader::LsaKey lsaKey = header.GetKey ();
+  if (!m_app.m_minLsInterval.IsZero ())
+    {
+      OspfLsdb::Origination &origination = m_app.m_lsdb.GetOrigination (lsaKey);
+      origination.originated = true;
+      origination.last = Simulator::Now ();
+    }
+
+  // Same body, next sequence number
+  uint16_t seqNum = m_app.m_lsdb.GetSeqNum (lsaKey) + 1;
+  m_app.m_lsdb.SetSeqNum (lsaKey, seqNum);
+  header.SetSeqNum (seqNum);
+  header.SetLsAge (0);
+  Install (header, lsa);
+  Track (header);
+  Flood (header, lsa);
+}
+
+void
+OspfLsaAging::Flood (const LsaHeader &header, Ptr<Lsa> lsa)
+{
+  Ptr<LsUpdate> lsUpdate = Create<LsUpdate> ();
+  lsUpdate->AddLsa (header, lsa);
+  m_app.FloodLsu (0, lsUpdate);
+}
+
+void
+OspfLsaAging::Install (const LsaHeader &header, Ptr<Lsa> lsa)
+{
+  uint32_t lsId = header.GetLsId ();
+  switch (header.GetType ())
+    {
+    case LsaHeader::RouterLSAs:
+      m_app.m_routerLsdb[lsId] = std::make_pair (header, DynamicCast<RouterLsa> (lsa));
+      break;
+    case LsaHeader::L1SummaryLSAs:
+      m_app.m_l1SummaryLsdb[lsId] = std::make_pair (header, DynamicCast<L1SummaryLsa> (lsa));
+      break;
+    case LsaHeader::AreaLSAs:
+      m_app.m_areaLsdb[lsId] = std::make_pair (header, DynamicCast<AreaLsa> (lsa));
+      break;
+    case LsaHeader::L2SummaryLSAs:
+      m_app.m_l2SummaryLsdb[lsId] = std::make_pair (header, DynamicCast<L2SummaryLsa> (lsa));
+      break;
+    default:
+      break;
+    }
+}
+
+Time
+OspfLsaAging::GetLifetime (const LsaHeader &header) const
+{
+  // Our own LSAs are refreshed before they can reach MaxAge
+  if (header.GetAdvertisingRouter () == m_app.m_routerId.Get ())
+    {
+      return std::min (m_app.m_lsRefreshTime, m_app.m_maxAge);
+    }
+  return m_app.m_maxAge;
+}
+
+void
+OspfLsaAging::Schedule (OspfLsdb::Key key, const LsaHeader &header, Time born)
+{
+  m_wheel.Schedule (key, born + GetLifetime (header) - Simulator::Now ());
+}
+
+} // namespace ns3
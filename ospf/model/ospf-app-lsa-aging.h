@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef OSPF_APP_LSA_AGING_H
+#define OSPF_APP_LSA_AGING_H
+
+#include "ns3/lsa-header.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ospf-lsdb.h"
+#include "ospf-timer-wheel.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3 {
+
+class Lsa;
+class OspfApp;
+
+// RFC 2328 LSA aging. Every installed LSA has one timer on the node's
+// timer wheel: our own LSAs are re-originated at LSRefreshTime, the others
+// are flushed at MaxAge. Ages are kept as the time the LSA was at age 0.
+class OspfLsaAging
+{
+public:
+  explicit OspfLsaAging (OspfApp &app);
+
+  // Start aging the installed instance of the header's LSA at the header's LS age
+  void Track (const LsaHeader &header);
+  // Track the installed LSAs that are not tracked yet, after a state import
+  void TrackAll ();
+  // Re-arm the timers after the protocol was stopped
+  void Resume ();
+  // Forget every LSA and cancel the timers
+  void Clear ();
+
+  uint16_t GetMaxAge () const;
+  bool IsMaxAge (const LsaHeader &header) const;
+  // Copy of the header carrying the LSA's current age
+  LsaHeader GetAged (const LsaHeader &header) const;
+
+  // Premature aging: flood our own LSAs at MaxAge, keeping the local copies
+  void FlushSelfOriginated ();
+  // A newer instance of one of our LSAs is around; take over its
+  // sequence number and re-originate, or flush it if we no longer have it
+  void HandleSelfOriginated (const LsaHeader &header, Ptr<Lsa> lsa);
+  // Remove the installed instance of a MaxAge LSA and erase its sequence
+  // number, so the next instance is accepted whatever its sequence number
+  void Remove (const LsaHeader &header);
+
+  uint32_t GetNTimers () const;
+
+private:
+  void Expire (OspfLsdb::Key key);
+  void ForgetSeqNum (const LsaHeader &header);
+  void Refresh (LsaHeader header, Ptr<Lsa> lsa);
+  void Flood (const LsaHeader &header, Ptr<Lsa> lsa);
+  void Install (const LsaHeader &header, Ptr<Lsa> lsa);
+  // Age at which the LSA is refreshed (ours) or flushed
+  Time GetLifetime (const LsaHeader &header) const;
+  void Schedule (OspfLsdb::Key key, const LsaHeader &header, Time born);
+
+  OspfApp &m_app;
+  OspfTimerWheel m_wheel;
+  std::unordered_map<OspfLsdb::Key, Time> m_born; //!< When each tracked LSA was at age 0
+};
+
+} // namespace ns3
+
+#endif // OSPF_APP_LSA_AGING_H
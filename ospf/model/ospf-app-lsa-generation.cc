@@ -1,6 +1,7 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "ospf-app-private.h"
+#include "ospf-app-lsa-aging.h"
 
 namespace ns3 {
 
@@ -26,6 +27,11 @@ OspfApp::GetRouterLsa ()
       std::vector<RouterLink> links = m_ospfInterfaces[i]->GetActiveRouterLinks ();
       for (auto l : links)
         {
+          if (m_stubRouter)
+            {
+              // Last resort for transit, still usable to reach the router itself
+              l.m_metric = MAX_LINK_METRIC;
+            }
           allLinks.emplace_back (l);
         }
     }
@@ -59,22 +65,23 @@ OspfApp::RecomputeRouterLsa ()
 
   if (!m_minLsInterval.IsZero ())
     {
-      m_lastLsaOriginationTime[lsaKey] = Simulator::Now ();
+      OspfLsdb::Origination &origination = m_lsdb.GetOrigination (lsaKey);
+      origination.originated = true;
+      origination.last = Simulator::Now ();
     }
 
-  if (m_seqNumbers.find (lsaKey) == m_seqNumbers.end ())
-    {
-      m_seqNumbers[lsaKey] = 0;
-    }
-
-  m_seqNumbers[lsaKey]++;
+  uint16_t seqNum = m_lsdb.GetSeqNum (lsaKey) + 1;
+  m_lsdb.SetSeqNum (lsaKey, seqNum);
 
   Ptr<RouterLsa> routerLsa = GetRouterLsa ();
 
   LsaHeader lsaHeader (lsaKey);
   lsaHeader.SetLength (20 + routerLsa->GetSerializedSize ());
-  lsaHeader.SetSeqNum (m_seqNumbers[lsaKey]);
-  m_routerLsdb[m_routerId.Get ()] = std::make_pair (lsaHeader, routerLsa);
+  lsaHeader.SetSeqNum (seqNum);
+  m_routerLsdb[m_routerId.Get ()] =
+      std::make_pair (lsaHeader, LsaPool::Intern (lsaHeader, routerLsa));
+  m_aging->Track (lsaHeader);
+  NotifyLsdbChanged ();
 
   ScheduleUpdateL1ShortestPath ();
 
@@ -93,22 +100,23 @@ OspfApp::RecomputeL1SummaryLsa ()
 
   if (!m_minLsInterval.IsZero ())
     {
-      m_lastLsaOriginationTime[lsaKey] = Simulator::Now ();
+      OspfLsdb::Origination &origination = m_lsdb.GetOrigination (lsaKey);
+      origination.originated = true;
+      origination.last = Simulator::Now ();
     }
 
-  if (m_seqNumbers.find (lsaKey) == m_seqNumbers.end ())
-    {
-      m_seqNumbers[lsaKey] = 0;
-    }
-
-  m_seqNumbers[lsaKey]++;
+  uint16_t seqNum = m_lsdb.GetSeqNum (lsaKey) + 1;
+  m_lsdb.SetSeqNum (lsaKey, seqNum);
 
   Ptr<L1SummaryLsa> l1SummaryLsa = GetL1SummaryLsa ();
 
   LsaHeader lsaHeader (lsaKey);
   lsaHeader.SetLength (20 + l1SummaryLsa->GetSerializedSize ());
-  lsaHeader.SetSeqNum (m_seqNumbers[lsaKey]);
-  m_l1SummaryLsdb[m_routerId.Get ()] = std::make_pair (lsaHeader, l1SummaryLsa);
+  lsaHeader.SetSeqNum (seqNum);
+  m_l1SummaryLsdb[m_routerId.Get ()] =
+      std::make_pair (lsaHeader, LsaPool::Intern (lsaHeader, l1SummaryLsa));
+  m_aging->Track (lsaHeader);
+  NotifyLsdbChanged ();
 
   Ptr<LsUpdate> lsUpdate = Create<LsUpdate> ();
   lsUpdate->AddLsa (m_l1SummaryLsdb[m_routerId.Get ()]);
@@ -134,20 +142,20 @@ OspfApp::RecomputeAreaLsa ()
 
   if (!m_minLsInterval.IsZero ())
     {
-      m_lastLsaOriginationTime[lsaKey] = Simulator::Now ();
-    }
-
-  if (m_seqNumbers.find (lsaKey) == m_seqNumbers.end ())
-    {
-      m_seqNumbers[lsaKey] = 0;
+      OspfLsdb::Origination &origination = m_lsdb.GetOrigination (lsaKey);
+      origination.originated = true;
+      origination.last = Simulator::Now ();
     }
 
-  m_seqNumbers[lsaKey]++;
+  uint16_t seqNum = m_lsdb.GetSeqNum (lsaKey) + 1;
+  m_lsdb.SetSeqNum (lsaKey, seqNum);
 
   LsaHeader lsaHeader (lsaKey);
   lsaHeader.SetLength (20 + areaLsa->GetSerializedSize ());
-  lsaHeader.SetSeqNum (m_seqNumbers[lsaKey]);
-  m_areaLsdb[m_areaId] = std::make_pair (lsaHeader, areaLsa);
+  lsaHeader.SetSeqNum (seqNum);
+  m_areaLsdb[m_areaId] = std::make_pair (lsaHeader, LsaPool::Intern (lsaHeader, areaLsa));
+  m_aging->Track (lsaHeader);
+  NotifyLsdbChanged ();
 
   Ptr<LsUpdate> lsUpdateArea = Create<LsUpdate> ();
   lsUpdateArea->AddLsa (m_areaLsdb[m_areaId]);
@@ -162,14 +170,24 @@ OspfApp::RecomputeL2SummaryLsa ()
   NS_LOG_FUNCTION (this);
 
   Ptr<L2SummaryLsa> summary = Create<L2SummaryLsa> ();
-  for (auto &[routerId, l1SummaryLsa] : m_l1SummaryLsdb)
+  if (m_areaRanges.empty () && !m_autoSummarize)
     {
-      for (auto route : l1SummaryLsa.second->GetRoutes ())
+      for (auto &[routerId, l1SummaryLsa] : m_l1SummaryLsdb)
         {
-          summary->AddRoute (SummaryRoute (route.m_address, route.m_mask, route.m_metric));
+          for (auto route : l1SummaryLsa.second->GetRoutes ())
+            {
+              summary->AddRoute (SummaryRoute (route.m_address, route.m_mask, route.m_metric));
+            }
         }
     }
-  
+  else
+    {
+      for (auto &route : SummarizeL2Routes ())
+        {
+          summary->AddRoute (route);
+        }
+    }
+
   if (m_l2SummaryLsdb.find (m_areaId) != m_l2SummaryLsdb.end ())
     {
       auto &[header, lsa] = m_l2SummaryLsdb[m_areaId];
@@ -183,26 +201,130 @@ OspfApp::RecomputeL2SummaryLsa ()
 
   if (!m_minLsInterval.IsZero ())
     {
-      m_lastLsaOriginationTime[lsaKey] = Simulator::Now ();
+      OspfLsdb::Origination &origination = m_lsdb.GetOrigination (lsaKey);
+      origination.originated = true;
+      origination.last = Simulator::Now ();
     }
 
-  if (m_seqNumbers.find (lsaKey) == m_seqNumbers.end ())
-    {
-      m_seqNumbers[lsaKey] = 0;
-    }
-
-  m_seqNumbers[lsaKey]++;
+  uint16_t seqNum = m_lsdb.GetSeqNum (lsaKey) + 1;
+  m_lsdb.SetSeqNum (lsaKey, seqNum);
 
   LsaHeader lsaHeader (lsaKey);
   lsaHeader.SetLength (20 + summary->GetSerializedSize ());
-  lsaHeader.SetSeqNum (m_seqNumbers[lsaKey]);
-  m_l2SummaryLsdb[m_areaId] = std::make_pair (lsaHeader, summary);
+  lsaHeader.SetSeqNum (seqNum);
+  m_l2SummaryLsdb[m_areaId] = std::make_pair (lsaHeader, LsaPool::Intern (lsaHeader, summary));
+  m_aging->Track (lsaHeader);
+  NotifyLsdbChanged ();
 
   Ptr<LsUpdate> lsUpdateSummary = Create<LsUpdate> ();
   lsUpdateSummary->AddLsa (m_l2SummaryLsdb[m_areaId]);
   FloodLsu (0, lsUpdateSummary);
-  UpdateRouting ();
+  UpdateL2SummaryRoutes (m_areaId);
   return true;
 }
 
+std::set<SummaryRoute>
+OspfApp::SummarizeL2Routes ()
+{
+  // <network, mask> -> metric, the lowest among the routers announcing it
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> prefixes;
+  for (auto &[routerId, l1SummaryLsa] : m_l1SummaryLsdb)
+    {
+      for (auto route : l1SummaryLsa.second->GetRoutes ())
+        {
+          auto key = std::make_pair (route.m_address & route.m_mask, route.m_mask);
+          auto it = prefixes.find (key);
+          if (it == prefixes.end () || route.m_metric < it->second)
+            {
+              prefixes[key] = route.m_metric;
+            }
+        }
+    }
+
+  // Prefixes inside a range go to the outermost one, which takes the
+  // highest of their metrics
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> ranges;
+  for (auto it = prefixes.begin (); it != prefixes.end ();)
+    {
+      auto outer = m_areaRanges.end ();
+      for (auto range = m_areaRanges.begin (); range != m_areaRanges.end (); range++)
+        {
+          uint32_t mask = range->first.second;
+          if ((it->first.second & mask) == mask && (it->first.first & mask) == range->first.first &&
+              (outer == m_areaRanges.end () || mask < outer->first.second))
+            {
+              outer = range;
+            }
+        }
+      if (outer == m_areaRanges.end ())
+        {
+          ++it;
+          continue;
+        }
+      if (outer->second)
+        {
+          auto range = ranges.emplace (outer->first, it->second).first;
+          range->second = std::max (range->second, it->second);
+        }
+      it = prefixes.erase (it);
+    }
+  prefixes.insert (ranges.begin (), ranges.end ());
+
+  if (m_autoSummarize)
+    {
+      // A prefix covers everything after it up to its last address
+      auto cover = prefixes.end ();
+      for (auto it = prefixes.begin (); it != prefixes.end ();)
+        {
+          if (cover != prefixes.end () &&
+              (it->first.first & cover->first.second) == cover->first.first)
+            {
+              cover->second = std::max (cover->second, it->second);
+              it = prefixes.erase (it);
+              continue;
+            }
+          cover = it++;
+        }
+
+      // Nothing covers anything now, so merging siblings bottom-up never
+      // reaches an existing prefix
+      std::vector<std::map<uint32_t, uint32_t>> byLength (33);
+      for (auto &[key, metric] : prefixes)
+        {
+          byLength[Ipv4Mask (key.second).GetPrefixLength ()][key.first] = metric;
+        }
+      prefixes.clear ();
+      for (uint32_t length = 32; length > 0; length--)
+        {
+          uint32_t bit = 1u << (32 - length);
+          uint32_t parentMask = length == 1 ? 0 : ~0u << (33 - length);
+          for (auto it = byLength[length].begin (); it != byLength[length].end ();)
+            {
+              auto sibling = std::next (it);
+              if ((it->first & bit) == 0 && sibling != byLength[length].end () &&
+                  sibling->first == (it->first | bit))
+                {
+                  byLength[length - 1][it->first & parentMask] =
+                      std::max (it->second, sibling->second);
+                  it = byLength[length].erase (it, std::next (sibling));
+                  continue;
+                }
+              prefixes[std::make_pair (it->first, ~0u << (32 - length))] = it->second;
+              ++it;
+            }
+        }
+      for (auto &[network, metric] : byLength[0])
+        {
+          prefixes[std::make_pair (network, 0)] = metric;
+        }
+    }
+
+  std::set<SummaryRoute> routes;
+  for (auto &[key, metric] : prefixes)
+    {
+      routes.emplace (key.first, key.second, metric);
+    }
+  return routes;
+}
+
 } // namespace ns3
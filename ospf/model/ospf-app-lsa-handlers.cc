@@ -50,54 +50,12 @@ OspfApp::HandleLsAck (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader ospfHead
 std::pair<LsaHeader, Ptr<Lsa>>
 OspfApp::FetchLsa (LsaHeader::LsaKey lsaKey)
 {
-  uint32_t lsId = std::get<1> (lsaKey);
-
-  switch (std::get<0> (lsaKey))
+  auto lsa = m_lsdb.Fetch (lsaKey);
+  if (lsa.second == nullptr)
     {
-    case LsaHeader::RouterLSAs:
-      {
-        auto it = m_routerLsdb.find (lsId);
-        if (it == m_routerLsdb.end ())
-          {
-            NS_LOG_WARN ("FetchLsa: RouterLSA not found for lsId=" << Ipv4Address (lsId));
-            return {LsaHeader (), nullptr};
-          }
-        return {it->second.first, it->second.second};
-      }
-    case LsaHeader::L1SummaryLSAs:
-      {
-        auto it = m_l1SummaryLsdb.find (lsId);
-        if (it == m_l1SummaryLsdb.end ())
-          {
-            NS_LOG_WARN ("FetchLsa: L1SummaryLSA not found for lsId=" << Ipv4Address (lsId));
-            return {LsaHeader (), nullptr};
-          }
-        return {it->second.first, it->second.second};
-      }
-    case LsaHeader::AreaLSAs:
-      {
-        auto it = m_areaLsdb.find (lsId);
-        if (it == m_areaLsdb.end ())
-          {
-            NS_LOG_WARN ("FetchLsa: AreaLSA not found for lsId=" << Ipv4Address (lsId));
-            return {LsaHeader (), nullptr};
-          }
-        return {it->second.first, it->second.second};
-      }
-    case LsaHeader::L2SummaryLSAs:
-      {
-        auto it = m_l2SummaryLsdb.find (lsId);
-        if (it == m_l2SummaryLsdb.end ())
-          {
-            NS_LOG_WARN ("FetchLsa: L2SummaryLSA not found for lsId=" << Ipv4Address (lsId));
-            return {LsaHeader (), nullptr};
-          }
-        return {it->second.first, it->second.second};
-      }
-    default:
-      NS_LOG_WARN ("FetchLsa: unsupported LSA type " << static_cast<uint32_t> (std::get<0> (lsaKey)));
-      return {LsaHeader (), nullptr};
+      NS_LOG_WARN ("FetchLsa: LSA not found for " << LsaHeader::GetKeyString (lsaKey));
     }
+  return lsa;
 }
 
 } // namespace ns3
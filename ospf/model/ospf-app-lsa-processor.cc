@@ -2,6 +2,7 @@
 
 #include "ospf-app-lsa-processor.h"
 
+#include "ospf-app-lsa-aging.h"
 #include "ospf-app-private.h"
 
 namespace ns3 {
@@ -46,7 +47,7 @@ OspfLsaProcessor::HandleLsr (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
               lsUpdates.emplace_back (lsUpdate);
               lsUpdate = Create<LsUpdate> ();
             }
-          lsUpdate->AddLsa (lsa.first, lsa.second);
+          lsUpdate->AddLsa (m_app.m_aging->GetAged (lsa.first), lsa.second);
         }
     }
   for (auto &[remoteRouterId, lsa] : m_app.m_l1SummaryLsdb)
@@ -58,7 +59,7 @@ OspfLsaProcessor::HandleLsr (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
               lsUpdates.emplace_back (lsUpdate);
               lsUpdate = Create<LsUpdate> ();
             }
-          lsUpdate->AddLsa (lsa.first, lsa.second);
+          lsUpdate->AddLsa (m_app.m_aging->GetAged (lsa.first), lsa.second);
         }
     }
   for (auto &[remoteAreaId, lsa] : m_app.m_areaLsdb)
@@ -70,7 +71,7 @@ OspfLsaProcessor::HandleLsr (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
               lsUpdates.emplace_back (lsUpdate);
               lsUpdate = Create<LsUpdate> ();
             }
-          lsUpdate->AddLsa (lsa.first, lsa.second);
+          lsUpdate->AddLsa (m_app.m_aging->GetAged (lsa.first), lsa.second);
         }
     }
   for (auto &[remoteAreaId, lsa] : m_app.m_l2SummaryLsdb)
@@ -82,7 +83,7 @@ OspfLsaProcessor::HandleLsr (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
               lsUpdates.emplace_back (lsUpdate);
               lsUpdate = Create<LsUpdate> ();
             }
-          lsUpdate->AddLsa (lsa.first, lsa.second);
+          lsUpdate->AddLsa (m_app.m_aging->GetAged (lsa.first), lsa.second);
         }
     }
   lsUpdates.emplace_back (lsUpdate);
@@ -147,14 +148,12 @@ OspfLsaProcessor::HandleLsa (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
     {
       NS_LOG_INFO ("LSU is dropped, received LSU has originated here");
       m_app.SendAck (ifIndex, ackPacket, neighbor->GetIpAddress ());
+      m_app.m_aging->HandleSelfOriginated (lsaHeader, lsa);
       return;
     }
 
-  // Initialize local seqNum if it does not exist
-  if (m_app.m_seqNumbers.find (lsaKey) == m_app.m_seqNumbers.end ())
-    {
-      m_app.m_seqNumbers[lsaKey] = 0;
-    }
+  // Last seq num heard from the originating router, 0 if none
+  uint16_t storedSeqNum = m_app.m_lsdb.GetSeqNum (lsaKey);
 
   // Satisfy LSR
   bool isLsrSatisfied = false;
@@ -173,9 +172,27 @@ OspfLsaProcessor::HandleLsa (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
         }
     }
 
+  // A MaxAge LSA we do not have is only acknowledged (RFC 2328 13 (4))
+  bool isMaxAge = m_app.m_aging->IsMaxAge (lsaHeader);
+  if (isMaxAge)
+    {
+      auto installed = m_app.m_lsdb.Fetch (lsaKey);
+      if (installed.second == nullptr ||
+          installed.first.GetAdvertisingRouter () != advertisingRouter)
+        {
+          neighbor->RemoveKeyedTimeout (lsaKey);
+          if (!isLsrSatisfied)
+            {
+              m_app.SendAck (ifIndex, ackPacket, neighbor->GetIpAddress ());
+            }
+          return;
+        }
+    }
+
   // If the sequence number equals to that of the last packet received from the
-  // originating router, the packet is dropped and ACK is sent.
-  if (seqNum == m_app.m_seqNumbers[lsaKey])
+  // originating router, the packet is dropped and ACK is sent. A MaxAge
+  // instance of the same LSA is newer (RFC 2328 13.1).
+  if (seqNum == storedSeqNum && !isMaxAge)
     {
       if (!isLsrSatisfied)
         {
@@ -186,9 +203,9 @@ OspfLsaProcessor::HandleLsa (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
       neighbor->RemoveKeyedTimeout (lsaKey);
       return;
     }
-  else if (seqNum > m_app.m_seqNumbers[lsaKey])
+  else if (seqNum >= storedSeqNum)
     {
-      NS_LOG_INFO ("Installing new LSA: " << seqNum << " > " << m_app.m_seqNumbers[lsaKey]);
+      NS_LOG_INFO ("Installing new LSA: " << seqNum << " > " << storedSeqNum);
       // New LSA
       // Process LSA and update its Seq num
       ProcessLsa (lsaHeader, lsa);
@@ -211,7 +228,7 @@ OspfLsaProcessor::HandleLsa (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader o
   else if (!isLsrSatisfied)
     {
       // Stale LSA
-      NS_LOG_WARN ("Received stale LSA " << seqNum << " < " << m_app.m_seqNumbers[lsaKey]);
+      NS_LOG_WARN ("Received stale LSA " << seqNum << " < " << storedSeqNum);
       // Just send ACK
       m_app.SendAck (ifIndex, ackPacket, neighbor->GetIpAddress ());
     }
@@ -224,8 +241,14 @@ OspfLsaProcessor::ProcessLsa (LsaHeader lsaHeader, Ptr<Lsa> lsa)
     {
       m_app.PrintLsaTiming (lsaHeader.GetSeqNum (), lsaHeader.GetKey (), Simulator::Now ());
     }
+  if (m_app.m_aging->IsMaxAge (lsaHeader))
+    {
+      // Flushed by its originator or aged out elsewhere
+      m_app.m_aging->Remove (lsaHeader);
+      return;
+    }
   // Update seq num
-  m_app.m_seqNumbers[lsaHeader.GetKey ()] = lsaHeader.GetSeqNum ();
+  m_app.m_lsdb.SetSeqNum (lsaHeader.GetKey (), lsaHeader.GetSeqNum ());
   switch (lsaHeader.GetType ())
     {
     case LsaHeader::RouterLSAs:
@@ -244,6 +267,8 @@ OspfLsaProcessor::ProcessLsa (LsaHeader lsaHeader, Ptr<Lsa> lsa)
       NS_LOG_WARN ("Received unsupport LSA type in received LS Update");
       break;
     }
+  m_app.m_aging->Track (lsaHeader);
+  m_app.NotifyLsdbChanged ();
 }
 
 void
@@ -284,8 +309,10 @@ OspfLsaProcessor::HandleLsAck (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader
 
   for (auto lsaHeader : lsaHeaders)
     {
-      // Remove timeout if the stored seq num have been satisfied
-      if (lsaHeader.GetSeqNum () <= m_app.m_seqNumbers[lsaHeader.GetKey ()])
+      // Remove timeout if the stored seq num have been satisfied. A flushed
+      // LSA's sequence number is forgotten, its MaxAge copy is acked as is.
+      if (lsaHeader.GetSeqNum () <= m_app.m_lsdb.GetSeqNum (lsaHeader.GetKey ()) ||
+          m_app.m_aging->IsMaxAge (lsaHeader))
         {
           bool isRemoved = neighbor->RemoveKeyedTimeout (lsaHeader.GetKey ());
           if (isRemoved)
@@ -301,6 +328,10 @@ OspfLsaProcessor::HandleLsAck (uint32_t ifIndex, Ipv4Header ipHeader, OspfHeader
             }
         }
     }
+  if (m_app.m_draining)
+    {
+      m_app.CheckDrain ();
+    }
 }
 
 } // namespace ns3
@@ -32,7 +32,7 @@ OspfApp::ProcessL1SummaryLsa (LsaHeader lsaHeader, Ptr<L1SummaryLsa> l1SummaryLs
         }
     }
 
-  UpdateRouting ();
+  UpdateL1SummaryRoutes (lsId);
 }
 
 void
@@ -133,20 +133,20 @@ OspfApp::ProcessL2SummaryLsa (LsaHeader lsaHeader, Ptr<L2SummaryLsa> l2SummaryLs
   if (m_l2SummaryLsdb.find (lsId) == m_l2SummaryLsdb.end ())
     {
       m_l2SummaryLsdb[lsId] = std::make_pair (lsaHeader, l2SummaryLsa);
-      UpdateRouting ();
+      UpdateL2SummaryRoutes (lsId);
       return;
     }
 
   if (lsaHeader.GetSeqNum () > m_l2SummaryLsdb[lsId].first.GetSeqNum ())
     {
       m_l2SummaryLsdb[lsId] = std::make_pair (lsaHeader, l2SummaryLsa);
-      UpdateRouting ();
+      UpdateL2SummaryRoutes (lsId);
     }
   else if (lsaHeader.GetSeqNum () == m_l2SummaryLsdb[lsId].first.GetSeqNum () &&
            lsaHeader.GetAdvertisingRouter () < m_l2SummaryLsdb[lsId].first.GetAdvertisingRouter ())
     {
       m_l2SummaryLsdb[lsId] = std::make_pair (lsaHeader, l2SummaryLsa);
-      UpdateRouting ();
+      UpdateL2SummaryRoutes (lsId);
     }
 }
 
@@ -34,10 +34,10 @@ OspfApp::GetLsaThrottleDelay (const LsaHeader::LsaKey &lsaKey)
       return Time (0);
     }
 
-  auto lastIt = m_lastLsaOriginationTime.find (lsaKey);
-  if (lastIt != m_lastLsaOriginationTime.end ())
+  const OspfLsdb::Origination &origination = m_lsdb.GetOrigination (lsaKey);
+  if (origination.originated)
     {
-      Time elapsed = Simulator::Now () - lastIt->second;
+      Time elapsed = Simulator::Now () - origination.last;
       if (elapsed < m_minLsInterval)
         {
           return m_minLsInterval - elapsed;
@@ -46,16 +46,6 @@ OspfApp::GetLsaThrottleDelay (const LsaHeader::LsaKey &lsaKey)
   return Time (0);
 }
 
-void
-OspfApp::CleanupThrottleEvent (const LsaHeader::LsaKey &lsaKey)
-{
-  auto it = m_pendingLsaRegeneration.find (lsaKey);
-  if (it != m_pendingLsaRegeneration.end () && !it->second.IsRunning ())
-    {
-      m_pendingLsaRegeneration.erase (it);
-    }
-}
-
 // Wrapper methods for bool-returning functions (needed for ns-3.35 Simulator::Schedule)
 void
 OspfApp::RecomputeAreaLsaWrapper ()
@@ -76,7 +66,6 @@ OspfApp::ThrottledRecomputeRouterLsa ()
   auto lsaKey =
       std::make_tuple (LsaHeader::LsType::RouterLSAs, m_routerId.Get (), m_routerId.Get ());
 
-  CleanupThrottleEvent (lsaKey);
   if (m_enableLsaThrottleStats)
     {
       ++m_lsaThrottleRecomputeTriggers;
@@ -85,11 +74,10 @@ OspfApp::ThrottledRecomputeRouterLsa ()
 
   if (delay.IsZero ())
     {
-      auto pendingIt = m_pendingLsaRegeneration.find (lsaKey);
-      if (pendingIt != m_pendingLsaRegeneration.end ())
+      EventId &pending = m_lsdb.GetOrigination (lsaKey).pending;
+      if (pending.IsRunning ())
         {
-          Simulator::Cancel (pendingIt->second);
-          m_pendingLsaRegeneration.erase (pendingIt);
+          Simulator::Cancel (pending);
           if (m_enableLsaThrottleStats)
             {
               ++m_lsaThrottleCancelledPending;
@@ -101,15 +89,15 @@ OspfApp::ThrottledRecomputeRouterLsa ()
         }
       RecomputeRouterLsa ();
     }
-  else if (m_pendingLsaRegeneration.find (lsaKey) == m_pendingLsaRegeneration.end ())
+  else if (!m_lsdb.GetOrigination (lsaKey).pending.IsRunning ())
     {
       NS_LOG_INFO ("Router-LSA throttled, deferring by " << delay.As (Time::MS));
       if (m_enableLsaThrottleStats)
         {
           ++m_lsaThrottleDeferredScheduled;
         }
-      m_pendingLsaRegeneration[lsaKey] =
-          Simulator::Schedule (delay, &OspfApp::RecomputeRouterLsa, this);
+      m_lsdb.DeferOrigination (
+          lsaKey, Simulator::Schedule (delay, &OspfApp::RecomputeRouterLsa, this));
     }
   else
     {
@@ -127,7 +115,6 @@ OspfApp::ThrottledRecomputeL1SummaryLsa ()
   auto lsaKey =
       std::make_tuple (LsaHeader::LsType::L1SummaryLSAs, m_routerId.Get (), m_routerId.Get ());
 
-  CleanupThrottleEvent (lsaKey);
   if (m_enableLsaThrottleStats)
     {
       ++m_lsaThrottleRecomputeTriggers;
@@ -136,11 +123,10 @@ OspfApp::ThrottledRecomputeL1SummaryLsa ()
 
   if (delay.IsZero ())
     {
-      auto pendingIt = m_pendingLsaRegeneration.find (lsaKey);
-      if (pendingIt != m_pendingLsaRegeneration.end ())
+      EventId &pending = m_lsdb.GetOrigination (lsaKey).pending;
+      if (pending.IsRunning ())
         {
-          Simulator::Cancel (pendingIt->second);
-          m_pendingLsaRegeneration.erase (pendingIt);
+          Simulator::Cancel (pending);
           if (m_enableLsaThrottleStats)
             {
               ++m_lsaThrottleCancelledPending;
@@ -152,15 +138,15 @@ OspfApp::ThrottledRecomputeL1SummaryLsa ()
         }
       RecomputeL1SummaryLsa ();
     }
-  else if (m_pendingLsaRegeneration.find (lsaKey) == m_pendingLsaRegeneration.end ())
+  else if (!m_lsdb.GetOrigination (lsaKey).pending.IsRunning ())
     {
       NS_LOG_INFO ("L1Summary-LSA throttled, deferring by " << delay.As (Time::MS));
       if (m_enableLsaThrottleStats)
         {
           ++m_lsaThrottleDeferredScheduled;
         }
-      m_pendingLsaRegeneration[lsaKey] =
-          Simulator::Schedule (delay, &OspfApp::RecomputeL1SummaryLsa, this);
+      m_lsdb.DeferOrigination (
+          lsaKey, Simulator::Schedule (delay, &OspfApp::RecomputeL1SummaryLsa, this));
     }
   else
     {
@@ -177,7 +163,6 @@ OspfApp::ThrottledRecomputeAreaLsa ()
   NS_LOG_FUNCTION (this);
   auto lsaKey = std::make_tuple (LsaHeader::LsType::AreaLSAs, m_areaId, m_routerId.Get ());
 
-  CleanupThrottleEvent (lsaKey);
   if (m_enableLsaThrottleStats)
     {
       ++m_lsaThrottleRecomputeTriggers;
@@ -186,11 +171,10 @@ OspfApp::ThrottledRecomputeAreaLsa ()
 
   if (delay.IsZero ())
     {
-      auto pendingIt = m_pendingLsaRegeneration.find (lsaKey);
-      if (pendingIt != m_pendingLsaRegeneration.end ())
+      EventId &pending = m_lsdb.GetOrigination (lsaKey).pending;
+      if (pending.IsRunning ())
         {
-          Simulator::Cancel (pendingIt->second);
-          m_pendingLsaRegeneration.erase (pendingIt);
+          Simulator::Cancel (pending);
           if (m_enableLsaThrottleStats)
             {
               ++m_lsaThrottleCancelledPending;
@@ -202,15 +186,15 @@ OspfApp::ThrottledRecomputeAreaLsa ()
         }
       RecomputeAreaLsa ();
     }
-  else if (m_pendingLsaRegeneration.find (lsaKey) == m_pendingLsaRegeneration.end ())
+  else if (!m_lsdb.GetOrigination (lsaKey).pending.IsRunning ())
     {
       NS_LOG_INFO ("Area-LSA throttled, deferring by " << delay.As (Time::MS));
       if (m_enableLsaThrottleStats)
         {
           ++m_lsaThrottleDeferredScheduled;
         }
-      m_pendingLsaRegeneration[lsaKey] =
-          Simulator::Schedule (delay, &OspfApp::RecomputeAreaLsaWrapper, this);
+      m_lsdb.DeferOrigination (
+          lsaKey, Simulator::Schedule (delay, &OspfApp::RecomputeAreaLsaWrapper, this));
     }
   else
     {
@@ -227,7 +211,6 @@ OspfApp::ThrottledRecomputeL2SummaryLsa ()
   NS_LOG_FUNCTION (this);
   auto lsaKey = std::make_tuple (LsaHeader::LsType::L2SummaryLSAs, m_areaId, m_routerId.Get ());
 
-  CleanupThrottleEvent (lsaKey);
   if (m_enableLsaThrottleStats)
     {
       ++m_lsaThrottleRecomputeTriggers;
@@ -236,11 +219,10 @@ OspfApp::ThrottledRecomputeL2SummaryLsa ()
 
   if (delay.IsZero ())
     {
-      auto pendingIt = m_pendingLsaRegeneration.find (lsaKey);
-      if (pendingIt != m_pendingLsaRegeneration.end ())
+      EventId &pending = m_lsdb.GetOrigination (lsaKey).pending;
+      if (pending.IsRunning ())
         {
-          Simulator::Cancel (pendingIt->second);
-          m_pendingLsaRegeneration.erase (pendingIt);
+          Simulator::Cancel (pending);
           if (m_enableLsaThrottleStats)
             {
               ++m_lsaThrottleCancelledPending;
@@ -252,15 +234,15 @@ OspfApp::ThrottledRecomputeL2SummaryLsa ()
         }
       RecomputeL2SummaryLsa ();
     }
-  else if (m_pendingLsaRegeneration.find (lsaKey) == m_pendingLsaRegeneration.end ())
+  else if (!m_lsdb.GetOrigination (lsaKey).pending.IsRunning ())
     {
       NS_LOG_INFO ("L2Summary-LSA throttled, deferring by " << delay.As (Time::MS));
       if (m_enableLsaThrottleStats)
         {
           ++m_lsaThrottleDeferredScheduled;
         }
-      m_pendingLsaRegeneration[lsaKey] =
-          Simulator::Schedule (delay, &OspfApp::RecomputeL2SummaryLsaWrapper, this);
+      m_lsdb.DeferOrigination (
+          lsaKey, Simulator::Schedule (delay, &OspfApp::RecomputeL2SummaryLsaWrapper, this));
     }
   else
     {
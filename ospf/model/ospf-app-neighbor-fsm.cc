@@ -3,6 +3,7 @@
 #include "ospf-app-neighbor-fsm.h"
 
 #include "ospf-app-private.h"
+#include "ospf-app-routing-engine.h"
 
 namespace ns3 {
 
@@ -397,6 +398,8 @@ OspfNeighborFsm::FallbackToInit (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor)
   NS_LOG_INFO ("Move to Init");
   // TODO: Defer router lsa update until when the link is fully down
   neighbor->SetState (OspfNeighbor::Init);
+  m_app.m_routingEngine->NotifyNeighborState (ifIndex, neighbor);
+  m_app.m_routingEngine->RepairL1NextHops (ifIndex, neighbor->GetIpAddress ());
 
   // Fill in the current Router LSDB (throttled to prevent LSA storms)
   m_app.ThrottledRecomputeRouterLsa ();
@@ -415,6 +418,8 @@ OspfNeighborFsm::FallbackToDown (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor)
 {
   NS_LOG_INFO ("Hello timeout. Move to Down");
   neighbor->SetState (OspfNeighbor::Down);
+  m_app.m_routingEngine->NotifyNeighborState (ifIndex, neighbor);
+  m_app.m_routingEngine->RepairL1NextHops (ifIndex, neighbor->GetIpAddress ());
   // Fill in the current Router LSDB (throttled to prevent LSA storms)
   m_app.ThrottledRecomputeRouterLsa ();
 
@@ -572,6 +577,7 @@ OspfNeighborFsm::AdvanceToFull (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor)
 {
   NS_LOG_INFO ("LSR Queue is empty. Loading is done. Advance to FULL");
   neighbor->SetState (OspfNeighbor::Full);
+  m_app.m_routingEngine->NotifyNeighborState (ifIndex, neighbor);
   // Remove data sync timeout
   neighbor->RemoveTimeout ();
 
@@ -22,11 +22,13 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/core-module.h"
 #include "ns3/ospf-packet-helper.h"
+#include "ns3/lsa-pool.h"
 
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <queue>
 #include <set>
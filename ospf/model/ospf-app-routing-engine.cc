@@ -3,341 +3,3004 @@
 #include "ospf-app-routing-engine.h"
 
 #include "ospf-app-private.h"
+#include "ospf-spf-batch.h"
+#include "ospf-spf-cache.h"
+
+#include "ns3/ipv4-list-routing.h"
+
+#include <tuple>
 
 namespace ns3 {
 
-OspfRoutingEngine::OspfRoutingEngine (OspfApp &app)
-  : m_app (app)
+namespace {
+
+uint32_t
+PrefixMask (uint8_t length)
+{
+  return length == 0 ? 0 : ~0u << (32 - length);
+}
+
+} // namespace
+
+OspfRoutingEngine::OspfRoutingEngine (OspfApp &app)
+  : m_app (app)
+{
+}
+
+OspfRoutingEngine::~OspfRoutingEngine ()
+{
+  OspfSpfBatch::Remove (this);
+  m_fibWriteEvent.Cancel ();
+}
+
+void
+OspfRoutingEngine::UpdateRouting ()
+{
+  if (UsesLazyFib ())
+    {
+      UpdateLazyRouting ();
+      return;
+    }
+
+  RebuildPrefixIndex ();
+  if (!IsShadowRibSizeInSync ())
+    {
+      FlushShadowRib ();
+    }
+
+  // Group every known prefix by its origins
+  std::map<PrefixKey, uint32_t> rib;
+  for (auto &[key, value] : m_externalPrefixes)
+    {
+      (void)value;
+      rib[key] = AttachPrefix (key);
+    }
+  for (auto &[key, origins] : m_l1PrefixOrigins)
+    {
+      (void)origins;
+      if (rib.find (key) == rib.end ())
+        {
+          rib[key] = AttachPrefix (key);
+        }
+    }
+  for (auto &[key, origins] : m_l2PrefixOrigins)
+    {
+      (void)origins;
+      if (rib.find (key) == rib.end ())
+        {
+          rib[key] = AttachPrefix (key);
+        }
+    }
+  for (auto it = m_prefixGroup.begin (); it != m_prefixGroup.end ();)
+    {
+      auto next = std::next (it);
+      if (rib.find (it->first) == rib.end ())
+        {
+          DetachPrefix (it->first);
+        }
+      it = next;
+    }
+
+  // Resolve each group once
+  for (auto &[id, group] : m_groups)
+    {
+      RefreshNextHopGroup (id, group);
+    }
+
+  // Apply only the differences to the routing table
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (table != nullptr)
+    {
+      table->BeginBulkUpdate ();
+    }
+  if (UsesFibCompression ())
+    {
+      // The shadow RIB holds aggregates; withdraw from the compressor instead
+      for (auto it = m_compressedPrefixes.begin (); it != m_compressedPrefixes.end ();)
+        {
+          PrefixKey key = it->first;
+          ++it;
+          if (rib.find (key) == rib.end ())
+            {
+              CompressPrefix (key, 0);
+            }
+        }
+    }
+  else
+    {
+      for (auto it = m_shadowRib.begin (); it != m_shadowRib.end ();)
+        {
+          it = rib.find (it->first) == rib.end () ? UninstallRoute (it) : std::next (it);
+        }
+      for (auto it = m_discardPrefixes.begin (); it != m_discardPrefixes.end ();)
+        {
+          PrefixKey key = *it;
+          ++it;
+          if (rib.find (key) == rib.end ())
+            {
+              SyncDiscardRoute (key);
+            }
+        }
+    }
+  for (auto &[key, id] : rib)
+    {
+      (void)id;
+      QueuePrefix (key);
+    }
+  WritePendingPrefixes ();
+  ApplyFibCompression ();
+  if (table != nullptr)
+    {
+      table->EndBulkUpdate ();
+    }
+}
+
+void
+OspfRoutingEngine::UpdateNextHopGroups ()
+{
+  if (!m_prefixIndexValid || !IsShadowRibSizeInSync ())
+    {
+      UpdateRouting ();
+      return;
+    }
+
+  // Prefix origins did not change, only what they resolve to
+  if (UsesLazyFib ())
+    {
+      // A group that starts or stops resolving also moves the longest
+      // match of destinations under its prefixes
+      std::set<uint32_t> changed;
+      std::vector<PrefixKey> flipped;
+      for (auto &[id, group] : m_groups)
+        {
+          bool found = group.found;
+          if (!RefreshNextHopGroup (id, group))
+            {
+              continue;
+            }
+          changed.insert (id);
+          if (group.found != found)
+            {
+              flipped.insert (flipped.end (), group.prefixes.begin (), group.prefixes.end ());
+            }
+        }
+      RefreshLazyRoutes (0, std::numeric_limits<uint32_t>::max (), &changed);
+      for (auto &key : flipped)
+        {
+          RefreshLazyRoutes (key.first & key.second, key.first | ~key.second);
+        }
+      return;
+    }
+
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (table != nullptr)
+    {
+      table->BeginBulkUpdate ();
+    }
+  for (auto &[id, group] : m_groups)
+    {
+      // Compressed prefixes also follow their group in and out of resolving
+      if (!RefreshNextHopGroup (id, group) || (group.programmed && !UsesFibCompression ()))
+        {
+          continue;
+        }
+      for (auto &key : group.prefixes)
+        {
+          QueuePrefix (key);
+        }
+    }
+  WritePendingPrefixes ();
+  ApplyFibCompression ();
+  if (table != nullptr)
+    {
+      table->EndBulkUpdate ();
+    }
+}
+
+void
+OspfRoutingEngine::UpdateL1SummaryRoutes (uint32_t routerId)
+{
+  // Our own summary follows m_externalRoutes, which is not indexed incrementally
+  if (!m_prefixIndexValid || !IsShadowRibSizeInSync () || routerId == m_app.m_routerId.Get ())
+    {
+      UpdateRouting ();
+      return;
+    }
+
+  std::vector<PrefixKey> prefixes;
+  auto lsaIt = m_app.m_l1SummaryLsdb.find (routerId);
+  if (lsaIt != m_app.m_l1SummaryLsdb.end ())
+    {
+      prefixes = CollectL1Prefixes (lsaIt->second.second);
+    }
+
+  auto &indexed = m_l1OriginPrefixes[routerId];
+  std::vector<PrefixKey> withdrawn, announced;
+  std::set_difference (indexed.begin (), indexed.end (), prefixes.begin (), prefixes.end (),
+                       std::back_inserter (withdrawn));
+  std::set_difference (prefixes.begin (), prefixes.end (), indexed.begin (), indexed.end (),
+                       std::back_inserter (announced));
+  if (withdrawn.empty () && announced.empty ())
+    {
+      return;
+    }
+
+  for (auto &key : withdrawn)
+    {
+      auto it = m_l1PrefixOrigins.find (key);
+      it->second.erase (routerId);
+      if (it->second.empty ())
+        {
+          m_l1PrefixOrigins.erase (it);
+        }
+    }
+  for (auto &key : announced)
+    {
+      m_l1PrefixOrigins[key].insert (routerId);
+    }
+  indexed = std::move (prefixes);
+
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (table != nullptr)
+    {
+      table->BeginBulkUpdate ();
+    }
+  // Even unreachable originators move prefixes between groups
+  for (auto &key : withdrawn)
+    {
+      ReinstallPrefix (key);
+    }
+  for (auto &key : announced)
+    {
+      ReinstallPrefix (key);
+    }
+  WritePendingPrefixes ();
+  ApplyFibCompression ();
+  if (table != nullptr)
+    {
+      table->EndBulkUpdate ();
+    }
+}
+
+void
+OspfRoutingEngine::UpdateL2SummaryRoutes (uint32_t areaId)
+{
+  if (!m_prefixIndexValid || !IsShadowRibSizeInSync ())
+    {
+      UpdateRouting ();
+      return;
+    }
+
+  std::map<PrefixKey, uint32_t> prefixes;
+  auto lsaIt = m_app.m_l2SummaryLsdb.find (areaId);
+  if (lsaIt != m_app.m_l2SummaryLsdb.end ())
+    {
+      prefixes = CollectL2Prefixes (lsaIt->second.second);
+    }
+
+  // Prefixes that were withdrawn, announced, or changed metric
+  auto &indexed = m_l2OriginPrefixes[areaId];
+  std::vector<PrefixKey> changed;
+  auto oldIt = indexed.begin ();
+  auto newIt = prefixes.begin ();
+  while (oldIt != indexed.end () || newIt != prefixes.end ())
+    {
+      if (newIt == prefixes.end () ||
+          (oldIt != indexed.end () && oldIt->first < newIt->first))
+        {
+          auto it = m_l2PrefixOrigins.find (oldIt->first);
+          it->second.erase (areaId);
+          if (it->second.empty ())
+            {
+              m_l2PrefixOrigins.erase (it);
+            }
+          changed.push_back (oldIt->first);
+          ++oldIt;
+        }
+      else if (oldIt == indexed.end () || newIt->first < oldIt->first)
+        {
+          m_l2PrefixOrigins[newIt->first][areaId] = newIt->second;
+          changed.push_back (newIt->first);
+          ++newIt;
+        }
+      else
+        {
+          if (oldIt->second != newIt->second)
+            {
+              m_l2PrefixOrigins[newIt->first][areaId] = newIt->second;
+              changed.push_back (newIt->first);
+            }
+          ++oldIt;
+          ++newIt;
+        }
+    }
+  indexed = std::move (prefixes);
+
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (table != nullptr)
+    {
+      table->BeginBulkUpdate ();
+    }
+  // Our own and unreachable areas still move prefixes between groups
+  for (auto &key : changed)
+    {
+      ReinstallPrefix (key);
+    }
+  WritePendingPrefixes ();
+  ApplyFibCompression ();
+  if (table != nullptr)
+    {
+      table->EndBulkUpdate ();
+    }
+}
+
+void
+OspfRoutingEngine::ResetPrefixIndex ()
+{
+  ClearPrefixIndex ();
+  m_groups.clear ();
+  m_groupIds.clear ();
+  m_prefixGroup.clear ();
+  m_shadowRib.clear ();
+  m_fibOrder.clear ();
+  m_nTableRoutes = 0;
+  m_discardPrefixes.clear ();
+  m_pendingPrefixes.clear ();
+  m_fibWriteEvent.Cancel ();
+  m_prefixTrie.Clear ();
+  ClearFibCompression ();
+  if (m_app.m_multipathRouting != nullptr)
+    {
+      m_app.m_multipathRouting->Clear ();
+    }
+}
+
+uint32_t
+OspfRoutingEngine::GetNNextHopGroups () const
+{
+  return m_groups.size ();
+}
+
+uint32_t
+OspfRoutingEngine::GetNGroupedPrefixes () const
+{
+  return m_prefixGroup.size ();
+}
+
+uint32_t
+OspfRoutingEngine::GetNCompressedPrefixes () const
+{
+  return m_fibCompressor.GetNPrefixes ();
+}
+
+uint32_t
+OspfRoutingEngine::GetNCompressedEntries () const
+{
+  return m_fibCompressor.GetNEntries ();
+}
+
+uint32_t
+OspfRoutingEngine::GetNPendingPrefixes () const
+{
+  return m_pendingPrefixes.size ();
+}
+
+Time
+OspfRoutingEngine::GetPendingDelay () const
+{
+  if (OspfSpfBatch::IsQueued (this))
+    {
+      return Time (0);
+    }
+  // Deferred originations and leadership or stub-router changes end in LSDB
+  // changes of their own
+  Time delay = m_app.m_lsdb.GetPendingOriginationDelay ();
+  const EventId *events[] = {&m_app.m_updateL1ShortestPathTimeout,
+                             &m_app.m_updateL2ShortestPathTimeout,
+                             &m_fibWriteEvent,
+                             &m_app.m_areaLeaderBeginTimer,
+                             &m_app.m_stubRouterEvent,
+                             &m_app.m_drainEvent};
+  for (const EventId *event : events)
+    {
+      if (event->IsRunning ())
+        {
+          delay = std::min (delay, Simulator::GetDelayLeft (*event));
+        }
+    }
+  return delay;
+}
+
+uint32_t
+OspfRoutingEngine::GetNMaterializedRoutes () const
+{
+  return m_app.m_lazyFib ? m_shadowRib.size () + m_discardPrefixes.size () : 0;
+}
+
+void
+OspfRoutingEngine::DetachLazyFib ()
+{
+  if (m_app.m_multipathRouting != nullptr)
+    {
+      m_app.m_multipathRouting->SetRouteResolver (OspfRoutingProtocol::RouteResolver ());
+    }
+}
+
+void
+OspfRoutingEngine::ClearPrefixIndex ()
+{
+  m_prefixIndexValid = false;
+  m_externalPrefixes.clear ();
+  m_l1PrefixOrigins.clear ();
+  m_l2PrefixOrigins.clear ();
+  m_l1OriginPrefixes.clear ();
+  m_l2OriginPrefixes.clear ();
+}
+
+void
+OspfRoutingEngine::RebuildPrefixIndex ()
+{
+  ClearPrefixIndex ();
+
+  for (auto &[ifIndex, dest, mask, addr, metric] : m_app.m_externalRoutes)
+    {
+      (void)addr;
+      m_externalPrefixes[std::make_pair (dest & mask, mask)] = std::make_pair (ifIndex, metric);
+    }
+  for (auto &[remoteRouterId, lsa] : m_app.m_l1SummaryLsdb)
+    {
+      auto &prefixes = m_l1OriginPrefixes[remoteRouterId];
+      prefixes = CollectL1Prefixes (lsa.second);
+      for (auto &key : prefixes)
+        {
+          m_l1PrefixOrigins[key].insert (remoteRouterId);
+        }
+    }
+  for (auto &[remoteAreaId, lsa] : m_app.m_l2SummaryLsdb)
+    {
+      auto &prefixes = m_l2OriginPrefixes[remoteAreaId];
+      prefixes = CollectL2Prefixes (lsa.second);
+      for (auto &[key, metric] : prefixes)
+        {
+          m_l2PrefixOrigins[key][remoteAreaId] = metric;
+        }
+    }
+  m_prefixIndexValid = true;
+}
+
+std::vector<OspfRoutingEngine::PrefixKey>
+OspfRoutingEngine::CollectL1Prefixes (Ptr<L1SummaryLsa> lsa)
+{
+  std::vector<PrefixKey> prefixes;
+  for (auto route : lsa->GetRoutes ())
+    {
+      auto mask = Ipv4Mask (route.m_mask);
+      auto dest = Ipv4Address (route.m_address);
+      prefixes.emplace_back (dest.CombineMask (mask).Get (), mask.Get ());
+    }
+  std::sort (prefixes.begin (), prefixes.end ());
+  prefixes.erase (std::unique (prefixes.begin (), prefixes.end ()), prefixes.end ());
+  return prefixes;
+}
+
+std::map<OspfRoutingEngine::PrefixKey, uint32_t>
+OspfRoutingEngine::CollectL2Prefixes (Ptr<L2SummaryLsa> lsa)
+{
+  std::map<PrefixKey, uint32_t> prefixes;
+  for (auto route : lsa->GetRoutes ())
+    {
+      auto mask = Ipv4Mask (route.m_mask);
+      auto dest = Ipv4Address (route.m_address);
+      auto key = std::make_pair (dest.CombineMask (mask).Get (), mask.Get ());
+      auto it = prefixes.find (key);
+      if (it == prefixes.end () || route.m_metric < it->second)
+        {
+          prefixes[key] = route.m_metric;
+        }
+    }
+  return prefixes;
+}
+
+bool
+OspfRoutingEngine::GroupKey::operator< (const GroupKey &other) const
+{
+  return std::tie (external, externalRoute, l1Origins, l2Origins) <
+         std::tie (other.external, other.externalRoute, other.l1Origins, other.l2Origins);
+}
+
+OspfRoutingEngine::GroupKey
+OspfRoutingEngine::GetGroupKey (const PrefixKey &key) const
+{
+  GroupKey group;
+  auto extIt = m_externalPrefixes.find (key);
+  if (extIt != m_externalPrefixes.end ())
+    {
+      group.external = true;
+      group.externalRoute = extIt->second;
+    }
+  auto l1It = m_l1PrefixOrigins.find (key);
+  if (l1It != m_l1PrefixOrigins.end ())
+    {
+      group.l1Origins.assign (l1It->second.begin (), l1It->second.end ());
+    }
+  auto l2It = m_l2PrefixOrigins.find (key);
+  if (l2It != m_l2PrefixOrigins.end ())
+    {
+      group.l2Origins.assign (l2It->second.begin (), l2It->second.end ());
+    }
+  return group;
+}
+
+bool
+OspfRoutingEngine::ResolveGroup (const GroupKey &key, PrefixRoute &route) const
+{
+  bool found = false;
+  bool external = false;
+  bool ecmp = m_app.m_maxEcmpPaths > 1;
+
+  // Local routes
+  if (key.external)
+    {
+      route = PrefixRoute{Ipv4Address::GetZero (), key.externalRoute.first,
+                          key.externalRoute.second};
+      if (ecmp)
+        {
+          route.paths = {std::make_pair (Ipv4Address::GetZero (), key.externalRoute.first)};
+        }
+      found = true;
+      external = true;
+    }
+
+  // L1 routes; ties go to the lowest router ID, or are merged with ECMP
+  for (uint32_t remoteRouterId : key.l1Origins)
+    {
+      auto nextHop = m_app.m_l1NextHop.find (remoteRouterId);
+      if (nextHop == m_app.m_l1NextHop.end ())
+        {
+          continue;
+        }
+      if (!found || nextHop->second.metric < route.metric)
+        {
+          route = PrefixRoute{nextHop->second.ipAddress, nextHop->second.ifIndex,
+                              nextHop->second.metric};
+          if (ecmp)
+            {
+              route.paths = GetEcmpPaths (m_l1Paths, remoteRouterId, nextHop->second);
+            }
+          found = true;
+          external = false;
+        }
+      else if (ecmp && !external && nextHop->second.metric == route.metric)
+        {
+          MergePaths (route.paths, GetEcmpPaths (m_l1Paths, remoteRouterId, nextHop->second));
+        }
+    }
+
+  // L2 routes don't compete with L1
+  if (found)
+    {
+      return true;
+    }
+  for (auto &[remoteAreaId, metric] : key.l2Origins)
+    {
+      if (remoteAreaId == m_app.m_areaId)
+        {
+          continue;
+        }
+      auto l2NextHop = m_app.m_l2NextHop.find (remoteAreaId);
+      if (l2NextHop == m_app.m_l2NextHop.end ())
+        {
+          continue;
+        }
+      auto border = m_app.m_nextHopToShortestBorderRouter.find (l2NextHop->second.first);
+      if (border == m_app.m_nextHopToShortestBorderRouter.end ())
+        {
+          continue;
+        }
+      auto nextHop = border->second.second;
+      nextHop.metric += l2NextHop->second.second;
+      if (!found || nextHop.metric + metric < route.metric)
+        {
+          route = PrefixRoute{nextHop.ipAddress, nextHop.ifIndex, nextHop.metric + metric};
+          if (ecmp)
+            {
+              route.paths = GetEcmpPaths (m_borderPaths, l2NextHop->second.first,
+                                          border->second.second);
+            }
+          found = true;
+        }
+      else if (ecmp && nextHop.metric + metric == route.metric)
+        {
+          MergePaths (route.paths, GetEcmpPaths (m_borderPaths, l2NextHop->second.first,
+                                                 border->second.second));
+        }
+    }
+  return found;
+}
+
+uint32_t
+OspfRoutingEngine::AttachPrefix (const PrefixKey &key)
+{
+  GroupKey groupKey = GetGroupKey (key);
+  auto current = m_prefixGroup.find (key);
+  if (current != m_prefixGroup.end ())
+    {
+      const GroupKey &attached = m_groups[current->second].key->first;
+      if (!(attached < groupKey) && !(groupKey < attached))
+        {
+          return current->second;
+        }
+    }
+  DetachPrefix (key);
+  if (!groupKey.external && groupKey.l1Origins.empty () && groupKey.l2Origins.empty ())
+    {
+      return 0;
+    }
+
+  auto [keyIt, inserted] = m_groupIds.emplace (std::move (groupKey), m_nextGroupId);
+  NextHopGroup &group = m_groups[keyIt->second];
+  if (inserted)
+    {
+      m_nextGroupId++;
+      group.key = keyIt;
+      group.found = ResolveGroup (keyIt->first, group.route);
+    }
+  group.prefixes.insert (key);
+  m_prefixGroup[key] = keyIt->second;
+  return keyIt->second;
+}
+
+void
+OspfRoutingEngine::DetachPrefix (const PrefixKey &key)
+{
+  auto it = m_prefixGroup.find (key);
+  if (it == m_prefixGroup.end ())
+    {
+      return;
+    }
+  auto groupIt = m_groups.find (it->second);
+  groupIt->second.prefixes.erase (key);
+  m_prefixGroup.erase (it); // key may live in this entry
+  if (!groupIt->second.prefixes.empty ())
+    {
+      return;
+    }
+  // Its routes are reprogrammed or uninstalled by the caller
+  if (groupIt->second.programmed && m_app.m_multipathRouting != nullptr)
+    {
+      m_app.m_multipathRouting->RemoveNextHopGroup (groupIt->first);
+    }
+  m_groupIds.erase (groupIt->second.key);
+  m_groups.erase (groupIt);
+}
+
+bool
+OspfRoutingEngine::RefreshNextHopGroup (uint32_t id, NextHopGroup &group)
+{
+  PrefixRoute route;
+  bool found = ResolveGroup (group.key->first, route);
+  if (found == group.found && (!found || IsSameRoute (route, group.route)))
+    {
+      return false;
+    }
+  group.found = found;
+  group.route = route;
+  m_app.m_nextHopGroupUpdates++;
+  if (group.programmed)
+    {
+      NotifyFibChanged ();
+      m_app.m_multipathRouting->SetNextHopGroup (id, found ? GetRoutePaths (route) : PathList{},
+                                                 route.metric);
+    }
+  return true;
+}
+
+void
+OspfRoutingEngine::ReinstallPrefix (const PrefixKey &key)
+{
+  if (!UsesLazyFib ())
+    {
+      AttachPrefix (key);
+      QueuePrefix (key);
+      return;
+    }
+
+  uint8_t length = Ipv4Mask (key.second).GetPrefixLength ();
+  bool known = IsKnownPrefix (key);
+  if (known)
+    {
+      m_prefixTrie.Insert (key.first, length, length);
+    }
+  else
+    {
+      m_prefixTrie.Remove (key.first, length);
+    }
+  if (m_prefixGroup.find (key) != m_prefixGroup.end ())
+    {
+      if (known)
+        {
+          AttachPrefix (key);
+        }
+      else
+        {
+          DetachPrefix (key);
+        }
+    }
+  uint32_t network = key.first & key.second;
+  RefreshLazyRoutes (network, network | ~key.second);
+}
+
+bool
+OspfRoutingEngine::IsSameRoute (const PrefixRoute &a, const PrefixRoute &b)
+{
+  return a.gateway == b.gateway && a.ifIndex == b.ifIndex && a.metric == b.metric &&
+         a.paths == b.paths;
+}
+
+bool
+OspfRoutingEngine::UsesNextHopGroups ()
+{
+  // The lazy FIB installs host routes with their own next hops
+  return m_app.m_enableNextHopGroups && !m_app.m_lazyFib && GetMultipathRouting () != nullptr;
+}
+
+bool
+OspfRoutingEngine::IsShadowRibSizeInSync () const
+{
+  // Catches routes someone else added or removed, not ones they replaced
+  if (m_nTableRoutes > 0 && (m_app.m_multipathRouting == nullptr ||
+                             m_app.m_multipathRouting->GetNRoutes () != m_nTableRoutes))
+    {
+      return false;
+    }
+  return m_app.m_routing->GetNRoutes () == m_app.m_boundDevices.GetN () + m_fibOrder.size ();
+}
+
+bool
+OspfRoutingEngine::IsShadowRibInSync () const
+{
+  if (!IsShadowRibSizeInSync ())
+    {
+      return false;
+    }
+  // Static routes follow the bound device routes in installation order.
+  // GetRoute walks the list, so this is O(routes^2).
+  uint32_t index = m_app.m_boundDevices.GetN ();
+  for (const PrefixKey &key : m_fibOrder)
+    {
+      const PrefixRoute &route = m_shadowRib.at (key).route;
+      Ipv4RoutingTableEntry entry = m_app.m_routing->GetRoute (index);
+      if (!entry.IsNetwork () || entry.GetDestNetwork ().Get () != key.first ||
+          entry.GetDestNetworkMask ().Get () != key.second || entry.GetGateway () != route.gateway ||
+          entry.GetInterface () != route.ifIndex ||
+          m_app.m_routing->GetMetric (index) != route.metric)
+        {
+          return false;
+        }
+      index++;
+    }
+
+  // The OSPF table is looked up by prefix
+  for (auto &[key, installed] : m_shadowRib)
+    {
+      bool inStaticTable = installed.position != m_fibOrder.end ();
+      if (inStaticTable && installed.route.paths.empty ())
+        {
+          continue;
+        }
+      PathList expected = GetRoutePaths (installed.route);
+      // The lazy FIB keeps the group only to track invalidations
+      if (installed.group != 0 && !m_app.m_lazyFib)
+        {
+          auto group = m_groups.find (installed.group);
+          expected = group != m_groups.end () && group->second.found
+                         ? GetRoutePaths (group->second.route)
+                         : PathList{};
+        }
+      if (m_app.m_multipathRouting == nullptr ||
+          m_app.m_multipathRouting->GetPaths (Ipv4Address (key.first), Ipv4Mask (key.second)) !=
+              expected)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+OspfRoutingEngine::PathList
+OspfRoutingEngine::GetRoutePaths (const PrefixRoute &route)
+{
+  return route.paths.empty () ? PathList{{route.gateway, route.ifIndex}} : route.paths;
+}
+
+void
+OspfRoutingEngine::ProgramPrefix (const PrefixKey &key, uint32_t group)
+{
+  if (UsesFibCompression ())
+    {
+      CompressPrefix (key, group);
+      return;
+    }
+  SyncDiscardRoute (key);
+
+  // Group routes stay in place while their group is unresolved
+  bool viaGroup = group != 0 && UsesNextHopGroups ();
+  bool wanted = viaGroup || (group != 0 && m_groups[group].found);
+
+  auto it = m_shadowRib.find (key);
+  if (it != m_shadowRib.end ())
+    {
+      if (wanted && (viaGroup ? it->second.group == group
+                              : it->second.group == 0 &&
+                                    IsSameRoute (it->second.route, m_groups[group].route)))
+        {
+          return;
+        }
+      UninstallRoute (it);
+    }
+  if (wanted)
+    {
+      InstallRoute (key, group);
+    }
+}
+
+void
+OspfRoutingEngine::InstallRoute (const PrefixKey &key, uint32_t group)
+{
+  NextHopGroup &nextHops = m_groups[group];
+  const PrefixRoute &route = nextHops.route;
+  m_app.m_prefixRouteUpdates++;
+  NotifyFibChanged ();
+  if (UsesNextHopGroups ())
+    {
+      Ptr<OspfRoutingProtocol> multipath = m_app.m_multipathRouting;
+      if (!nextHops.programmed)
+        {
+          nextHops.programmed = true;
+          multipath->SetNextHopGroup (group, nextHops.found ? GetRoutePaths (route) : PathList{},
+                                      route.metric);
+        }
+      multipath->AddNetworkRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second), group);
+      m_nTableRoutes++;
+      m_shadowRib[key] = InstalledRoute{route, m_fibOrder.end (), group};
+      return;
+    }
+  if (m_app.m_ospfRoutingOnly)
+    {
+      InstallTableRoute (key, route, 0);
+      return;
+    }
+
+  m_app.m_routing->AddNetworkRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second),
+                                      route.gateway, route.ifIndex, route.metric);
+  if (!route.paths.empty ())
+    {
+      Ptr<OspfRoutingProtocol> multipath = GetMultipathRouting ();
+      if (multipath != nullptr)
+        {
+          multipath->AddNetworkRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second),
+                                        route.paths, route.metric);
+        }
+    }
+  m_fibOrder.push_back (key);
+  m_shadowRib[key] = InstalledRoute{route, std::prev (m_fibOrder.end ()), 0};
+}
+
+void
+OspfRoutingEngine::InstallTableRoute (const PrefixKey &key, const PrefixRoute &route,
+                                      uint32_t group)
+{
+  // No FibChanged here: lazy FIB lookups install routes that routing
+  // already decided on
+  m_app.m_multipathRouting->AddNetworkRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second),
+                                               GetRoutePaths (route), route.metric);
+  m_nTableRoutes++;
+  m_shadowRib[key] = InstalledRoute{route, m_fibOrder.end (), group};
+}
+
+OspfRoutingEngine::ShadowRib::iterator
+OspfRoutingEngine::UninstallRoute (ShadowRib::iterator it)
+{
+  m_app.m_prefixRouteUpdates++;
+  NotifyFibChanged ();
+  if (it->second.position == m_fibOrder.end ())
+    {
+      m_app.m_multipathRouting->RemoveNetworkRouteTo (Ipv4Address (it->first.first),
+                                                      Ipv4Mask (it->first.second));
+      m_nTableRoutes--;
+      return m_shadowRib.erase (it);
+    }
+
+  // OSPF routes follow the bound device routes in installation order.
+  // Ipv4StaticRouting only removes by index and keeps its routes in a list,
+  // so finding the index and removing both walk the list: each delete is
+  // O(routes). Routes that only go to the OSPF table (SetOspfRouting) are
+  // removed by prefix instead.
+  uint32_t index = m_app.m_boundDevices.GetN () +
+                   std::distance (m_fibOrder.begin (), it->second.position);
+  m_app.m_routing->RemoveRoute (index);
+  if (!it->second.route.paths.empty () && m_app.m_multipathRouting != nullptr)
+    {
+      m_app.m_multipathRouting->RemoveNetworkRouteTo (Ipv4Address (it->first.first),
+                                                      Ipv4Mask (it->first.second));
+    }
+  m_fibOrder.erase (it->second.position);
+  return m_shadowRib.erase (it);
+}
+
+void
+OspfRoutingEngine::FlushShadowRib ()
+{
+  // Someone else touched the routing table; reinstall from scratch
+  while (m_app.m_routing->GetNRoutes () > m_app.m_boundDevices.GetN ())
+    {
+      m_app.m_routing->RemoveRoute (m_app.m_boundDevices.GetN ());
+    }
+  if (m_app.m_multipathRouting != nullptr)
+    {
+      m_app.m_multipathRouting->Clear ();
+    }
+  for (auto &[id, group] : m_groups)
+    {
+      (void)id;
+      group.programmed = false;
+    }
+  m_shadowRib.clear ();
+  m_fibOrder.clear ();
+  m_nTableRoutes = 0;
+  m_discardPrefixes.clear ();
+  ClearFibCompression ();
+}
+
+uint32_t
+OspfRoutingEngine::GetPrefixPriority (const PrefixKey &key) const
+{
+  // The longest prefix list entry covering the prefix decides
+  uint32_t priority = 0;
+  uint32_t coveringMask = 0;
+  bool listed = false;
+  for (auto &[entry, value] : m_app.m_prefixPriorities)
+    {
+      uint32_t mask = entry.second;
+      if ((key.second & mask) == mask && (key.first & mask) == entry.first &&
+          (!listed || mask > coveringMask))
+        {
+          priority = value;
+          coveringMask = mask;
+          listed = true;
+        }
+    }
+  if (listed)
+    {
+      return priority;
+    }
+  // Then loopbacks and other long prefixes ahead of the rest
+  return Ipv4Mask (key.second).GetPrefixLength () >= m_app.m_highPriorityPrefixLength ? 0 : 1;
+}
+
+void
+OspfRoutingEngine::QueuePrefix (const PrefixKey &key)
+{
+  m_pendingPrefixes.emplace (GetPrefixPriority (key), key);
+}
+
+void
+OspfRoutingEngine::WritePendingPrefixes ()
+{
+  // The compressor only writes aggregates, in ApplyFibCompression
+  uint32_t limit = UsesFibCompression () ? 0 : m_app.m_fibWriteBatchSize;
+  uint64_t first = m_app.m_prefixRouteUpdates;
+  while (!m_pendingPrefixes.empty () &&
+         (limit == 0 || m_app.m_prefixRouteUpdates - first < limit))
+    {
+      PrefixKey key = m_pendingPrefixes.begin ()->second;
+      m_pendingPrefixes.erase (m_pendingPrefixes.begin ());
+      auto it = m_prefixGroup.find (key);
+      ProgramPrefix (key, it == m_prefixGroup.end () ? 0 : it->second);
+    }
+  if (m_pendingPrefixes.empty ())
+    {
+      m_fibWriteEvent.Cancel ();
+    }
+  else if (!m_fibWriteEvent.IsRunning ())
+    {
+      m_fibWriteEvent = Simulator::Schedule (m_app.m_fibWriteInterval,
+                                             &OspfRoutingEngine::ResumePrefixWrites, this);
+    }
+}
+
+void
+OspfRoutingEngine::ResumePrefixWrites ()
+{
+  if (!IsShadowRibSizeInSync ())
+    {
+      // Reprograms and queues everything again
+      UpdateRouting ();
+      return;
+    }
+  m_app.m_fibWriteBatches++;
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (table != nullptr)
+    {
+      table->BeginBulkUpdate ();
+    }
+  WritePendingPrefixes ();
+  if (table != nullptr)
+    {
+      table->EndBulkUpdate ();
+    }
+}
+
+Ptr<OspfRoutingProtocol>
+OspfRoutingEngine::GetMultipathRouting ()
+{
+  if (m_app.m_multipathRouting != nullptr || m_multipathUnavailable)
+    {
+      return m_app.m_multipathRouting;
+    }
+
+  // Ipv4StaticRouting keeps one next hop per route, so ECMP and next-hop
+  // groups need their own table
+  Ptr<Ipv4> ipv4 = m_app.GetNode ()->GetObject<Ipv4> ();
+  Ptr<Ipv4ListRouting> list =
+      ipv4 == nullptr ? nullptr : DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+  if (list == nullptr)
+    {
+      NS_LOG_WARN ("MaxEcmpPaths and EnableNextHopGroups need Ipv4ListRouting; installing "
+                   "single-path static routes only");
+      m_multipathUnavailable = true;
+      return nullptr;
+    }
+  Ptr<OspfRoutingProtocol> multipath = CreateObject<OspfRoutingProtocol> ();
+  multipath->SetHashSeed (m_app.m_routerId.Get ());
+  list->AddRoutingProtocol (multipath, 10);
+  m_app.m_multipathRouting = multipath;
+  return multipath;
+}
+
+bool
+OspfRoutingEngine::UsesLazyFib ()
+{
+  return m_app.m_lazyFib && GetMultipathRouting () != nullptr;
+}
+
+void
+OspfRoutingEngine::UpdateLazyRouting ()
+{
+  RebuildPrefixIndex ();
+  if (!IsShadowRibSizeInSync ())
+    {
+      FlushShadowRib ();
+    }
+  m_app.m_multipathRouting->SetRouteResolver (
+      MakeCallback (&OspfRoutingEngine::MaterializeRoute, this));
+
+  m_prefixTrie.BeginBulkUpdate ();
+  m_prefixTrie.Clear ();
+  auto addPrefix = [this] (const PrefixKey &key) {
+    uint8_t length = Ipv4Mask (key.second).GetPrefixLength ();
+    m_prefixTrie.Insert (key.first, length, length);
+  };
+  for (auto &[key, value] : m_externalPrefixes)
+    {
+      (void)value;
+      addPrefix (key);
+    }
+  for (auto &[key, origins] : m_l1PrefixOrigins)
+    {
+      (void)origins;
+      addPrefix (key);
+    }
+  for (auto &[key, origins] : m_l2PrefixOrigins)
+    {
+      (void)origins;
+      addPrefix (key);
+    }
+  m_prefixTrie.EndBulkUpdate ();
+
+  // Only prefixes that lookups touched are attached
+  for (auto it = m_prefixGroup.begin (); it != m_prefixGroup.end ();)
+    {
+      PrefixKey key = it->first;
+      ++it;
+      if (IsKnownPrefix (key))
+        {
+          AttachPrefix (key);
+        }
+      else
+        {
+          DetachPrefix (key);
+        }
+    }
+  for (auto &[id, group] : m_groups)
+    {
+      RefreshNextHopGroup (id, group);
+    }
+  RefreshLazyRoutes (0, std::numeric_limits<uint32_t>::max ());
+}
+
+bool
+OspfRoutingEngine::MaterializeRoute (Ipv4Address dest)
+{
+  PrefixKey key (dest.Get (), std::numeric_limits<uint32_t>::max ());
+  uint32_t group = ResolveLazyGroup (dest.Get ());
+  if (group == 0 || m_shadowRib.find (key) != m_shadowRib.end () ||
+      m_discardPrefixes.find (key) != m_discardPrefixes.end ())
+    {
+      return false;
+    }
+  m_app.m_lazyFibResolutions++;
+  if (group == DISCARD)
+    {
+      m_app.m_multipathRouting->AddDiscardRouteTo (dest, Ipv4Mask::GetOnes ());
+      m_discardPrefixes.insert (key);
+      return true;
+    }
+  m_app.m_prefixRouteUpdates++;
+  InstallTableRoute (key, m_groups[group].route, group);
+  return true;
+}
+
+uint32_t
+OspfRoutingEngine::ResolveLazyGroup (uint32_t dest)
+{
+  uint32_t best = 0;
+  m_prefixTrie.Lookup (dest, [this, dest, &best] (uint32_t length) {
+    uint32_t mask = PrefixMask (length);
+    PrefixKey key (dest & mask, mask);
+    uint32_t id = AttachPrefix (key);
+    if (id != 0 && m_groups[id].found)
+      {
+        best = id;
+        return true;
+      }
+    if (IsDiscardPrefix (key))
+      {
+        best = DISCARD;
+        return true;
+      }
+    return false;
+  });
+  return best;
+}
+
+bool
+OspfRoutingEngine::IsKnownPrefix (const PrefixKey &key) const
+{
+  return m_externalPrefixes.find (key) != m_externalPrefixes.end () ||
+         m_l1PrefixOrigins.find (key) != m_l1PrefixOrigins.end () ||
+         m_l2PrefixOrigins.find (key) != m_l2PrefixOrigins.end ();
+}
+
+void
+OspfRoutingEngine::RefreshLazyRoutes (uint32_t first, uint32_t last,
+                                      const std::set<uint32_t> *groups)
+{
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  table->BeginBulkUpdate ();
+  for (auto it = m_shadowRib.lower_bound (PrefixKey (first, 0));
+       it != m_shadowRib.end () && it->first.first <= last;)
+    {
+      if (groups != nullptr && groups->find (it->second.group) == groups->end ())
+        {
+          ++it;
+          continue;
+        }
+      uint32_t group = ResolveLazyGroup (it->first.first);
+      if (group != 0 && group != DISCARD && IsSameRoute (it->second.route, m_groups[group].route))
+        {
+          it->second.group = group;
+          ++it;
+          continue;
+        }
+      // Resolved again on its next lookup
+      m_app.m_lazyFibInvalidations++;
+      it = UninstallRoute (it);
+    }
+  // Group changes alone do not move discard prefixes
+  for (auto it = m_discardPrefixes.lower_bound (PrefixKey (first, 0));
+       groups == nullptr && it != m_discardPrefixes.end () && it->first <= last;)
+    {
+      if (ResolveLazyGroup (it->first) == DISCARD)
+        {
+          ++it;
+          continue;
+        }
+      m_app.m_lazyFibInvalidations++;
+      NotifyFibChanged ();
+      table->RemoveDiscardRouteTo (Ipv4Address (it->first), Ipv4Mask::GetOnes ());
+      it = m_discardPrefixes.erase (it);
+    }
+  table->EndBulkUpdate ();
+  // Destinations without a route may resolve now
+  table->FlushFlowCache ();
+}
+
+bool
+OspfRoutingEngine::UsesFibCompression ()
+{
+  // The lazy FIB only installs host routes, there is nothing to aggregate
+  return m_app.m_fibCompression && !m_app.m_lazyFib && GetMultipathRouting () != nullptr;
+}
+
+void
+OspfRoutingEngine::CompressPrefix (const PrefixKey &key, uint32_t group)
+{
+  // The table skips routes through an unresolved group, so they count as
+  // no route; an aggregate could otherwise skip to the wrong shorter prefix
+  bool viaGroup = UsesNextHopGroups ();
+  uint32_t nextHop = OspfFibCompressor::NO_ROUTE;
+  if (group != 0 && m_groups[group].found)
+    {
+      nextHop = viaGroup ? group : GetRouteClass (m_groups[group].route);
+    }
+  else if (IsDiscardPrefix (key))
+    {
+      nextHop = DISCARD;
+    }
+  auto it = m_compressedPrefixes.find (key);
+  uint32_t current = it == m_compressedPrefixes.end () ? OspfFibCompressor::NO_ROUTE : it->second;
+  if (nextHop == current)
+    {
+      return;
+    }
+  if (!viaGroup)
+    {
+      if (nextHop != OspfFibCompressor::NO_ROUTE && nextHop != DISCARD)
+        {
+          m_routeClasses[nextHop].prefixes++;
+        }
+      ReleaseRouteClass (current);
+    }
+  m_fibCompressor.Set (key.first, Ipv4Mask (key.second).GetPrefixLength (), nextHop);
+  if (nextHop == OspfFibCompressor::NO_ROUTE)
+    {
+      m_compressedPrefixes.erase (it);
+    }
+  else
+    {
+      m_compressedPrefixes[key] = nextHop;
+    }
+}
+
+void
+OspfRoutingEngine::ApplyFibCompression ()
+{
+  if (!UsesFibCompression ())
+    {
+      return;
+    }
+  std::vector<OspfFibCompressor::Entry> removed, added;
+  m_fibCompressor.Compress (removed, added);
+  if (removed.empty () && added.empty ())
+    {
+      return;
+    }
+  NotifyFibChanged ();
+
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  table->BeginBulkUpdate ();
+  for (auto &[prefix, length, nextHop] : removed)
+    {
+      if (nextHop == DISCARD)
+        {
+          table->RemoveDiscardRouteTo (Ipv4Address (prefix), Ipv4Mask (PrefixMask (length)));
+          continue;
+        }
+      auto it = m_shadowRib.find (PrefixKey (prefix, PrefixMask (length)));
+      if (it != m_shadowRib.end ())
+        {
+          UninstallRoute (it);
+        }
+    }
+  for (auto &[prefix, length, nextHop] : added)
+    {
+      PrefixKey key (prefix, PrefixMask (length));
+      if (nextHop == DISCARD)
+        {
+          table->AddDiscardRouteTo (Ipv4Address (prefix), Ipv4Mask (key.second));
+        }
+      else if (UsesNextHopGroups ())
+        {
+          InstallRoute (key, nextHop);
+        }
+      else
+        {
+          m_app.m_prefixRouteUpdates++;
+          InstallTableRoute (key, m_routeClasses[nextHop].route, 0);
+        }
+    }
+  table->EndBulkUpdate ();
+}
+
+uint32_t
+OspfRoutingEngine::GetRouteClass (const PrefixRoute &route)
+{
+  auto [it, inserted] = m_routeClassIds.emplace (GetRoutePaths (route), m_nextRouteClass);
+  if (inserted)
+    {
+      m_routeClasses[m_nextRouteClass++].route = route;
+    }
+  return it->second;
+}
+
+void
+OspfRoutingEngine::ReleaseRouteClass (uint32_t id)
+{
+  auto it = m_routeClasses.find (id);
+  if (it == m_routeClasses.end () || --it->second.prefixes > 0)
+    {
+      return;
+    }
+  m_routeClassIds.erase (GetRoutePaths (it->second.route));
+  m_routeClasses.erase (it);
+}
+
+void
+OspfRoutingEngine::ClearFibCompression ()
+{
+  m_fibCompressor.Clear ();
+  m_compressedPrefixes.clear ();
+  m_routeClassIds.clear ();
+  m_routeClasses.clear ();
+}
+
+bool
+OspfRoutingEngine::UsesDiscardRoutes ()
+{
+  return (m_app.m_ospfRoutingOnly || UsesNextHopGroups () || UsesLazyFib () ||
+          UsesFibCompression ()) &&
+         m_app.m_multipathRouting != nullptr;
+}
+
+bool
+OspfRoutingEngine::IsDiscardPrefix (const PrefixKey &key) const
+{
+  auto it = m_l2PrefixOrigins.find (key);
+  return it != m_l2PrefixOrigins.end () && it->second.find (m_app.m_areaId) != it->second.end () &&
+         m_l1PrefixOrigins.find (key) == m_l1PrefixOrigins.end () &&
+         m_externalPrefixes.find (key) == m_externalPrefixes.end ();
+}
+
+void
+OspfRoutingEngine::SyncDiscardRoute (const PrefixKey &key)
+{
+  bool wanted = IsDiscardPrefix (key) && UsesDiscardRoutes ();
+  auto it = m_discardPrefixes.find (key);
+  if (wanted == (it != m_discardPrefixes.end ()))
+    {
+      return;
+    }
+  NotifyFibChanged ();
+  Ptr<OspfRoutingProtocol> table = m_app.m_multipathRouting;
+  if (wanted)
+    {
+      table->AddDiscardRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second));
+      m_discardPrefixes.insert (key);
+    }
+  else
+    {
+      table->RemoveDiscardRouteTo (Ipv4Address (key.first), Ipv4Mask (key.second));
+      m_discardPrefixes.erase (it);
+    }
+}
+
+void
+OspfRoutingEngine::NotifyFibChanged ()
+{
+  m_app.m_fibChangedTrace (m_app.m_routerId);
+}
+
+Time
+OspfRoutingEngine::GetSpfDelay ()
+{
+  if (!m_app.m_enableSpfBackoff)
+    {
+      return m_app.m_shortestPathUpdateDelay;
+    }
+  OspfSpfBackoff::Config config;
+  config.initialDelay = m_app.m_initialSpfDelay;
+  config.shortDelay = m_app.m_shortSpfDelay;
+  config.longDelay = m_app.m_longSpfDelay;
+  config.holdDown = m_app.m_spfHoldDown;
+  config.timeToLearn = m_app.m_spfTimeToLearn;
+  return m_spfBackoff.Trigger (config);
+}
+
+OspfSpfBackoff &
+OspfRoutingEngine::GetSpfBackoff ()
+{
+  return m_spfBackoff;
+}
+
+void
+OspfRoutingEngine::ScheduleUpdateL1ShortestPath ()
+{
+  // Every request counts as a back-off event, even if SPF is pending
+  Time delay = GetSpfDelay ();
+  // Can update at least once in the delay
+  if (m_app.m_updateL1ShortestPathTimeout.IsRunning ())
+    {
+      return;
+    }
+  if (m_app.m_parallelSpfThreads > 0 && !m_app.m_shareSpfGraph)
+    {
+      m_app.m_updateL1ShortestPathTimeout =
+          Simulator::Schedule (delay, &OspfRoutingEngine::QueueL1ShortestPath, this);
+      return;
+    }
+  m_app.m_updateL1ShortestPathTimeout =
+      Simulator::Schedule (delay, &OspfApp::UpdateL1ShortestPath, &m_app);
+}
+
+void
+OspfRoutingEngine::QueueL1ShortestPath ()
+{
+  Time hold = GetOrderedFibHold ();
+  if (hold.IsStrictlyPositive ())
+    {
+      m_app.m_updateL1ShortestPathTimeout =
+          Simulator::Schedule (hold, &OspfRoutingEngine::QueueL1ShortestPath, this);
+      return;
+    }
+  // Run together with every other router due at this time
+  OspfSpfBatch::Add (this, m_app.m_parallelSpfThreads);
+}
+
+void
+OspfRoutingEngine::UpdateL1ShortestPath ()
+{
+  NS_LOG_FUNCTION (&m_app);
+
+  Time hold = GetOrderedFibHold ();
+  if (hold.IsStrictlyPositive ())
+    {
+      m_app.m_updateL1ShortestPathTimeout =
+          Simulator::Schedule (hold, &OspfApp::UpdateL1ShortestPath, &m_app);
+      return;
+    }
+
+  if (m_app.m_shareSpfGraph)
+    {
+      if (ComputeSharedL1Spt ())
+        {
+          m_app.m_spfFullRuns++;
+        }
+      else
+        {
+          m_app.m_spfUnchangedRuns++;
+        }
+      CommitL1Routes ();
+      return;
+    }
+
+  // The tree may no longer match the digest of the last shared run
+  m_sharedL1Graph = nullptr;
+  if (!m_app.m_enableIncrementalSpf)
+    {
+      ComputeFullL1Spt ();
+      m_app.m_spfFullRuns++;
+    }
+  else if (TryIncrementalL1Spt ())
+    {
+      m_app.m_spfIncrementalRuns++;
+    }
+  else
+    {
+      ComputeFullL1Spt ();
+      RebuildL1SptState ();
+      m_app.m_spfFullRuns++;
+    }
+
+  CommitL1Routes ();
+}
+
+void
+OspfRoutingEngine::ResetSpfState ()
+{
+  m_spfValid = false;
+  m_spfZeroMetricEdges = 0;
+  m_spfDistance.clear ();
+  m_spfParent.clear ();
+  m_spfFirstHop.clear ();
+  m_spfChildren.clear ();
+  m_spfLsa.clear ();
+  m_spfOutEdges.clear ();
+  m_spfInEdges.clear ();
+  m_spfAffected.clear ();
+  m_spfImproved.clear ();
+  m_l1Graph.Clear ();
+  m_l1GraphLsa.clear ();
+  m_l2Graph.Clear ();
+  m_l2GraphLsa.clear ();
+  m_sharedL1Graph = nullptr;
+  m_l1Digest = 0;
+  m_l1DigestLsa.clear ();
+  OspfSpfBatch::Remove (this);
+  m_batchRoot = OspfSpfGraph::NO_VERTEX;
+  m_spfBackoff.Reset ();
+  m_ofibValid = false;
+  m_ofibHeld = false;
+  m_ofibEdges.clear ();
+}
+
+void
+OspfRoutingEngine::ComputeFullL1Spt ()
+{
+  uint32_t root = PrepareFullL1Spt ();
+  m_l1Graph.ComputeShortestPaths (root);
+  ExportL1Spt (m_l1Graph, root);
+}
+
+uint32_t
+OspfRoutingEngine::PrepareFullL1Spt ()
+{
+  // Any retained tree is about to be overwritten
+  m_spfValid = false;
+  m_spfDistance.clear ();
+  m_spfParent.clear ();
+  m_spfFirstHop.clear ();
+
+  SyncL1Graph ();
+  return m_l1Graph.AddVertex (m_app.m_routerId.Get ());
+}
+
+bool
+OspfRoutingEngine::PrepareBatchL1Spt ()
+{
+  NS_LOG_FUNCTION (&m_app);
+  if (m_app.m_enableIncrementalSpf && TryIncrementalL1Spt ())
+    {
+      m_batchRoot = OspfSpfGraph::NO_VERTEX;
+      return false;
+    }
+  m_batchRoot = PrepareFullL1Spt ();
+  return true;
+}
+
+void
+OspfRoutingEngine::RunBatchL1Spt ()
+{
+  m_l1Graph.ComputeShortestPaths (m_batchRoot);
+}
+
+void
+OspfRoutingEngine::CommitBatchL1Spt ()
+{
+  if (m_batchRoot == OspfSpfGraph::NO_VERTEX)
+    {
+      m_app.m_spfIncrementalRuns++;
+    }
+  else
+    {
+      ExportL1Spt (m_l1Graph, m_batchRoot);
+      if (m_app.m_enableIncrementalSpf)
+        {
+          RebuildL1SptState ();
+        }
+      m_app.m_spfFullRuns++;
+      m_app.m_spfBatchedRuns++;
+      m_batchRoot = OspfSpfGraph::NO_VERTEX;
+    }
+
+  CommitL1Routes ();
+}
+
+void
+OspfRoutingEngine::CommitL1Routes ()
+{
+  InstallL1NextHops ();
+  UpdateNextHopGroups ();
+  SnapshotOrderedFib ();
+  m_app.NotifyL1RoutesInstalled ();
+}
+
+Time
+OspfRoutingEngine::GetOrderedFibHold ()
+{
+  // A held run goes ahead when it comes due again, whatever changed since
+  if (!m_app.m_enableOrderedFib || !m_ofibValid || m_ofibHeld)
+    {
+      m_ofibHeld = false;
+      return Seconds (0);
+    }
+  uint32_t rank = ComputeOrderedFibRank ();
+  m_app.m_orderedFibLastRank = rank;
+  if (rank == 0)
+    {
+      return Seconds (0);
+    }
+  m_ofibHeld = true;
+  m_app.m_orderedFibHolds++;
+  return m_app.m_orderedFibDelay * static_cast<int64_t> (rank);
+}
+
+void
+OspfRoutingEngine::SnapshotOrderedFib ()
+{
+  if (!m_app.m_enableOrderedFib)
+    {
+      return;
+    }
+  // Re-collect only the Router-LSAs that were replaced
+  for (auto it = m_ofibEdges.begin (); it != m_ofibEdges.end ();)
+    {
+      if (m_app.m_routerLsdb.count (it->first))
+        {
+          ++it;
+        }
+      else
+        {
+          it = m_ofibEdges.erase (it);
+        }
+    }
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      auto &entry = m_ofibEdges[routerId];
+      if (entry.first != lsa.second)
+        {
+          entry.first = lsa.second;
+          entry.second = CollectL1Edges (lsa.second);
+        }
+    }
+  m_ofibValid = true;
+}
+
+uint32_t
+OspfRoutingEngine::ComputeOrderedFibRank ()
+{
+  // <tail, head> -> <committed, current metric>, INFINITE_DISTANCE if absent
+  const uint32_t none = OspfSpfGraph::INFINITE_DISTANCE;
+  std::map<std::pair<uint32_t, uint32_t>, std::pair<uint32_t, uint32_t>> changes;
+  std::unordered_map<uint32_t, EdgeList> current; // routers whose edges changed
+  auto diff = [&changes, none] (uint32_t u, const EdgeList &before, const EdgeList &after) {
+    // Both sorted by neighbor ID
+    auto b = before.begin ();
+    auto a = after.begin ();
+    while (b != before.end () || a != after.end ())
+      {
+        if (a == after.end () || (b != before.end () && b->first < a->first))
+          {
+            changes[{u, b->first}] = {b->second, none};
+            ++b;
+          }
+        else if (b == before.end () || a->first < b->first)
+          {
+            changes[{u, a->first}] = {none, a->second};
+            ++a;
+          }
+        else
+          {
+            if (b->second != a->second)
+              {
+                changes[{u, a->first}] = {b->second, a->second};
+              }
+            ++b;
+            ++a;
+          }
+      }
+  };
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      auto it = m_ofibEdges.find (routerId);
+      if (it != m_ofibEdges.end () && it->second.first == lsa.second)
+        {
+          continue;
+        }
+      EdgeList edges = CollectL1Edges (lsa.second);
+      diff (routerId, it != m_ofibEdges.end () ? it->second.second : EdgeList (), edges);
+      current[routerId] = std::move (edges);
+    }
+  for (auto &[routerId, entry] : m_ofibEdges)
+    {
+      if (!m_app.m_routerLsdb.count (routerId))
+        {
+          diff (routerId, entry.second, EdgeList ());
+          current[routerId];
+        }
+    }
+  if (changes.empty ())
+    {
+      return 0;
+    }
+
+  // Reverse graphs of the committed and current topologies: Dijkstra
+  // from a router then gives every other router's distance to it
+  std::unordered_map<uint32_t, EdgeList> reversedBefore, reversedAfter;
+  for (auto &[u, entry] : m_ofibEdges)
+    {
+      bool changed = current.count (u);
+      for (auto &[v, metric] : entry.second)
+        {
+          reversedBefore[v].emplace_back (u, metric);
+          if (!changed)
+            {
+              reversedAfter[v].emplace_back (u, metric);
+            }
+        }
+    }
+  for (auto &[u, edges] : current)
+    {
+      for (auto &[v, metric] : edges)
+        {
+          reversedAfter[v].emplace_back (u, metric);
+        }
+    }
+  OspfSpfGraph before, after;
+  for (auto &[v, edges] : reversedBefore)
+    {
+      before.SetEdges (v, edges);
+    }
+  for (auto &[v, edges] : reversedAfter)
+    {
+      after.SetEdges (v, edges);
+    }
+
+  // Links that got worse are ranked on the committed topology, links that
+  // got better on the current one
+  uint32_t rank = 0;
+  for (auto &[link, metrics] : changes)
+    {
+      bool worse = metrics.second > metrics.first;
+      OspfSpfGraph &graph = worse ? before : after;
+      uint32_t metric = worse ? metrics.first : metrics.second;
+      rank = std::max (rank, RankOrderedFibChange (graph, link.first, link.second, metric, worse));
+    }
+  return rank;
+}
+
+uint32_t
+OspfRoutingEngine::RankOrderedFibChange (OspfSpfGraph &reversed, uint32_t u, uint32_t v,
+                                         uint32_t metric, bool worse)
+{
+  uint32_t self = reversed.FindVertex (m_app.m_routerId.Get ());
+  uint32_t tail = reversed.FindVertex (u);
+  uint32_t head = reversed.FindVertex (v);
+  if (self == OspfSpfGraph::NO_VERTEX || tail == OspfSpfGraph::NO_VERTEX ||
+      head == OspfSpfGraph::NO_VERTEX)
+    {
+      return 0;
+    }
+
+  const uint32_t none = OspfSpfGraph::INFINITE_DISTANCE;
+  std::vector<uint32_t> toHead (reversed.GetNVertices (), none);
+  reversed.ComputeShortestPaths (head);
+  for (uint32_t x : reversed.GetReached ())
+    {
+      toHead[x] = reversed.GetDistance (x);
+    }
+  reversed.ComputeShortestPaths (tail);
+
+  // Routers with a shortest path to v through u -> v, which their next
+  // hops towards u have too
+  auto affected = [&reversed, &toHead, metric, none] (uint32_t x) {
+    uint32_t distance = reversed.GetDistance (x);
+    return distance != none && uint64_t (distance) + metric == toHead[x];
+  };
+  if (!affected (self))
+    {
+      return 0;
+    }
+
+  // Equal-cost paths all count, whichever next hop a router installed,
+  // so ranks follow every shortest path towards u rather than one tree
+  std::vector<uint32_t> order;
+  for (uint32_t x : reversed.GetReached ())
+    {
+      if (affected (x))
+        {
+          order.push_back (x);
+        }
+    }
+  std::sort (order.begin (), order.end (), [&reversed] (uint32_t a, uint32_t b) {
+    return reversed.GetDistance (a) < reversed.GetDistance (b);
+  });
+  std::vector<uint32_t> rank (reversed.GetNVertices (), 0);
+  // Reversed edges n -> x are links x -> n, n being x's next hop if
+  // x is that much further from u
+  auto forEachUpstream = [&reversed, &affected] (uint32_t n, auto &&f) {
+    for (const OspfSpfGraph::Edge *edge = reversed.EdgesBegin (n); edge != reversed.EdgesEnd (n);
+         ++edge)
+      {
+        if (affected (edge->head) &&
+            reversed.GetDistance (edge->head) == reversed.GetDistance (n) + edge->metric)
+          {
+            f (edge->head);
+          }
+      }
+  };
+  if (worse)
+    {
+      // Bad news spreads towards u: a router updates after every router
+      // that reaches v through it, so its rank is its height above them
+      for (auto it = order.rbegin (); it != order.rend (); ++it)
+        {
+          uint32_t n = *it;
+          forEachUpstream (n, [&rank, n] (uint32_t x) { rank[n] = std::max (rank[n], rank[x] + 1); });
+        }
+    }
+  else
+    {
+      // Good news spreads from u: a router updates after every router on
+      // its paths to u, so its rank is its depth below u
+      for (uint32_t n : order)
+        {
+          forEachUpstream (n, [&rank, n] (uint32_t x) { rank[x] = std::max (rank[x], rank[n] + 1); });
+        }
+    }
+  return rank[self];
+}
+
+bool
+OspfRoutingEngine::ComputeSharedL1Spt ()
+{
+  // The iSPF snapshot is not kept up to date while sharing
+  m_spfValid = false;
+
+  uint64_t digest = SyncL1Digest ();
+  uint32_t rootId = m_app.m_routerId.Get ();
+  if (m_sharedL1Graph != nullptr && m_sharedL1Digest == digest && m_sharedL1Root == rootId)
+    {
+      return false;
+    }
+
+  m_spfDistance.clear ();
+  m_spfParent.clear ();
+  m_spfFirstHop.clear ();
+  bool hit;
+  m_sharedL1Graph = OspfSpfCache::Lookup (
+      digest,
+      [this] (OspfSpfGraph &graph) {
+        for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+          {
+            graph.SetEdges (routerId, CollectL1Edges (lsa.second));
+          }
+      },
+      hit);
+  m_sharedL1Digest = digest;
+  m_sharedL1Root = rootId;
+  if (hit)
+    {
+      m_app.m_spfSharedGraphHits++;
+    }
+
+  // Other routers share the graph, so the root is not added if unknown
+  uint32_t root = m_sharedL1Graph->FindVertex (rootId);
+  if (root == OspfSpfGraph::NO_VERTEX)
+    {
+      m_spfDistance[rootId] = 0;
+      return true;
+    }
+  m_sharedL1Graph->ComputeShortestPaths (root);
+  ExportL1Spt (*m_sharedL1Graph, root);
+  return true;
+}
+
+void
+OspfRoutingEngine::ExportL1Spt (const OspfSpfGraph &graph, uint32_t root)
+{
+  const std::vector<uint32_t> &reached = graph.GetReached ();
+  m_spfDistance.reserve (reached.size ());
+  m_spfParent.reserve (reached.size ());
+  m_spfFirstHop.reserve (reached.size ());
+  for (uint32_t v : reached)
+    {
+      uint32_t id = graph.GetId (v);
+      m_spfDistance[id] = graph.GetDistance (v);
+      if (v != root)
+        {
+          m_spfParent[id] = graph.GetId (graph.GetParent (v));
+          m_spfFirstHop[id] = graph.GetId (graph.GetFirstHop (v));
+        }
+    }
+}
+
+uint64_t
+OspfRoutingEngine::SyncL1Digest ()
+{
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      auto result = m_l1DigestLsa.emplace (routerId, std::make_pair (lsa.second, 0));
+      auto &entry = result.first->second;
+      if (!result.second)
+        {
+          if (entry.first == lsa.second)
+            {
+              continue;
+            }
+          m_l1Digest -= entry.second;
+          entry.first = lsa.second;
+        }
+      entry.second = OspfSpfCache::DigestEdges (routerId, CollectL1Edges (lsa.second));
+      m_l1Digest += entry.second;
+    }
+  if (m_l1DigestLsa.size () == m_app.m_routerLsdb.size ())
+    {
+      return m_l1Digest;
+    }
+  for (auto it = m_l1DigestLsa.begin (); it != m_l1DigestLsa.end ();)
+    {
+      if (m_app.m_routerLsdb.find (it->first) == m_app.m_routerLsdb.end ())
+        {
+          m_l1Digest -= it->second.second;
+          it = m_l1DigestLsa.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  return m_l1Digest;
+}
+
+void
+OspfRoutingEngine::SyncL1Graph ()
+{
+  // Only Router-LSAs that were added, replaced or removed are re-read
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      auto result = m_l1GraphLsa.emplace (routerId, lsa.second);
+      if (!result.second && result.first->second == lsa.second)
+        {
+          continue;
+        }
+      result.first->second = lsa.second;
+      m_l1Graph.SetEdges (routerId, CollectL1Edges (lsa.second));
+    }
+  if (m_l1GraphLsa.size () == m_app.m_routerLsdb.size ())
+    {
+      return;
+    }
+  for (auto it = m_l1GraphLsa.begin (); it != m_l1GraphLsa.end ();)
+    {
+      if (m_app.m_routerLsdb.find (it->first) == m_app.m_routerLsdb.end ())
+        {
+          m_l1Graph.ClearEdges (it->first);
+          it = m_l1GraphLsa.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+OspfRoutingEngine::SyncL2Graph ()
+{
+  for (auto &[areaId, lsa] : m_app.m_areaLsdb)
+    {
+      auto result = m_l2GraphLsa.emplace (areaId, lsa.second);
+      if (!result.second && result.first->second == lsa.second)
+        {
+          continue;
+        }
+      result.first->second = lsa.second;
+      m_l2Graph.SetEdges (areaId, CollectL2Edges (lsa.second));
+    }
+  if (m_l2GraphLsa.size () == m_app.m_areaLsdb.size ())
+    {
+      return;
+    }
+  for (auto it = m_l2GraphLsa.begin (); it != m_l2GraphLsa.end ();)
+    {
+      if (m_app.m_areaLsdb.find (it->first) == m_app.m_areaLsdb.end ())
+        {
+          m_l2Graph.ClearEdges (it->first);
+          it = m_l2GraphLsa.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+OspfRoutingEngine::RebuildL1SptState ()
+{
+  m_spfChildren.clear ();
+  m_spfLsa.clear ();
+  m_spfOutEdges.clear ();
+  m_spfInEdges.clear ();
+  m_spfZeroMetricEdges = 0;
+
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      m_spfLsa[routerId] = lsa.second;
+      EdgeList edges = CollectL1Edges (lsa.second);
+      for (auto &[v, metric] : edges)
+        {
+          m_spfInEdges[v][routerId] = metric;
+          if (metric == 0)
+            {
+              m_spfZeroMetricEdges++;
+            }
+        }
+      m_spfOutEdges[routerId] = std::move (edges);
+    }
+  for (auto &[v, parent] : m_spfParent)
+    {
+      m_spfChildren[parent].insert (v);
+    }
+
+  m_spfRoot = m_app.m_routerId.Get ();
+  m_spfValid = true;
+}
+
+bool
+OspfRoutingEngine::TryIncrementalL1Spt ()
+{
+  if (!m_spfValid || m_spfRoot != m_app.m_routerId.Get ())
+    {
+      return false;
+    }
+
+  // Router-LSAs that were added, replaced or removed since the last run
+  std::vector<uint32_t> changed;
+  for (auto &[routerId, lsa] : m_app.m_routerLsdb)
+    {
+      auto it = m_spfLsa.find (routerId);
+      if (it == m_spfLsa.end () || it->second != lsa.second)
+        {
+          changed.push_back (routerId);
+        }
+    }
+  for (auto &[routerId, lsa] : m_spfLsa)
+    {
+      if (m_app.m_routerLsdb.find (routerId) == m_app.m_routerLsdb.end ())
+        {
+          changed.push_back (routerId);
+        }
+    }
+
+  m_spfAffected.clear ();
+  m_spfImproved.clear ();
+  for (uint32_t u : changed)
+    {
+      EdgeList newEdges;
+      auto lsdbIt = m_app.m_routerLsdb.find (u);
+      if (lsdbIt != m_app.m_routerLsdb.end ())
+        {
+          newEdges = CollectL1Edges (lsdbIt->second.second);
+          m_spfLsa[u] = lsdbIt->second.second;
+        }
+      else
+        {
+          m_spfLsa.erase (u);
+        }
+
+      // Both lists are sorted by neighbor ID
+      EdgeList &oldEdges = m_spfOutEdges[u];
+      size_t i = 0;
+      size_t j = 0;
+      while (i < oldEdges.size () || j < newEdges.size ())
+        {
+          if (j == newEdges.size () ||
+              (i < oldEdges.size () && oldEdges[i].first < newEdges[j].first))
+            {
+              RemoveL1Link (u, oldEdges[i].first, oldEdges[i].second);
+              i++;
+            }
+          else if (i == oldEdges.size () || newEdges[j].first < oldEdges[i].first)
+            {
+              AddL1Link (u, newEdges[j].first, newEdges[j].second);
+              j++;
+            }
+          else
+            {
+              if (oldEdges[i].second != newEdges[j].second)
+                {
+                  ChangeL1LinkMetric (u, oldEdges[i].first, oldEdges[i].second,
+                                      newEdges[j].second);
+                }
+              i++;
+              j++;
+            }
+        }
+      if (newEdges.empty ())
+        {
+          m_spfOutEdges.erase (u);
+        }
+      else
+        {
+          oldEdges = std::move (newEdges);
+        }
+    }
+
+  // Zero-cost links make equal-cost parents ambiguous; let the full run settle it
+  if (m_spfZeroMetricEdges > 0)
+    {
+      return false;
+    }
+
+  RepairL1Spt ();
+  return true;
+}
+
+void
+OspfRoutingEngine::RemoveL1Link (uint32_t u, uint32_t v, uint32_t metric)
+{
+  auto inIt = m_spfInEdges.find (v);
+  if (inIt != m_spfInEdges.end ())
+    {
+      inIt->second.erase (u);
+      if (inIt->second.empty ())
+        {
+          m_spfInEdges.erase (inIt);
+        }
+    }
+  if (metric == 0)
+    {
+      m_spfZeroMetricEdges--;
+    }
+
+  // Only a tree edge can lengthen any shortest path
+  auto pIt = m_spfParent.find (v);
+  if (pIt != m_spfParent.end () && pIt->second == u)
+    {
+      InvalidateL1Subtree (v);
+    }
+}
+
+void
+OspfRoutingEngine::AddL1Link (uint32_t u, uint32_t v, uint32_t metric)
+{
+  m_spfInEdges[v][u] = metric;
+  if (metric == 0)
+    {
+      m_spfZeroMetricEdges++;
+    }
+  m_spfImproved.emplace_back (u, v);
+}
+
+void
+OspfRoutingEngine::ChangeL1LinkMetric (uint32_t u, uint32_t v, uint32_t oldMetric,
+                                       uint32_t newMetric)
+{
+  m_spfInEdges[v][u] = newMetric;
+  if (oldMetric == 0)
+    {
+      m_spfZeroMetricEdges--;
+    }
+  if (newMetric == 0)
+    {
+      m_spfZeroMetricEdges++;
+    }
+
+  if (newMetric > oldMetric)
+    {
+      // Same as losing the link if it carried the shortest path
+      auto pIt = m_spfParent.find (v);
+      if (pIt != m_spfParent.end () && pIt->second == u)
+        {
+          InvalidateL1Subtree (v);
+        }
+    }
+  else
+    {
+      m_spfImproved.emplace_back (u, v);
+    }
+}
+
+void
+OspfRoutingEngine::InvalidateL1Subtree (uint32_t v)
+{
+  std::vector<uint32_t> stack{v};
+  while (!stack.empty ())
+    {
+      uint32_t x = stack.back ();
+      stack.pop_back ();
+      if (!m_spfAffected.insert (x).second)
+        {
+          continue;
+        }
+      auto cIt = m_spfChildren.find (x);
+      if (cIt == m_spfChildren.end ())
+        {
+          continue;
+        }
+      for (uint32_t y : cIt->second)
+        {
+          stack.push_back (y);
+        }
+    }
+}
+
+void
+OspfRoutingEngine::RepairL1Spt ()
+{
+  std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>,
+                      std::greater<std::pair<uint32_t, uint32_t>>>
+      pq;
+
+  // Relax u->v; true if v got a shorter distance
+  auto relax = [this] (uint32_t u, uint32_t v, uint32_t metric) -> bool {
+    uint32_t d = m_spfDistance[u] + metric;
+    auto dIt = m_spfDistance.find (v);
+    if (dIt == m_spfDistance.end () || d < dIt->second)
+      {
+        m_spfDistance[v] = d;
+        SetL1Parent (v, u);
+        return true;
+      }
+    if (d == dIt->second && IsBetterL1Parent (u, v))
+      {
+        SetL1Parent (v, u);
+      }
+    return false;
+  };
+
+  // Detach the invalidated subtrees
+  for (uint32_t x : m_spfAffected)
+    {
+      ClearL1Parent (x);
+      m_spfDistance.erase (x);
+    }
+
+  // Re-attach them through the best in-edge from the intact part of the tree
+  for (uint32_t x : m_spfAffected)
+    {
+      auto inIt = m_spfInEdges.find (x);
+      if (inIt == m_spfInEdges.end ())
+        {
+          continue;
+        }
+      for (auto &[u, metric] : inIt->second)
+        {
+          if (m_spfAffected.count (u) || m_spfDistance.find (u) == m_spfDistance.end ())
+            {
+              continue;
+            }
+          relax (u, x, metric);
+        }
+      auto dIt = m_spfDistance.find (x);
+      if (dIt != m_spfDistance.end ())
+        {
+          pq.emplace (dIt->second, x);
+        }
+    }
+
+  // Added links and lowered metrics
+  for (auto &[u, v] : m_spfImproved)
+    {
+      if (m_spfAffected.count (u) || m_spfDistance.find (u) == m_spfDistance.end ())
+        {
+          continue;
+        }
+      auto inIt = m_spfInEdges.find (v);
+      if (inIt == m_spfInEdges.end ())
+        {
+          continue;
+        }
+      auto eIt = inIt->second.find (u);
+      if (eIt != inIt->second.end () && relax (u, v, eIt->second))
+        {
+          pq.emplace (m_spfDistance[v], v);
+        }
+    }
+
+  // Propagate from every router whose distance changed
+  while (!pq.empty ())
+    {
+      auto [w, u] = pq.top ();
+      pq.pop ();
+      auto dIt = m_spfDistance.find (u);
+      if (dIt == m_spfDistance.end () || dIt->second != w)
+        continue;
+      auto outIt = m_spfOutEdges.find (u);
+      if (outIt == m_spfOutEdges.end ())
+        continue;
+      for (auto &[v, metric] : outIt->second)
+        {
+          if (relax (u, v, metric))
+            {
+              pq.emplace (m_spfDistance[v], v);
+            }
+        }
+    }
+
+  m_spfAffected.clear ();
+  m_spfImproved.clear ();
+}
+
+void
+OspfRoutingEngine::SetL1Parent (uint32_t v, uint32_t parent)
+{
+  auto pIt = m_spfParent.find (v);
+  if (pIt != m_spfParent.end ())
+    {
+      if (pIt->second == parent)
+        {
+          return;
+        }
+      ClearL1Parent (v);
+    }
+  m_spfParent[v] = parent;
+  m_spfChildren[parent].insert (v);
+  UpdateL1FirstHops (v);
+}
+
+void
+OspfRoutingEngine::ClearL1Parent (uint32_t v)
+{
+  auto pIt = m_spfParent.find (v);
+  if (pIt == m_spfParent.end ())
+    {
+      return;
+    }
+  auto cIt = m_spfChildren.find (pIt->second);
+  if (cIt != m_spfChildren.end ())
+    {
+      cIt->second.erase (v);
+      if (cIt->second.empty ())
+        {
+          m_spfChildren.erase (cIt);
+        }
+    }
+  m_spfParent.erase (pIt);
+  m_spfFirstHop.erase (v);
+}
+
+void
+OspfRoutingEngine::UpdateL1FirstHops (uint32_t v)
+{
+  // Detached subtrees come back one router at a time, so this only walks
+  // routers that stay attached while their ancestor moves
+  std::vector<uint32_t> stack{v};
+  while (!stack.empty ())
+    {
+      uint32_t x = stack.back ();
+      stack.pop_back ();
+      uint32_t parent = m_spfParent.at (x);
+      uint32_t hop = parent == m_spfRoot ? x : m_spfFirstHop.at (parent);
+      auto result = m_spfFirstHop.emplace (x, hop);
+      if (!result.second)
+        {
+          if (result.first->second == hop)
+            {
+              continue;
+            }
+          result.first->second = hop;
+        }
+      auto cIt = m_spfChildren.find (x);
+      if (cIt == m_spfChildren.end ())
+        {
+          continue;
+        }
+      for (uint32_t y : cIt->second)
+        {
+          stack.push_back (y);
+        }
+    }
+}
+
+bool
+OspfRoutingEngine::IsBetterL1Parent (uint32_t candidate, uint32_t v) const
+{
+  // Matches the full run: among equal-cost parents, Dijkstra settles the
+  // lowest <distance, router ID> first
+  auto pIt = m_spfParent.find (v);
+  if (pIt == m_spfParent.end () || pIt->second == candidate)
+    {
+      return false;
+    }
+  auto pdIt = m_spfDistance.find (pIt->second);
+  if (pdIt == m_spfDistance.end ())
+    {
+      return true;
+    }
+  return std::make_pair (m_spfDistance.at (candidate), candidate) <
+         std::make_pair (pdIt->second, pIt->second);
+}
+
+OspfRoutingEngine::EdgeList
+OspfRoutingEngine::CollectL2Edges (Ptr<AreaLsa> lsa)
+{
+  EdgeList edges;
+  for (auto &link : lsa->GetLinks ())
+    {
+      edges.emplace_back (link.m_areaId, link.m_metric);
+    }
+  // Parallel links: only the cheapest one can carry a shortest path
+  std::sort (edges.begin (), edges.end ());
+  edges.erase (std::unique (edges.begin (), edges.end (),
+                            [] (const std::pair<uint32_t, uint32_t> &a,
+                                const std::pair<uint32_t, uint32_t> &b) {
+                              return a.first == b.first;
+                            }),
+               edges.end ());
+  return edges;
+}
+
+OspfRoutingEngine::EdgeList
+OspfRoutingEngine::CollectL1Edges (Ptr<RouterLsa> lsa)
+{
+  EdgeList edges;
+  uint32_t nLinks = lsa->GetNLink ();
+  edges.reserve (nLinks);
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      RouterLink link = lsa->GetLink (i);
+      edges.emplace_back (link.m_linkId, link.m_metric);
+    }
+  // Parallel links: only the cheapest one can carry a shortest path
+  std::sort (edges.begin (), edges.end ());
+  edges.erase (std::unique (edges.begin (), edges.end (),
+                            [] (const std::pair<uint32_t, uint32_t> &a,
+                                const std::pair<uint32_t, uint32_t> &b) {
+                              return a.first == b.first;
+                            }),
+               edges.end ());
+  return edges;
+}
+
+void
+OspfRoutingEngine::InstallL1NextHops ()
+{
+  // Clear existing next-hop data
+  m_app.m_l1NextHop.clear ();
+
+  // The first hop is inherited along the tree, and the adjacency index
+  // resolves it, so every router costs two lookups
+  for (auto &[remoteRouterId, routerLsa] : m_app.m_routerLsdb)
+    {
+      (void)routerLsa;
+      // No reachable path
+      auto hIt = m_spfFirstHop.find (remoteRouterId);
+      if (hIt == m_spfFirstHop.end ())
+        {
+          continue;
+        }
+
+      // Find the next hop's IP and interface index
+      const AdjacencySet *adjacencies = FindAdjacencies (hIt->second);
+      if (adjacencies == nullptr)
+        {
+          NS_LOG_WARN ("No FULL neighbor found for next-hop routerId="
+                       << Ipv4Address (hIt->second) << "; skipping next-hop computation");
+          continue;
+        }
+
+      auto &[ifIndex, ipAddress] = *adjacencies->begin ();
+      m_app.m_l1NextHop[remoteRouterId] =
+          NextHop (ifIndex, ipAddress, m_spfDistance[remoteRouterId]);
+    }
+
+  InstallBorderNextHops ();
+  InstallL1EcmpPaths ();
+  if (m_app.m_enableLfa)
+    {
+      ComputeL1Alternates ();
+    }
+  else
+    {
+      m_app.m_l1BackupNextHop.clear ();
+    }
+}
+
+void
+OspfRoutingEngine::InstallBorderNextHops ()
+{
+  if (m_app.m_enableAreaProxy)
+    {
+      // Getting exit routers
+      m_app.m_nextHopToShortestBorderRouter.clear ();
+      for (auto &[remoteRouterId, lsa] : m_app.m_routerLsdb)
+        {
+          auto links = lsa.second->GetCrossAreaLinks ();
+          // Skip self router
+          if (m_app.m_routerId.Get () == remoteRouterId)
+            {
+              continue;
+            }
+          if (m_app.m_l1NextHop.find (remoteRouterId) == m_app.m_l1NextHop.end ())
+            continue;
+          for (auto link : links)
+            {
+              if (m_app.m_nextHopToShortestBorderRouter.find (link.m_areaId) ==
+                      m_app.m_nextHopToShortestBorderRouter.end () ||
+                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId].second.metric >
+                      m_app.m_l1NextHop[remoteRouterId].metric + link.m_metric)
+                {
+                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId] =
+                      std::make_pair (remoteRouterId, m_app.m_l1NextHop[remoteRouterId]);
+                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId].second.metric += link.m_metric;
+                }
+            }
+        }
+      // Fill nextHopToShortestBorderRouter for itself
+      if (m_app.m_routerLsdb.find (m_app.m_routerId.Get ()) != m_app.m_routerLsdb.end ())
+        {
+          for (uint32_t i = 1; i < m_app.m_ospfInterfaces.size (); i++)
+            {
+              for (auto neighbor : m_app.m_ospfInterfaces[i]->GetNeighbors ())
+                {
+                  if (neighbor->GetState () < OspfNeighbor::TwoWay)
+                    {
+                      continue;
+                    }
+                  if (neighbor->GetArea () != m_app.m_areaId)
+                    {
+                      if (m_app.m_nextHopToShortestBorderRouter.find (neighbor->GetArea ()) ==
+                              m_app.m_nextHopToShortestBorderRouter.end () ||
+                          m_app.m_nextHopToShortestBorderRouter[neighbor->GetArea ()].second.metric >
+                              m_app.m_ospfInterfaces[i]->GetMetric ())
+                        {
+                          m_app.m_nextHopToShortestBorderRouter[neighbor->GetArea ()] =
+                              std::make_pair (m_app.m_routerId.Get (),
+                                              NextHop (i, neighbor->GetIpAddress (),
+                                                       m_app.m_ospfInterfaces[i]->GetMetric ()));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+OspfRoutingEngine::NotifyNeighborState (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor)
 {
+  if (!m_adjacenciesValid)
+    {
+      return;
+    }
+  uint32_t routerId = neighbor->GetRouterId ().Get ();
+  auto adjacency = std::make_pair (ifIndex, neighbor->GetIpAddress ());
+  if (neighbor->GetState () == OspfNeighbor::Full)
+    {
+      m_adjacencies[routerId].insert (adjacency);
+      return;
+    }
+  auto it = m_adjacencies.find (routerId);
+  if (it != m_adjacencies.end ())
+    {
+      it->second.erase (adjacency);
+      if (it->second.empty ())
+        {
+          m_adjacencies.erase (it);
+        }
+    }
 }
 
 void
-OspfRoutingEngine::UpdateRouting ()
+OspfRoutingEngine::ResetAdjacencies ()
 {
-  // Remove old route
-  while (m_app.m_routing->GetNRoutes () > m_app.m_boundDevices.GetN ())
+  m_adjacenciesValid = false;
+  m_adjacencies.clear ();
+}
+
+const OspfRoutingEngine::AdjacencySet *
+OspfRoutingEngine::FindAdjacencies (uint32_t routerId)
+{
+  if (!m_adjacenciesValid)
     {
-      m_app.m_routing->RemoveRoute (m_app.m_boundDevices.GetN ());
+      m_adjacencies.clear ();
+      for (uint32_t i = 1; i < m_app.m_ospfInterfaces.size (); i++)
+        {
+          for (auto n : m_app.m_ospfInterfaces[i]->GetNeighbors ())
+            {
+              if (n->GetState () == OspfNeighbor::Full)
+                {
+                  m_adjacencies[n->GetRouterId ().Get ()].emplace (i, n->GetIpAddress ());
+                }
+            }
+        }
+      m_adjacenciesValid = true;
     }
+  auto it = m_adjacencies.find (routerId);
+  return it == m_adjacencies.end () ? nullptr : &it->second;
+}
 
-  std::map<std::pair<uint32_t, uint32_t>, std::tuple<Ipv4Address, uint32_t, uint32_t>> bestDest,
-      l2BestDest;
-  // Fill in local routes
-  for (auto &[ifIndex, dest, mask, addr, metric] : m_app.m_externalRoutes)
+void
+OspfRoutingEngine::ComputeL1Alternates ()
+{
+  m_app.m_l1BackupNextHop.clear ();
+  m_app.m_lfaDestinations = 0;
+  m_app.m_lfaProtected = 0;
+  m_app.m_lfaNodeProtected = 0;
+
+  // The tree was exported already, so the graph's scratch is free
+  OspfSpfGraph *graph = m_sharedL1Graph.get ();
+  if (graph == nullptr)
+    {
+      SyncL1Graph ();
+      graph = &m_l1Graph;
+    }
+  uint32_t root = m_app.m_routerId.Get ();
+  uint32_t s = graph->FindVertex (root);
+  if (s == OspfSpfGraph::NO_VERTEX)
     {
-      bestDest[std::make_pair (dest, mask)] =
-          std::make_tuple (Ipv4Address::GetZero (), ifIndex, metric);
+      return;
     }
 
-  for (auto &[remoteRouterId, nextHop] : m_app.m_l1NextHop)
+  // Distances from every FULL neighbor the root has a link to
+  FindAdjacencies (root);
+  std::unordered_map<uint32_t, std::vector<uint32_t>> fromNeighbor;
+  for (const OspfSpfGraph::Edge *e = graph->EdgesBegin (s); e != graph->EdgesEnd (s); ++e)
     {
-      if (m_app.m_l1SummaryLsdb.find (remoteRouterId) == m_app.m_l1SummaryLsdb.end ())
+      uint32_t id = graph->GetId (e->head);
+      if (m_adjacencies.find (id) == m_adjacencies.end () || fromNeighbor.count (id))
         {
           continue;
         }
-      for (auto route : m_app.m_l1SummaryLsdb[remoteRouterId].second->GetRoutes ())
+      graph->ComputeShortestPaths (e->head);
+      std::vector<uint32_t> &distance = fromNeighbor[id];
+      distance.assign (graph->GetNVertices (), OspfSpfGraph::INFINITE_DISTANCE);
+      for (uint32_t v : graph->GetReached ())
         {
-          auto mask = Ipv4Mask (route.m_mask);
-          auto dest = Ipv4Address (route.m_address);
-          auto key = std::make_pair (dest.CombineMask (mask).Get (), mask.Get ());
-          if (bestDest.find (key) == bestDest.end () || nextHop.metric < std::get<2> (bestDest[key]))
-            {
-              bestDest[key] =
-                  std::make_tuple (nextHop.ipAddress, nextHop.ifIndex, nextHop.metric);
-            }
+          distance[v] = graph->GetDistance (v);
         }
     }
-  // Fill L1 in the routing table
-  for (auto &[key, value] : bestDest)
-    {
-      auto &[dest, mask] = key;
-      auto &[addr, ifIndex, metric] = value;
-      m_app.m_routing->AddNetworkRouteTo (Ipv4Address (dest), Ipv4Mask (mask), addr, ifIndex, metric);
-    }
 
-  // Fill L2 in the routing table (less priority)
-  for (auto &[remoteAreaId, l2NextHop] : m_app.m_l2NextHop)
+  for (auto &[d, primary] : m_app.m_l1NextHop)
     {
-      if (remoteAreaId == m_app.m_areaId)
-        continue;
-      if (m_app.m_l2SummaryLsdb.find (remoteAreaId) == m_app.m_l2SummaryLsdb.end ())
+      uint32_t dv = graph->FindVertex (d);
+      auto hIt = m_spfFirstHop.find (d);
+      if (d == root || dv == OspfSpfGraph::NO_VERTEX || hIt == m_spfFirstHop.end ())
         {
           continue;
         }
-      auto lsa = m_app.m_l2SummaryLsdb[remoteAreaId].second;
-      auto nextHop = m_app.m_nextHopToShortestBorderRouter[l2NextHop.first].second;
-      nextHop.metric += l2NextHop.second;
-      for (auto route : lsa->GetRoutes ())
+      m_app.m_lfaDestinations++;
+      const uint64_t dSD = m_spfDistance[d];
+      const uint32_t p = hIt->second;
+      const uint32_t pv = graph->FindVertex (p);
+      auto pIt = fromNeighbor.find (p);
+
+      // RFC 5286: N is loop-free for D if dist (N, D) < dist (N, S) + dist (S, D),
+      // and node-protecting if also dist (N, D) < dist (N, P) + dist (P, D).
+      // Best is node-protecting, then cheapest, then lowest router ID.
+      bool found = false;
+      std::tuple<bool, uint64_t, uint32_t> best;
+      NextHop backup;
+      for (auto &[n, distance] : fromNeighbor)
         {
-          auto mask = Ipv4Mask (route.m_mask);
-          auto dest = Ipv4Address (route.m_address);
-          auto key = std::make_pair (dest.CombineMask (mask).Get (), mask.Get ());
-          // Don't compete with L1
-          if (bestDest.find (key) != bestDest.end ())
-            continue;
-          if (l2BestDest.find (key) == l2BestDest.end () ||
-              nextHop.metric + route.m_metric < std::get<2> (l2BestDest[key]))
+          uint64_t dND = distance[dv];
+          if (dND == OspfSpfGraph::INFINITE_DISTANCE)
+            {
+              continue;
+            }
+          bool nodeProtecting = false;
+          if (n != p)
+            {
+              if (dND >= uint64_t (distance[s]) + dSD)
+                {
+                  continue;
+                }
+              nodeProtecting = d != p && pIt != fromNeighbor.end () &&
+                               dND < uint64_t (distance[pv]) + pIt->second[dv];
+            }
+          // A parallel link to the primary neighbor only protects the link
+          for (auto &[ifIndex, ipAddress] : m_adjacencies[n])
             {
-              l2BestDest[key] = std::make_tuple (nextHop.ipAddress, nextHop.ifIndex,
-                                                 nextHop.metric + route.m_metric);
+              if (ifIndex == primary.ifIndex)
+                {
+                  continue;
+                }
+              uint64_t cost = m_app.m_ospfInterfaces[ifIndex]->GetMetric () + dND;
+              auto rank = std::make_tuple (!nodeProtecting, cost, n);
+              if (!found || rank < best)
+                {
+                  found = true;
+                  best = rank;
+                  backup = NextHop (ifIndex, ipAddress, cost);
+                }
             }
         }
-    }
-  // Fill L2 in the routing table
-  for (auto &[key, value] : l2BestDest)
-    {
-      auto &[dest, mask] = key;
-      auto &[addr, ifIndex, metric] = value;
-      m_app.m_routing->AddNetworkRouteTo (Ipv4Address (dest), Ipv4Mask (mask), addr, ifIndex, metric);
+      if (found)
+        {
+          m_app.m_l1BackupNextHop[d] = backup;
+          m_app.m_lfaProtected++;
+          m_app.m_lfaNodeProtected += std::get<0> (best) ? 0 : 1;
+        }
     }
 }
 
 void
-OspfRoutingEngine::ScheduleUpdateL1ShortestPath ()
+OspfRoutingEngine::RepairL1NextHops (uint32_t ifIndex, Ipv4Address neighborIp)
 {
-  // Can update at least once in m_shortestPathUpdateDelay
-  if (m_app.m_updateL1ShortestPathTimeout.IsRunning ())
+  if (!m_app.m_enableLfa)
     {
       return;
     }
-  m_app.m_updateL1ShortestPathTimeout =
-      Simulator::Schedule (m_app.m_shortestPathUpdateDelay, &OspfApp::UpdateL1ShortestPath, &m_app);
+  auto failed = std::make_pair (neighborIp, ifIndex);
+  auto usesFailed = [&failed] (const NextHop &nextHop) {
+    return nextHop.ifIndex == failed.second && nextHop.ipAddress == failed.first;
+  };
+
+  // Equal-cost siblings lose the adjacency but stay usable
+  for (auto *paths : {&m_l1Paths, &m_borderPaths})
+    {
+      for (auto it = paths->begin (); it != paths->end ();)
+        {
+          it->second.erase (std::remove (it->second.begin (), it->second.end (), failed),
+                            it->second.end ());
+          it = it->second.empty () ? paths->erase (it) : std::next (it);
+        }
+    }
+
+  uint32_t repaired = 0;
+  for (auto &[d, nextHop] : m_app.m_l1NextHop)
+    {
+      if (!usesFailed (nextHop))
+        {
+          continue;
+        }
+      auto siblings = m_l1Paths.find (d);
+      auto backup = m_app.m_l1BackupNextHop.find (d);
+      if (siblings != m_l1Paths.end ())
+        {
+          auto &[gateway, sibling] = siblings->second.front ();
+          nextHop = NextHop (sibling, gateway, nextHop.metric);
+        }
+      else if (backup != m_app.m_l1BackupNextHop.end () && !usesFailed (backup->second))
+        {
+          nextHop = backup->second;
+        }
+      else
+        {
+          // Stays in place until SPF, as without LFA
+          continue;
+        }
+      repaired++;
+    }
+  if (repaired == 0)
+    {
+      return;
+    }
+  NS_LOG_INFO ("Adjacency " << neighborIp << " on interface " << ifIndex << " lost, "
+                            << repaired << " routers switched to backup next hops");
+  m_app.m_lfaActivations += repaired;
+  InstallBorderNextHops ();
+  UpdateNextHopGroups ();
 }
 
 void
-OspfRoutingEngine::UpdateL1ShortestPath ()
+OspfRoutingEngine::InstallL1EcmpPaths ()
 {
-  std::unordered_map<uint32_t, uint32_t> distanceTo;
-  std::unordered_map<uint32_t, uint32_t> prevHop;
-  std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>,
-                      std::greater<std::pair<uint32_t, uint32_t>>>
-      pq;
-  NS_LOG_FUNCTION (&m_app);
-
-  // Clear existing next-hop data
-  m_app.m_l1NextHop.clear ();
-
-  // Dijkstra
-  while (!pq.empty ())
+  m_l1Paths.clear ();
+  m_borderPaths.clear ();
+  if (m_app.m_maxEcmpPaths <= 1)
     {
-      pq.pop ();
+      return;
     }
-  distanceTo.clear ();
-  uint32_t u, v, w;
-  pq.emplace (0, m_app.m_routerId.Get ());
-  distanceTo[m_app.m_routerId.Get ()] = 0;
-  while (!pq.empty ())
-    {
-      std::tie (w, u) = pq.top ();
-      pq.pop ();
-      if (m_app.m_routerLsdb.find (u) == m_app.m_routerLsdb.end ())
-        continue;
+  uint32_t root = m_app.m_routerId.Get ();
 
-      for (uint32_t i = 0; i < m_app.m_routerLsdb[u].second->GetNLink (); i++)
+  // Settle order: distance, then tree depth so zero-cost links keep parents first
+  std::unordered_map<uint32_t, uint32_t> depth;
+  depth[root] = 0;
+  std::vector<uint32_t> path;
+  for (auto &[v, distance] : m_spfDistance)
+    {
+      (void)distance;
+      uint32_t x = v;
+      path.clear ();
+      while (depth.find (x) == depth.end ())
         {
-          v = m_app.m_routerLsdb[u].second->GetLink (i).m_linkId;
-          auto metric = m_app.m_routerLsdb[u].second->GetLink (i).m_metric;
-          if (distanceTo.find (v) == distanceTo.end () || w + metric < distanceTo[v])
+          path.push_back (x);
+          auto pIt = m_spfParent.find (x);
+          if (pIt == m_spfParent.end ())
             {
-              distanceTo[v] = w + metric;
-              prevHop[v] = u;
-              pq.emplace (w + metric, v);
+              break;
             }
+          x = pIt->second;
+        }
+      uint32_t d = depth.count (x) ? depth[x] : 0;
+      for (auto it = path.rbegin (); it != path.rend (); ++it)
+        {
+          depth[*it] = ++d;
         }
     }
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> order; // <distance, depth, router ID>
+  order.reserve (m_spfDistance.size ());
+  for (auto &[v, distance] : m_spfDistance)
+    {
+      order.emplace_back (distance, depth[v], v);
+    }
+  std::sort (order.begin (), order.end ());
+  std::unordered_map<uint32_t, uint32_t> rank;
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      rank[std::get<2> (order[i])] = i;
+    }
 
-  for (auto &[remoteRouterId, routerLsa] : m_app.m_routerLsdb)
+  // First-hop routers of every router, pushed along tight links of the DAG
+  std::unordered_map<uint32_t, std::vector<uint32_t>> firstHops;
+  std::vector<uint32_t> merged;
+  for (auto &[distance, level, u] : order)
     {
-      (void)routerLsa;
-      // No reachable path
-      if (prevHop.find (remoteRouterId) == prevHop.end ())
+      (void)level;
+      auto lsdbIt = m_app.m_routerLsdb.find (u);
+      if (lsdbIt == m_app.m_routerLsdb.end ())
         {
           continue;
         }
-
-      // Find the first hop
-      v = remoteRouterId;
-      while (prevHop.find (v) != prevHop.end ())
+      for (auto &[v, metric] : CollectL1Edges (lsdbIt->second.second))
         {
-          if (prevHop[v] == m_app.m_routerId.Get ())
+          auto dIt = m_spfDistance.find (v);
+          if (dIt == m_spfDistance.end () || distance + metric != dIt->second ||
+              rank[v] <= rank[u])
             {
-              break;
+              continue;
             }
-          v = prevHop[v];
+          auto &hops = firstHops[v];
+          const std::vector<uint32_t> own{v};
+          const std::vector<uint32_t> &from = u == root ? own : firstHops[u];
+          merged.clear ();
+          std::set_union (hops.begin (), hops.end (), from.begin (), from.end (),
+                          std::back_inserter (merged));
+          hops.swap (merged);
         }
+    }
 
-      // Find the next hop's IP and interface index
-      uint32_t ifIndex = 0;
-      Ipv4Address ipAddress;
-      for (uint32_t i = 1; i < m_app.m_ospfInterfaces.size (); i++)
+  for (auto &[v, hops] : firstHops)
+    {
+      if (v == root || m_app.m_l1NextHop.find (v) == m_app.m_l1NextHop.end ())
+        {
+          continue;
+        }
+      PathList paths;
+      for (uint32_t h : hops)
         {
-          auto neighbors = m_app.m_ospfInterfaces[i]->GetNeighbors ();
-          for (auto n : neighbors)
+          const AdjacencySet *adjacencies = FindAdjacencies (h);
+          if (adjacencies == nullptr)
+            {
+              continue;
+            }
+          // Cheapest FULL adjacencies to the first-hop router
+          uint32_t best = std::numeric_limits<uint32_t>::max ();
+          PathList cheapest;
+          for (auto &[ifIndex, ipAddress] : *adjacencies)
             {
-              if (n->GetState () < OspfNeighbor::Full)
+              uint32_t metric = m_app.m_ospfInterfaces[ifIndex]->GetMetric ();
+              if (metric < best)
                 {
-                  continue;
+                  best = metric;
+                  cheapest.clear ();
                 }
-              if (n->GetRouterId ().Get () == v)
+              if (metric == best)
                 {
-                  ifIndex = i;
-                  ipAddress = n->GetIpAddress ();
-                  break;
+                  cheapest.emplace_back (ipAddress, ifIndex);
                 }
             }
-          if (ifIndex)
-            break;
+          std::sort (cheapest.begin (), cheapest.end ());
+          MergePaths (paths, cheapest);
         }
-      if (ifIndex == 0)
+      if (!paths.empty ())
         {
-          NS_LOG_WARN ("No FULL neighbor found for next-hop routerId="
-                       << Ipv4Address (v) << "; skipping next-hop computation");
-          continue;
+          m_l1Paths[v] = std::move (paths);
         }
-
-      m_app.m_l1NextHop[remoteRouterId] = NextHop (ifIndex, ipAddress, distanceTo[remoteRouterId]);
     }
 
-  if (m_app.m_enableAreaProxy)
+  // Every border router at the same cost as the shortest one
+  if (!m_app.m_enableAreaProxy)
     {
-      // Getting exit routers
-      m_app.m_nextHopToShortestBorderRouter.clear ();
-      for (auto &[remoteRouterId, lsa] : m_app.m_routerLsdb)
+      return;
+    }
+  for (auto &[remoteRouterId, lsa] : m_app.m_routerLsdb)
+    {
+      auto nextHop = m_app.m_l1NextHop.find (remoteRouterId);
+      if (remoteRouterId == root || nextHop == m_app.m_l1NextHop.end ())
         {
-          auto links = lsa.second->GetCrossAreaLinks ();
-          // Skip self router
-          if (m_app.m_routerId.Get () == remoteRouterId)
+          continue;
+        }
+      for (auto link : lsa.second->GetCrossAreaLinks ())
+        {
+          auto border = m_app.m_nextHopToShortestBorderRouter.find (link.m_areaId);
+          if (border == m_app.m_nextHopToShortestBorderRouter.end ())
             {
               continue;
             }
-          if (m_app.m_l1NextHop.find (remoteRouterId) == m_app.m_l1NextHop.end ())
-            continue;
-          for (auto link : links)
+          NextHop candidate = nextHop->second;
+          candidate.metric += link.m_metric;
+          if (candidate.metric == border->second.second.metric)
             {
-              if (m_app.m_nextHopToShortestBorderRouter.find (link.m_areaId) ==
-                      m_app.m_nextHopToShortestBorderRouter.end () ||
-                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId].second.metric >
-                      m_app.m_l1NextHop[remoteRouterId].metric + link.m_metric)
-                {
-                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId] =
-                      std::make_pair (remoteRouterId, m_app.m_l1NextHop[remoteRouterId]);
-                  m_app.m_nextHopToShortestBorderRouter[link.m_areaId].second.metric += link.m_metric;
-                }
+              MergePaths (m_borderPaths[link.m_areaId],
+                          GetEcmpPaths (m_l1Paths, remoteRouterId, nextHop->second));
             }
         }
-      // Fill nextHopToShortestBorderRouter for itself
-      if (m_app.m_routerLsdb.find (m_app.m_routerId.Get ()) != m_app.m_routerLsdb.end ())
+    }
+  if (m_app.m_routerLsdb.find (root) != m_app.m_routerLsdb.end ())
+    {
+      for (uint32_t i = 1; i < m_app.m_ospfInterfaces.size (); i++)
         {
-          for (uint32_t i = 1; i < m_app.m_ospfInterfaces.size (); i++)
+          for (auto neighbor : m_app.m_ospfInterfaces[i]->GetNeighbors ())
             {
-              for (auto neighbor : m_app.m_ospfInterfaces[i]->GetNeighbors ())
+              if (neighbor->GetState () < OspfNeighbor::TwoWay ||
+                  neighbor->GetArea () == m_app.m_areaId)
                 {
-                  if (neighbor->GetState () < OspfNeighbor::TwoWay)
-                    {
-                      continue;
-                    }
-                  if (neighbor->GetArea () != m_app.m_areaId)
-                    {
-                      if (m_app.m_nextHopToShortestBorderRouter.find (neighbor->GetArea ()) ==
-                              m_app.m_nextHopToShortestBorderRouter.end () ||
-                          m_app.m_nextHopToShortestBorderRouter[neighbor->GetArea ()].second.metric >
-                              m_app.m_ospfInterfaces[i]->GetMetric ())
-                        {
-                          m_app.m_nextHopToShortestBorderRouter[neighbor->GetArea ()] =
-                              std::make_pair (m_app.m_routerId.Get (),
-                                              NextHop (i, neighbor->GetIpAddress (),
-                                                       m_app.m_ospfInterfaces[i]->GetMetric ()));
-                        }
-                    }
+                  continue;
+                }
+              auto border = m_app.m_nextHopToShortestBorderRouter.find (neighbor->GetArea ());
+              if (border != m_app.m_nextHopToShortestBorderRouter.end () &&
+                  border->second.second.metric == m_app.m_ospfInterfaces[i]->GetMetric ())
+                {
+                  MergePaths (m_borderPaths[neighbor->GetArea ()],
+                              PathList{std::make_pair (neighbor->GetIpAddress (), i)});
                 }
             }
         }
     }
-  UpdateRouting ();
+}
+
+OspfRoutingEngine::PathList
+OspfRoutingEngine::GetEcmpPaths (const std::unordered_map<uint32_t, PathList> &paths, uint32_t id,
+                                 const NextHop &primary) const
+{
+  auto it = paths.find (id);
+  if (it != paths.end ())
+    {
+      return it->second;
+    }
+  return PathList{std::make_pair (primary.ipAddress, primary.ifIndex)};
+}
+
+void
+OspfRoutingEngine::MergePaths (PathList &into, const PathList &from) const
+{
+  PathList merged;
+  std::set_union (into.begin (), into.end (), from.begin (), from.end (),
+                  std::back_inserter (merged));
+  if (merged.size () > m_app.m_maxEcmpPaths)
+    {
+      merged.resize (m_app.m_maxEcmpPaths);
+    }
+  into = std::move (merged);
 }
 
 void
 OspfRoutingEngine::ScheduleUpdateL2ShortestPath ()
 {
-  // Can update at least once in m_shortestPathUpdateDelay
+  Time delay = GetSpfDelay ();
+  // Can update at least once in the delay
   if (m_app.m_updateL2ShortestPathTimeout.IsRunning ())
     {
       return;
     }
   m_app.m_updateL2ShortestPathTimeout =
-      Simulator::Schedule (m_app.m_shortestPathUpdateDelay, &OspfApp::UpdateL2ShortestPath, &m_app);
+      Simulator::Schedule (delay, &OspfApp::UpdateL2ShortestPath, &m_app);
 }
 
 void
 OspfRoutingEngine::UpdateL2ShortestPath ()
 {
-  std::unordered_map<uint32_t, uint32_t> distanceTo;
-  std::unordered_map<uint32_t, uint32_t> prevHop;
-  std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>,
-                      std::greater<std::pair<uint32_t, uint32_t>>>
-      pq;
   NS_LOG_FUNCTION (&m_app);
 
   // Clear existing next-hop data
   m_app.m_l2NextHop.clear ();
 
   // Dijkstra
-  while (!pq.empty ())
-    {
-      pq.pop ();
-    }
-  distanceTo.clear ();
-  uint32_t u, v, w;
-  pq.emplace (0, m_app.m_areaId);
-  distanceTo[m_app.m_areaId] = 0;
-  while (!pq.empty ())
-    {
-      std::tie (w, u) = pq.top ();
-      pq.pop ();
-      if (m_app.m_areaLsdb.find (u) == m_app.m_areaLsdb.end ())
-        continue;
-
-      for (uint32_t i = 0; i < m_app.m_areaLsdb[u].second->GetNLink (); i++)
-        {
-          v = m_app.m_areaLsdb[u].second->GetLink (i).m_areaId;
-          auto metric = m_app.m_areaLsdb[u].second->GetLink (i).m_metric;
-          if (distanceTo.find (v) == distanceTo.end () || w + metric < distanceTo[v])
-            {
-              distanceTo[v] = w + metric;
-              prevHop[v] = u;
-              pq.emplace (w + metric, v);
-            }
-        }
-    }
+  SyncL2Graph ();
+  uint32_t root = m_l2Graph.AddVertex (m_app.m_areaId);
+  m_l2Graph.ComputeShortestPaths (root);
 
   // Find the shortest paths and the next hops
   for (auto &[remoteAreaId, areaLsa] : m_app.m_areaLsdb)
     {
-      (void)areaLsa;
       // No reachable path
-      if (prevHop.find (remoteAreaId) == prevHop.end ())
+      uint32_t v = m_l2Graph.FindVertex (remoteAreaId);
+      if (v == OspfSpfGraph::NO_VERTEX || v == root ||
+          m_l2Graph.GetParent (v) == OspfSpfGraph::NO_VERTEX)
         {
           continue;
         }
 
       // Find the first hop
-      v = remoteAreaId;
-      while (prevHop.find (v) != prevHop.end ())
+      uint32_t hop = v;
+      while (m_l2Graph.GetParent (hop) != root)
         {
-          if (prevHop[v] == m_app.m_areaId)
-            {
-              break;
-            }
-          v = prevHop[v];
+          hop = m_l2Graph.GetParent (hop);
         }
 
       // Fill in the next hop and prefixes data
-      for (uint32_t i = 0; i < m_app.m_areaLsdb[remoteAreaId].second->GetNLink (); i++)
+      if (areaLsa.second->GetNLink () > 0)
         {
-          m_app.m_l2NextHop[remoteAreaId] = std::make_pair (v, distanceTo[remoteAreaId]);
+          m_app.m_l2NextHop[remoteAreaId] =
+              std::make_pair (m_l2Graph.GetId (hop), m_l2Graph.GetDistance (v));
         }
     }
-  UpdateRouting ();
+  UpdateNextHopGroups ();
 }
 
 } // namespace ns3
@@ -3,23 +3,407 @@
 #ifndef OSPF_APP_ROUTING_ENGINE_H
 #define OSPF_APP_ROUTING_ENGINE_H
 
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ospf-fib-compressor.h"
+#include "ospf-lpm-trie.h"
+#include "ospf-spf-backoff.h"
+#include "ospf-spf-graph.h"
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace ns3 {
 
 class OspfApp;
+class RouterLsa;
+class L1SummaryLsa;
+class L2SummaryLsa;
+class AreaLsa;
+class NextHop;
+class OspfNeighbor;
+class OspfRoutingProtocol;
 
 class OspfRoutingEngine
 {
 public:
   explicit OspfRoutingEngine (OspfApp &app);
+  ~OspfRoutingEngine ();
 
   void UpdateRouting ();
   void ScheduleUpdateL1ShortestPath ();
   void UpdateL1ShortestPath ();
   void ScheduleUpdateL2ShortestPath ();
   void UpdateL2ShortestPath ();
+  // Back-off shared by both schedulers (EnableSpfBackoff)
+  OspfSpfBackoff &GetSpfBackoff ();
+
+  // Partial route calculation: re-resolve only the prefixes whose
+  // advertisement changed in one originator's summary LSA.
+  void UpdateL1SummaryRoutes (uint32_t routerId);
+  void UpdateL2SummaryRoutes (uint32_t areaId);
+
+  // Drop the retained L1 shortest-path tree; the next run is a full SPF.
+  // Also cancels a batched run and returns the back-off to QUIET.
+  void ResetSpfState ();
+  // Drop the prefix index, next-hop groups and shadow RIB; the next route
+  // update is a full rebuild. Call after the routing table was flushed
+  // behind our back.
+  void ResetPrefixIndex ();
+  uint32_t GetNNextHopGroups () const;
+  uint32_t GetNGroupedPrefixes () const;
+  // Host routes the lazy FIB holds
+  uint32_t GetNMaterializedRoutes () const;
+  // Stop the OSPF table from calling back into the lazy FIB
+  void DetachLazyFib ();
+  // Prefixes fed to the FIB compressor and the entries it installed
+  uint32_t GetNCompressedPrefixes () const;
+  uint32_t GetNCompressedEntries () const;
+  // Prefixes waiting for a later FIB write batch (FibWriteBatchSize)
+  uint32_t GetNPendingPrefixes () const;
+  // Time to the first scheduled SPF run, FIB write batch, deferred LSA
+  // origination or area leader, stub router or drain event, Time::Max () if
+  // there is none
+  Time GetPendingDelay () const;
+  // Every installed route matches the shadow RIB; O(routes^2), for tests
+  bool IsShadowRibInSync () const;
+
+  // Local repair after losing an adjacency (EnableLfa): routes through it
+  // move to an equal-cost sibling or their loop-free alternate right away,
+  // ahead of flooding and SPF.
+  void RepairL1NextHops (uint32_t ifIndex, Ipv4Address neighborIp);
+
+  // Adjacency index: FULL neighbors by router ID. Neighbor state transitions
+  // keep it current; after bulk neighbor changes, reset it and it is rebuilt
+  // from the interfaces on next use.
+  void NotifyNeighborState (uint32_t ifIndex, Ptr<OspfNeighbor> neighbor);
+  void ResetAdjacencies ();
 
 private:
+  friend class OspfSpfBatch;
+
+  // Delay of a requested SPF run: fixed, or from the back-off, which
+  // counts the request as an event
+  Time GetSpfDelay ();
+  // Tell FibChanged listeners the routing table was written
+  void NotifyFibChanged ();
+
+  // <neighbor router ID, lowest metric>, sorted by router ID
+  typedef std::vector<std::pair<uint32_t, uint32_t>> EdgeList;
+
+  // Full Dijkstra over the Router LSDB into m_spfDistance/m_spfParent
+  void ComputeFullL1Spt ();
+  // Sync m_l1Graph and clear the tree; returns the root vertex
+  uint32_t PrepareFullL1Spt ();
+
+  // Batched L1 SPF (ParallelSpfThreads): the update timer queues the
+  // router with OspfSpfBatch, which drives the three steps below. Prepare
+  // and commit run on the simulator thread in queue order; the Dijkstra
+  // pass in between only touches m_l1Graph and may run on any thread.
+  // Prepare returns false if an incremental repair already did the work.
+  void QueueL1ShortestPath ();
+  bool PrepareBatchL1Spt ();
+  void RunBatchL1Spt ();
+  void CommitBatchL1Spt ();
+  // Full Dijkstra on a graph shared by every router with the same
+  // Router-LSDB digest. Returns false if neither the digest nor the root
+  // changed since the last run, which leaves the tree as it is.
+  bool ComputeSharedL1Spt ();
+
+  // Ordered FIB updates (EnableOrderedFib, RFC 6976): a due L1 SPF is held
+  // for rank x OrderedFibDelay, where the rank orders this router among
+  // those whose paths cross a link that changed since the last commit.
+  // Returns zero if the run may go ahead, which a held run always does.
+  Time GetOrderedFibHold ();
+  // Snapshot the Router-LSA edges the FIB was just computed from
+  void SnapshotOrderedFib ();
+  uint32_t ComputeOrderedFibRank ();
+  // Rank for one changed link u -> v on a reversed graph, among routers
+  // with a shortest path over it: the height above the furthest of them
+  // for bad news, the depth below u for good news
+  uint32_t RankOrderedFibChange (OspfSpfGraph &reversed, uint32_t u, uint32_t v, uint32_t metric,
+                                 bool worse);
+  void ExportL1Spt (const OspfSpfGraph &graph, uint32_t root);
+  // Patch the Router-LSDB digest with Router-LSAs that changed
+  uint64_t SyncL1Digest ();
+  // Bring the SPF graphs up to date with Router-LSAs and Area-LSAs that
+  // changed since the last run
+  void SyncL1Graph ();
+  void SyncL2Graph ();
+  // Re-snapshot every Router-LSA and rebuild the tree indices for iSPF
+  void RebuildL1SptState ();
+  // Diff changed Router-LSAs against the snapshot and repair the tree.
+  // Returns false if the change cannot be handled incrementally.
+  bool TryIncrementalL1Spt ();
+
+  // Per-change iSPF entry points
+  void RemoveL1Link (uint32_t u, uint32_t v, uint32_t metric);
+  void AddL1Link (uint32_t u, uint32_t v, uint32_t metric);
+  void ChangeL1LinkMetric (uint32_t u, uint32_t v, uint32_t oldMetric, uint32_t newMetric);
+  void InvalidateL1Subtree (uint32_t v);
+  void RepairL1Spt ();
+
+  void SetL1Parent (uint32_t v, uint32_t parent);
+  void ClearL1Parent (uint32_t v);
+  // Re-inherit first hops below a router whose parent changed
+  void UpdateL1FirstHops (uint32_t v);
+  bool IsBetterL1Parent (uint32_t candidate, uint32_t v) const;
+  static EdgeList CollectL1Edges (Ptr<RouterLsa> lsa);
+  static EdgeList CollectL2Edges (Ptr<AreaLsa> lsa);
+
+  // Install the routes of a finished L1 SPF run
+  void CommitL1Routes ();
+  // Derive m_l1NextHop and border router next hops from the current tree
+  void InstallL1NextHops ();
+  // Shortest border router per area, from m_l1NextHop
+  void InstallBorderNextHops ();
+  // Loop-free alternates (RFC 5286) into m_l1BackupNextHop, from one extra
+  // SPF per neighbor
+  void ComputeL1Alternates ();
+
+  // <ifIndex, neighbor IP>, in interface order
+  typedef std::set<std::pair<uint32_t, Ipv4Address>> AdjacencySet;
+  // FULL adjacencies to a router, nullptr if there are none
+  const AdjacencySet *FindAdjacencies (uint32_t routerId);
+
+  // <gateway, ifIndex>, sorted
+  typedef std::vector<std::pair<Ipv4Address, uint32_t>> PathList;
+
+  // Every equal-cost first hop over the shortest-path DAG (MaxEcmpPaths > 1)
+  void InstallL1EcmpPaths ();
+  PathList GetEcmpPaths (const std::unordered_map<uint32_t, PathList> &paths, uint32_t id,
+                         const NextHop &primary) const;
+  // Sorted union, capped at MaxEcmpPaths
+  void MergePaths (PathList &into, const PathList &from) const;
+
+  // <network, mask>
+  typedef std::pair<uint32_t, uint32_t> PrefixKey;
+  struct PrefixRoute
+  {
+    Ipv4Address gateway;
+    uint32_t ifIndex;
+    uint32_t metric;
+    PathList paths; // all equal-cost next hops, only with MaxEcmpPaths > 1
+  };
+  struct InstalledRoute
+  {
+    PrefixRoute route;
+    std::list<PrefixKey>::iterator position; // into m_fibOrder, end if only in the OSPF table
+    uint32_t group; // next-hop group it forwards through, 0 otherwise
+  };
+  typedef std::map<PrefixKey, InstalledRoute> ShadowRib;
+  struct RouteClass
+  {
+    PrefixRoute route;
+    uint32_t prefixes = 0; // compressed prefixes using it
+  };
+
+  // Re-index every external route and summary LSA
+  void RebuildPrefixIndex ();
+  void ClearPrefixIndex ();
+  static std::vector<PrefixKey> CollectL1Prefixes (Ptr<L1SummaryLsa> lsa);
+  static std::map<PrefixKey, uint32_t> CollectL2Prefixes (Ptr<L2SummaryLsa> lsa);
+
+  // Next-hop groups. A prefix resolves from its origins alone, so prefixes
+  // with the same origins share a group that is resolved once. After a
+  // topology change only the groups are re-resolved. With
+  // EnableNextHopGroups the multipath table forwards through the groups
+  // as well, and a changed group is one table write however many prefixes
+  // use it; otherwise its prefixes are rewritten one by one.
+  struct GroupKey
+  {
+    bool external = false;
+    std::pair<uint32_t, uint32_t> externalRoute; // <ifIndex, metric>
+    std::vector<uint32_t> l1Origins; // router IDs
+    std::vector<std::pair<uint32_t, uint32_t>> l2Origins; // <area ID, metric>
+    bool operator< (const GroupKey &other) const;
+  };
+  struct NextHopGroup
+  {
+    std::map<GroupKey, uint32_t>::iterator key; // into m_groupIds
+    bool found = false;
+    PrefixRoute route;
+    std::set<PrefixKey> prefixes;
+    bool programmed = false; // set in the multipath table
+  };
+
+  GroupKey GetGroupKey (const PrefixKey &key) const;
+  // Best route for a group: externals and L1 first, L2 only if neither exists
+  bool ResolveGroup (const GroupKey &key, PrefixRoute &route) const;
+  // Move a prefix to the group of its current origins; 0 if it has none
+  uint32_t AttachPrefix (const PrefixKey &key);
+  void DetachPrefix (const PrefixKey &key);
+  // Re-resolve a group; returns true if its route changed
+  bool RefreshNextHopGroup (uint32_t id, NextHopGroup &group);
+  // Re-resolve every group after a topology change, patching only the
+  // routes of groups that changed
+  void UpdateNextHopGroups ();
+  // Re-attach one prefix and patch the routing table if its route changed
+  void ReinstallPrefix (const PrefixKey &key);
+  static bool IsSameRoute (const PrefixRoute &a, const PrefixRoute &b);
+
+  // Routing table programming through the shadow RIB
+  bool UsesNextHopGroups ();
+  // Route counts match the shadow RIB; cheap enough for every update
+  bool IsShadowRibSizeInSync () const;
+  static PathList GetRoutePaths (const PrefixRoute &route);
+  // Make the table forward a prefix through its group (0 removes it)
+  void ProgramPrefix (const PrefixKey &key, uint32_t group);
+  void InstallRoute (const PrefixKey &key, uint32_t group);
+  // Route with its own next hops, only in the OSPF table
+  void InstallTableRoute (const PrefixKey &key, const PrefixRoute &route, uint32_t group);
+  ShadowRib::iterator UninstallRoute (ShadowRib::iterator it);
+  void FlushShadowRib ();
+
+  // Prioritized installation. Prefixes to program are queued by priority
+  // and written highest priority (lowest value) first, at most
+  // FibWriteBatchSize table writes per batch, FibWriteInterval apart. A
+  // queued prefix is programmed through whatever group it is in by then.
+  uint32_t GetPrefixPriority (const PrefixKey &key) const;
+  void QueuePrefix (const PrefixKey &key);
+  void WritePendingPrefixes ();
+  void ResumePrefixWrites ();
+  // Created on first use and added in front of the static routing table
+  Ptr<OspfRoutingProtocol> GetMultipathRouting ();
+
+  // Lazy FIB (LazyFib). Only the prefix index and the groups that lookups
+  // touched are kept; the OSPF table holds a host route for each
+  // destination looked up, resolved on its first lookup. An update drops
+  // exactly the host routes whose longest matching prefix or group
+  // resolution changed.
+  bool UsesLazyFib ();
+  void UpdateLazyRouting ();
+  // Route resolver of the OSPF table
+  bool MaterializeRoute (Ipv4Address dest);
+  // Group of the longest known prefix covering dest that resolves, DISCARD
+  // if a discard prefix is longer, 0 if neither
+  uint32_t ResolveLazyGroup (uint32_t dest);
+  bool IsKnownPrefix (const PrefixKey &key) const;
+  // Drop the host routes in [first, last] that no longer resolve the same
+  // way; only those through the given groups, if any
+  void RefreshLazyRoutes (uint32_t first, uint32_t last,
+                          const std::set<uint32_t> *groups = nullptr);
+
+  // FIB compression (FibCompression). ProgramPrefix hands prefixes to the
+  // compressor by next-hop class instead: their group with
+  // EnableNextHopGroups, else their next hops, so prefixes that forward
+  // alike across groups can still be aggregated. An aggregate takes the
+  // metric of the first route of its class, which only shows when the
+  // table is printed. The entries go into the OSPF table once the update
+  // is done.
+  bool UsesFibCompression ();
+  void CompressPrefix (const PrefixKey &key, uint32_t group);
+  // Install the entries that changed since the last call
+  void ApplyFibCompression ();
+  // Class of a route's next hops, created unused if new
+  uint32_t GetRouteClass (const PrefixRoute &route);
+  void ReleaseRouteClass (uint32_t id);
+  void ClearFibCompression ();
+
+  // Discard routes. Our own area's L2 Summary-LSA prefixes that nothing in
+  // the area announces as such are aggregates; destinations in their gaps
+  // are dropped instead of leaving through a shorter prefix. Only when the
+  // OSPF table is the whole FIB, since a static route behind it could be
+  // longer than the aggregate. The compressor takes them as a next-hop
+  // class of their own, and the lazy FIB as discarded host routes.
+  static constexpr uint32_t DISCARD = std::numeric_limits<uint32_t>::max ();
+  bool UsesDiscardRoutes ();
+  bool IsDiscardPrefix (const PrefixKey &key) const;
+  // Add or remove the discard route of a prefix to match the index
+  void SyncDiscardRoute (const PrefixKey &key);
+
   OspfApp &m_app;
+  OspfSpfBackoff m_spfBackoff;
+
+  // Dense-index SPF graphs and the LSAs they were built from
+  OspfSpfGraph m_l1Graph;
+  std::unordered_map<uint32_t, Ptr<RouterLsa>> m_l1GraphLsa;
+  OspfSpfGraph m_l2Graph;
+  std::unordered_map<uint32_t, Ptr<AreaLsa>> m_l2GraphLsa;
+
+  // Shared L1 graph (ShareSpfGraph) and the digest it was looked up by
+  std::shared_ptr<OspfSpfGraph> m_sharedL1Graph;
+  uint64_t m_sharedL1Digest = 0;
+  uint32_t m_sharedL1Root = 0;
+  uint64_t m_l1Digest = 0;
+  std::unordered_map<uint32_t, std::pair<Ptr<RouterLsa>, uint64_t>> m_l1DigestLsa;
+
+  // Retained L1 shortest-path tree
+  std::unordered_map<uint32_t, uint32_t> m_spfDistance;
+  std::unordered_map<uint32_t, uint32_t> m_spfParent;
+  std::unordered_map<uint32_t, uint32_t> m_spfFirstHop; // neighbor of the root on the tree path
+  std::unordered_map<uint32_t, std::unordered_set<uint32_t>> m_spfChildren;
+
+  // Batched run in progress: the root, or NO_VERTEX after an iSPF repair
+  uint32_t m_batchRoot = OspfSpfGraph::NO_VERTEX;
+
+  // Graph snapshot the tree was computed from (iSPF only)
+  bool m_spfValid = false;
+  uint32_t m_spfRoot = 0;
+  uint32_t m_spfZeroMetricEdges = 0;
+  std::unordered_map<uint32_t, Ptr<RouterLsa>> m_spfLsa;
+  std::unordered_map<uint32_t, EdgeList> m_spfOutEdges;
+  std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>> m_spfInEdges;
+
+  // Router-LSA edges as of the last committed L1 SPF (EnableOrderedFib)
+  bool m_ofibValid = false;
+  bool m_ofibHeld = false;
+  std::unordered_map<uint32_t, std::pair<Ptr<RouterLsa>, EdgeList>> m_ofibEdges;
+
+  // Pending work for RepairL1Spt
+  std::unordered_set<uint32_t> m_spfAffected;
+  std::vector<std::pair<uint32_t, uint32_t>> m_spfImproved; // <tail, head>
+
+  // Equal-cost first hops, only kept with MaxEcmpPaths > 1
+  std::unordered_map<uint32_t, PathList> m_l1Paths; // per router ID
+  std::unordered_map<uint32_t, PathList> m_borderPaths; // per area ID
+  bool m_multipathUnavailable = false;
+
+  // FULL neighbors by router ID
+  bool m_adjacenciesValid = false;
+  std::unordered_map<uint32_t, AdjacencySet> m_adjacencies;
+
+  // Prefix-to-originator index
+  bool m_prefixIndexValid = false;
+  std::map<PrefixKey, std::pair<uint32_t, uint32_t>> m_externalPrefixes; // <ifIndex, metric>
+  std::map<PrefixKey, std::set<uint32_t>> m_l1PrefixOrigins; // router IDs
+  std::map<PrefixKey, std::map<uint32_t, uint32_t>> m_l2PrefixOrigins; // <area ID, metric>
+  std::unordered_map<uint32_t, std::vector<PrefixKey>> m_l1OriginPrefixes;
+  std::unordered_map<uint32_t, std::map<PrefixKey, uint32_t>> m_l2OriginPrefixes;
+
+  // Next-hop groups by ID, their IDs by key, and each prefix's group
+  std::map<uint32_t, NextHopGroup> m_groups;
+  std::map<GroupKey, uint32_t> m_groupIds;
+  std::map<PrefixKey, uint32_t> m_prefixGroup;
+  uint32_t m_nextGroupId = 1;
+
+  // Shadow RIB: what OSPF last installed, and in which table order
+  ShadowRib m_shadowRib;
+  std::list<PrefixKey> m_fibOrder;
+  uint32_t m_nTableRoutes = 0; // routes only in the OSPF table, not in m_fibOrder
+  std::set<PrefixKey> m_discardPrefixes; // discard routes OSPF installed, not compressed ones
+  std::set<std::pair<uint32_t, PrefixKey>> m_pendingPrefixes; // <priority, prefix>
+  EventId m_fibWriteEvent;
+
+  // Known prefixes, valued by their length (lazy FIB only)
+  OspfLpmTrie m_prefixTrie;
+
+  // Compressor input by prefix, and the next-hop classes it refers to
+  OspfFibCompressor m_fibCompressor;
+  std::map<PrefixKey, uint32_t> m_compressedPrefixes;
+  std::map<PathList, uint32_t> m_routeClassIds;
+  std::unordered_map<uint32_t, RouteClass> m_routeClasses;
+  uint32_t m_nextRouteClass = 1;
 };
 
 } // namespace ns3
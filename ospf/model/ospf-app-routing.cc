@@ -1,113 +1,198 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "ospf-app-private.h"
+#include "ospf-app-routing-engine.h"
 
 namespace ns3 {
 
 void
 OspfApp::UpdateRouting ()
 {
-  while (m_routing->GetNRoutes () > m_boundDevices.GetN ())
-    {
-      m_routing->RemoveRoute (m_boundDevices.GetN ());
-    }
+  m_routingEngine->UpdateRouting ();
+}
 
-  std::map<std::pair<uint32_t, uint32_t>, std::tuple<Ipv4Address, uint32_t, uint32_t>> bestDest,
-      l2BestDest;
+void
+OspfApp::UpdateL1SummaryRoutes (uint32_t routerId)
+{
+  m_routingEngine->UpdateL1SummaryRoutes (routerId);
+}
 
-  // Fill in local routes
-  for (auto &[ifIndex, dest, mask, addr, metric] : m_externalRoutes)
-    {
-      bestDest[std::make_pair (dest, mask)] =
-          std::make_tuple (Ipv4Address::GetZero (), ifIndex, metric);
-    }
+void
+OspfApp::UpdateL2SummaryRoutes (uint32_t areaId)
+{
+  m_routingEngine->UpdateL2SummaryRoutes (areaId);
+}
 
-  // Fill L1 routes
-  for (auto &[remoteRouterId, nextHop] : m_l1NextHop)
-    {
-      if (m_l1SummaryLsdb.find (remoteRouterId) == m_l1SummaryLsdb.end ())
-        {
-          continue;
-        }
-      for (auto route : m_l1SummaryLsdb[remoteRouterId].second->GetRoutes ())
-        {
-          auto mask = Ipv4Mask (route.m_mask);
-          auto dest = Ipv4Address (route.m_address);
-          auto key = std::make_pair (dest.CombineMask (mask).Get (), mask.Get ());
-          if (bestDest.find (key) == bestDest.end () ||
-              nextHop.metric < std::get<2> (bestDest[key]))
-            {
-              bestDest[key] = std::make_tuple (nextHop.ipAddress, nextHop.ifIndex, nextHop.metric);
-            }
-        }
-    }
+void
+OspfApp::ScheduleUpdateL1ShortestPath ()
+{
+  m_routingEngine->ScheduleUpdateL1ShortestPath ();
+}
 
-  // Install L1 routes
-  for (auto &[key, value] : bestDest)
-    {
-      auto &[dest, mask] = key;
-      auto &[addr, ifIndex, metric] = value;
-      m_routing->AddNetworkRouteTo (Ipv4Address (dest), Ipv4Mask (mask), addr, ifIndex, metric);
-    }
+void
+OspfApp::UpdateL1ShortestPath ()
+{
+  m_routingEngine->UpdateL1ShortestPath ();
+}
 
-  // Fill L2 routes (lower priority than L1)
-  for (auto &[remoteAreaId, l2NextHop] : m_l2NextHop)
-    {
-      if (remoteAreaId == m_areaId)
-        continue;
-      if (m_l2SummaryLsdb.find (remoteAreaId) == m_l2SummaryLsdb.end ())
-        {
-          continue;
-        }
-      auto nextHop = m_nextHopToShortestBorderRouter[l2NextHop.first].second;
-      nextHop.metric += l2NextHop.second;
-      
-      for (auto route : m_l2SummaryLsdb[remoteAreaId].second->GetRoutes ())
-        {
-          auto mask = Ipv4Mask (route.m_mask);
-          auto dest = Ipv4Address (route.m_address);
-          auto key = std::make_pair (dest.CombineMask (mask).Get (), mask.Get ());
-          
-          if (bestDest.find (key) != bestDest.end ())
-            continue;
-          if (l2BestDest.find (key) == l2BestDest.end () ||
-              nextHop.metric + route.m_metric < std::get<2> (l2BestDest[key]))
-            {
-              l2BestDest[key] = std::make_tuple (nextHop.ipAddress, nextHop.ifIndex,
-                                                 nextHop.metric + route.m_metric);
-            }
-        }
-    }
+void
+OspfApp::ScheduleUpdateL2ShortestPath ()
+{
+  m_routingEngine->ScheduleUpdateL2ShortestPath ();
+}
 
-  // Install L2 routes
-  for (auto &[key, value] : l2BestDest)
-    {
-      auto &[dest, mask] = key;
-      auto &[addr, ifIndex, metric] = value;
-      m_routing->AddNetworkRouteTo (Ipv4Address (dest), Ipv4Mask (mask), addr, ifIndex, metric);
-    }
+void
+OspfApp::UpdateL2ShortestPath ()
+{
+  m_routingEngine->UpdateL2ShortestPath ();
+}
+
+OspfApp::SpfStats
+OspfApp::GetSpfStats () const
+{
+  SpfStats stats;
+  stats.fullRuns = m_spfFullRuns;
+  stats.incrementalRuns = m_spfIncrementalRuns;
+  stats.sharedGraphHits = m_spfSharedGraphHits;
+  stats.unchangedRuns = m_spfUnchangedRuns;
+  stats.batchedRuns = m_spfBatchedRuns;
+  return stats;
 }
 
 void
-OspfApp::ScheduleUpdateL1ShortestPath ()
+OspfApp::ResetSpfStats ()
 {
-  if (m_updateL1ShortestPathTimeout.IsRunning ())
-    {
-      return;
-    }
-  m_updateL1ShortestPathTimeout =
-      Simulator::Schedule (m_shortestPathUpdateDelay, &OspfApp::UpdateL1ShortestPath, this);
+  m_spfFullRuns = 0;
+  m_spfIncrementalRuns = 0;
+  m_spfSharedGraphHits = 0;
+  m_spfUnchangedRuns = 0;
+  m_spfBatchedRuns = 0;
+}
+
+OspfApp::SpfBackoffStats
+OspfApp::GetSpfBackoffStats () const
+{
+  const OspfSpfBackoff::Stats &backoff = m_routingEngine->GetSpfBackoff ().GetStats ();
+  SpfBackoffStats stats;
+  stats.events = backoff.events;
+  stats.quietToShortWait = backoff.quietToShortWait;
+  stats.shortToLongWait = backoff.shortToLongWait;
+  stats.shortWaitToQuiet = backoff.shortWaitToQuiet;
+  stats.longWaitToQuiet = backoff.longWaitToQuiet;
+  return stats;
 }
 
 void
-OspfApp::ScheduleUpdateL2ShortestPath ()
+OspfApp::ResetSpfBackoffStats ()
+{
+  m_routingEngine->GetSpfBackoff ().ResetStats ();
+}
+
+OspfApp::LfaStats
+OspfApp::GetLfaStats () const
+{
+  LfaStats stats;
+  stats.destinations = m_lfaDestinations;
+  stats.protectedDestinations = m_lfaProtected;
+  stats.nodeProtected = m_lfaNodeProtected;
+  stats.activations = m_lfaActivations;
+  return stats;
+}
+
+void
+OspfApp::ResetLfaStats ()
+{
+  m_lfaActivations = 0;
+}
+
+OspfApp::OrderedFibStats
+OspfApp::GetOrderedFibStats () const
+{
+  OrderedFibStats stats;
+  stats.holds = m_orderedFibHolds;
+  stats.lastRank = m_orderedFibLastRank;
+  return stats;
+}
+
+void
+OspfApp::ResetOrderedFibStats ()
+{
+  m_orderedFibHolds = 0;
+}
+
+OspfApp::NextHopGroupStats
+OspfApp::GetNextHopGroupStats () const
+{
+  NextHopGroupStats stats;
+  stats.groups = m_routingEngine->GetNNextHopGroups ();
+  stats.prefixes = m_routingEngine->GetNGroupedPrefixes ();
+  stats.groupUpdates = m_nextHopGroupUpdates;
+  stats.routeUpdates = m_prefixRouteUpdates;
+  return stats;
+}
+
+void
+OspfApp::ResetNextHopGroupStats ()
+{
+  m_nextHopGroupUpdates = 0;
+  m_prefixRouteUpdates = 0;
+}
+
+OspfApp::LazyFibStats
+OspfApp::GetLazyFibStats () const
+{
+  LazyFibStats stats;
+  stats.materialized = m_routingEngine->GetNMaterializedRoutes ();
+  stats.resolutions = m_lazyFibResolutions;
+  stats.invalidations = m_lazyFibInvalidations;
+  return stats;
+}
+
+void
+OspfApp::ResetLazyFibStats ()
+{
+  m_lazyFibResolutions = 0;
+  m_lazyFibInvalidations = 0;
+}
+
+OspfApp::FibWriteStats
+OspfApp::GetFibWriteStats () const
+{
+  FibWriteStats stats;
+  stats.pending = m_routingEngine->GetNPendingPrefixes ();
+  stats.deferredBatches = m_fibWriteBatches;
+  return stats;
+}
+
+bool
+OspfApp::IsRoutingTableInSync () const
+{
+  return m_routingEngine->IsShadowRibInSync ();
+}
+
+Time
+OspfApp::GetRoutingDelayLeft () const
+{
+  return m_routingEngine->GetPendingDelay ();
+}
+
+void
+OspfApp::ResetFibWriteStats ()
+{
+  m_fibWriteBatches = 0;
+}
+
+OspfApp::FibCompressionStats
+OspfApp::GetFibCompressionStats () const
 {
-  if (m_updateL2ShortestPathTimeout.IsRunning ())
+  FibCompressionStats stats;
+  stats.prefixes = m_routingEngine->GetNCompressedPrefixes ();
+  stats.entries = m_routingEngine->GetNCompressedEntries ();
+  if (stats.prefixes > 0)
     {
-      return;
+      stats.ratio = static_cast<double> (stats.entries) / stats.prefixes;
     }
-  m_updateL2ShortestPathTimeout =
-      Simulator::Schedule (m_shortestPathUpdateDelay, &OspfApp::UpdateL2ShortestPath, this);
+  return stats;
 }
 
 } // namespace ns3
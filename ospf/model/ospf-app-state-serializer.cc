@@ -2,7 +2,9 @@
 
 #include "ospf-app-state-serializer.h"
 
+#include "ospf-app-lsa-aging.h"
 #include "ospf-app-private.h"
+#include "ospf-app-routing-engine.h"
 
 namespace ns3 {
 
@@ -19,6 +21,20 @@ TryReadNtohU32 (Buffer::Iterator &it, uint32_t &out)
   return true;
 }
 
+// Like std::map::insert over a range
+template <typename T>
+void
+CommitStaged (OspfLsdbView<T> &lsdb, const std::map<uint32_t, std::pair<LsaHeader, Ptr<T>>> &staged)
+{
+  for (auto &[lsId, lsa] : staged)
+    {
+      if (!lsdb.count (lsId))
+        {
+          lsdb[lsId] = lsa;
+        }
+    }
+}
+
 } // namespace
 
 OspfStateSerializer::OspfStateSerializer (OspfApp &app)
@@ -318,11 +334,21 @@ OspfStateSerializer::ImportLsdb (std::filesystem::path dirName, std::string file
     }
 
   // Commit staged state.
-  m_app.m_routerLsdb.insert (routerLsdb.begin (), routerLsdb.end ());
-  m_app.m_l1SummaryLsdb.insert (l1SummaryLsdb.begin (), l1SummaryLsdb.end ());
-  m_app.m_areaLsdb.insert (areaLsdb.begin (), areaLsdb.end ());
-  m_app.m_l2SummaryLsdb.insert (l2SummaryLsdb.begin (), l2SummaryLsdb.end ());
-  m_app.m_seqNumbers.insert (seqNumbers.begin (), seqNumbers.end ());
+  // Entries already present are kept
+  CommitStaged (m_app.m_routerLsdb, routerLsdb);
+  CommitStaged (m_app.m_l1SummaryLsdb, l1SummaryLsdb);
+  CommitStaged (m_app.m_areaLsdb, areaLsdb);
+  CommitStaged (m_app.m_l2SummaryLsdb, l2SummaryLsdb);
+  m_app.m_aging->TrackAll ();
+  m_app.NotifyLsdbChanged ();
+  for (auto &[lsaKey, seqNum] : seqNumbers)
+    {
+      if (m_app.m_lsdb.GetSeqNum (lsaKey) == 0)
+        {
+          m_app.m_lsdb.SetSeqNum (lsaKey, seqNum);
+        }
+    }
+  m_app.m_routingEngine->ResetPrefixIndex ();
 
   std::cout << "Imported " << lsUpdate->GetNLsa () << " LSAs : " << data.size () << " bytes from "
             << fullname << std::endl;
@@ -366,6 +392,8 @@ OspfStateSerializer::ImportNeighbors (std::filesystem::path dirName, std::string
       return;
     }
 
+  // Imported neighbors are FULL; the adjacency index is rebuilt on next use
+  m_app.m_routingEngine->ResetAdjacencies ();
   uint32_t nNeighbors = 0;
   uint32_t routerId = 0;
   uint32_t ipAddress = 0;
@@ -45,6 +45,7 @@
 #include "ospf-app-area-leader-controller.h"
 #include "ospf-app-io-component.h"
 #include "ospf-app-logging.h"
+#include "ospf-app-lsa-aging.h"
 #include "ospf-app-lsa-processor.h"
 #include "ospf-app-neighbor-fsm.h"
 #include "ospf-app-rng.h"
@@ -105,13 +106,113 @@ OspfApp::GetTypeId (void)
           .AddAttribute ("EnableAreaProxy", "Enable area proxy for area routing",
                          BooleanValue (true), MakeBooleanAccessor (&OspfApp::m_enableAreaProxy),
                          MakeBooleanChecker ())
+          .AddAttribute ("AutoSummarize",
+                         "Aggregate the L2 Summary-LSA outside of the area ranges",
+                         BooleanValue (false), MakeBooleanAccessor (&OspfApp::m_autoSummarize),
+                         MakeBooleanChecker ())
           .AddAttribute ("ShortestPathUpdateDelay", "Delay to re-calculate the shortest path",
                          TimeValue (Seconds (5)),
                          MakeTimeAccessor (&OspfApp::m_shortestPathUpdateDelay), MakeTimeChecker ())
+          .AddAttribute ("EnableSpfBackoff",
+                         "Delay SPF with the RFC 8405 back-off instead of ShortestPathUpdateDelay",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_enableSpfBackoff),
+                         MakeBooleanChecker ())
+          .AddAttribute ("InitialSpfDelay",
+                         "SPF delay for the first event after a quiet period (RFC 8405 INITIAL_SPF_DELAY)",
+                         TimeValue (MilliSeconds (50)),
+                         MakeTimeAccessor (&OspfApp::m_initialSpfDelay), MakeTimeChecker ())
+          .AddAttribute ("ShortSpfDelay",
+                         "SPF delay while still learning the extent of a change (RFC 8405 SHORT_SPF_DELAY)",
+                         TimeValue (MilliSeconds (200)),
+                         MakeTimeAccessor (&OspfApp::m_shortSpfDelay), MakeTimeChecker ())
+          .AddAttribute ("LongSpfDelay",
+                         "SPF delay once events kept coming past TimeToLearn (RFC 8405 LONG_SPF_DELAY)",
+                         TimeValue (Seconds (5)),
+                         MakeTimeAccessor (&OspfApp::m_longSpfDelay), MakeTimeChecker ())
+          .AddAttribute ("HoldDown",
+                         "Time without SPF events before the back-off returns to quiet (RFC 8405 HOLDDOWN_INTERVAL)",
+                         TimeValue (Seconds (10)),
+                         MakeTimeAccessor (&OspfApp::m_spfHoldDown), MakeTimeChecker ())
+          .AddAttribute ("TimeToLearn",
+                         "Time after the first event during which short delays are used (RFC 8405 TIME_TO_LEARN_INTERVAL)",
+                         TimeValue (MilliSeconds (500)),
+                         MakeTimeAccessor (&OspfApp::m_spfTimeToLearn), MakeTimeChecker ())
+          .AddAttribute ("EnableIncrementalSpf",
+                         "Repair the retained L1 shortest-path tree instead of a full SPF run (iSPF)",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_enableIncrementalSpf),
+                         MakeBooleanChecker ())
+          .AddAttribute ("ShareSpfGraph",
+                         "Share one L1 SPF graph between routers with identical Router-LSDBs",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_shareSpfGraph),
+                         MakeBooleanChecker ())
+          .AddAttribute ("ParallelSpfThreads",
+                         "Worker threads for batched L1 SPF runs; 0 runs SPF serially",
+                         UintegerValue (0),
+                         MakeUintegerAccessor (&OspfApp::m_parallelSpfThreads),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("EnableLfa",
+                         "Compute RFC 5286 loop-free alternates and switch to them on adjacency loss",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_enableLfa),
+                         MakeBooleanChecker ())
+          .AddAttribute ("EnableOrderedFib",
+                         "Order L1 FIB updates by RFC 6976 rank to avoid micro-loops",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_enableOrderedFib),
+                         MakeBooleanChecker ())
+          .AddAttribute ("OrderedFibDelay",
+                         "Hold per rank with EnableOrderedFib",
+                         TimeValue (MilliSeconds (100)),
+                         MakeTimeAccessor (&OspfApp::m_orderedFibDelay), MakeTimeChecker ())
+          .AddAttribute ("MaxEcmpPaths",
+                         "Maximum number of equal-cost next hops installed per route",
+                         UintegerValue (1),
+                         MakeUintegerAccessor (&OspfApp::m_maxEcmpPaths),
+                         MakeUintegerChecker<uint32_t> (1))
+          .AddAttribute ("EnableNextHopGroups",
+                         "Install OSPF routes as prefixes sharing next-hop groups",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_enableNextHopGroups),
+                         MakeBooleanChecker ())
+          .AddAttribute ("LazyFib",
+                         "Resolve OSPF routes on first lookup instead of installing them up front",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_lazyFib),
+                         MakeBooleanChecker ())
+          .AddAttribute ("FibCompression",
+                         "Install an ORTC-aggregated, forwarding-equivalent routing table; ignored with LazyFib",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&OspfApp::m_fibCompression),
+                         MakeBooleanChecker ())
+          .AddAttribute ("HighPriorityPrefixLength",
+                         "Prefixes at least this long are written to the routing table first",
+                         UintegerValue (32),
+                         MakeUintegerAccessor (&OspfApp::m_highPriorityPrefixLength),
+                         MakeUintegerChecker<uint32_t> (0, 32))
+          .AddAttribute ("FibWriteBatchSize",
+                         "Routing table writes per batch; 0 writes every change at once",
+                         UintegerValue (0),
+                         MakeUintegerAccessor (&OspfApp::m_fibWriteBatchSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("FibWriteInterval",
+                         "Time between routing table write batches (FibWriteBatchSize)",
+                         TimeValue (MilliSeconds (1)),
+                         MakeTimeAccessor (&OspfApp::m_fibWriteInterval), MakeTimeChecker ())
           .AddAttribute ("MinLsInterval",
                          "Minimum interval between originating the same LSA (RFC 2328 MinLSInterval)",
                          TimeValue (Seconds (0)),
                          MakeTimeAccessor (&OspfApp::m_minLsInterval), MakeTimeChecker ())
+          .AddAttribute ("LSRefreshTime",
+                         "LS age at which the router re-originates its own LSAs (RFC 2328 LSRefreshTime)",
+                         TimeValue (Seconds (1800)),
+                         MakeTimeAccessor (&OspfApp::m_lsRefreshTime), MakeTimeChecker ())
+          .AddAttribute ("MaxAge",
+                         "LS age at which an LSA is flushed from the routing domain (RFC 2328 MaxAge)",
+                         TimeValue (Seconds (3600)),
+                         MakeTimeAccessor (&OspfApp::m_maxAge), MakeTimeChecker ())
             .AddAttribute (
               "EnableLsaThrottleStats",
               "If true, track statistics about LSA throttling/coalescing (e.g., how many recompute triggers are suppressed while an LSA is pending).",
@@ -128,6 +229,19 @@ OspfApp::GetTypeId (void)
                          TimeValue (MilliSeconds (200)),
                          MakeTimeAccessor (&OspfApp::m_interfaceSyncInterval),
                          MakeTimeChecker ())
+          .AddAttribute ("StubRouterPeriod",
+                         "Time after Enable() with every link at MaxLinkMetric (RFC 6987); zero disables it",
+                         TimeValue (Seconds (0)),
+                         MakeTimeAccessor (&OspfApp::m_stubRouterPeriod), MakeTimeChecker ())
+          .AddAttribute ("StubRouterUntilSync",
+                         "End StubRouterPeriod early once the LSDB is synchronized",
+                         BooleanValue (true),
+                         MakeBooleanAccessor (&OspfApp::m_stubRouterUntilSync),
+                         MakeBooleanChecker ())
+          .AddAttribute ("DrainTime",
+                         "Longest time Drain() waits for the network to route around the router",
+                         TimeValue (Seconds (10)),
+                         MakeTimeAccessor (&OspfApp::m_drainTime), MakeTimeChecker ())
             .AddAttribute ("ResetStateOnDisable",
                    "When Disable() is called, clear neighbor/LSDB state and remove OSPF-installed routes so Enable() behaves like a clean re-join",
                            BooleanValue (false),
@@ -144,7 +258,13 @@ OspfApp::GetTypeId (void)
                            "ns3::Packet::TwoAddressTracedCallback")
           .AddTraceSource ("RxWithAddresses", "A packet has been received",
                            MakeTraceSourceAccessor (&OspfApp::m_rxTraceWithAddresses),
-                           "ns3::Packet::TwoAddressTracedCallback");
+                           "ns3::Packet::TwoAddressTracedCallback")
+          .AddTraceSource ("LsdbChanged", "An LSA was installed or removed and the LSDB digest changed",
+                           MakeTraceSourceAccessor (&OspfApp::m_lsdbChangedTrace),
+                           "ns3::OspfApp::LsdbChangedCallback")
+          .AddTraceSource ("FibChanged", "OSPF added, removed or changed a route in the routing table",
+                           MakeTraceSourceAccessor (&OspfApp::m_fibChangedTrace),
+                           "ns3::OspfApp::FibChangedCallback");
   return tid;
 }
 
@@ -152,6 +272,7 @@ OspfApp::OspfApp ()
   : m_io (std::make_unique<OspfAppIo> (*this)),
     m_neighborFsm (std::make_unique<OspfNeighborFsm> (*this)),
     m_lsa (std::make_unique<OspfLsaProcessor> (*this)),
+    m_aging (std::make_unique<OspfLsaAging> (*this)),
     m_state (std::make_unique<OspfStateSerializer> (*this)),
     m_socketsMgr (std::make_unique<OspfAppSockets> (*this)),
     m_logging (std::make_unique<OspfAppLogging> (*this)),
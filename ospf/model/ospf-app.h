@@ -40,6 +40,8 @@
 #include "ns3/l2-summary-lsa.h"
 #include "next-hop.h"
 #include "ospf-interface.h"
+#include "ospf-lsdb.h"
+#include "ospf-routing-protocol.h"
 #include "unordered_map"
 #include "queue"
 #include "filesystem"
@@ -50,6 +52,7 @@ namespace ns3 {
 class OspfAppIo;
 class OspfNeighborFsm;
 class OspfLsaProcessor;
+class OspfLsaAging;
 class OspfStateSerializer;
 class OspfAppSockets;
 class OspfAppLogging;
@@ -91,12 +94,51 @@ public:
   void Disable ();
   bool IsEnabled () const;
 
+  /**
+   * \brief Disable the protocol gracefully.
+   *
+   * Advertises every link at MAX_LINK_METRIC (RFC 6987) so that other
+   * routers move transit traffic away. Disables once every FULL neighbor
+   * acknowledged that and this router's own routing work is done, holding
+   * for as long again to let the neighbors reroute, and after DrainTime at
+   * the latest. Enable() before then calls the drain off.
+   */
+  void Drain ();
+  bool IsDraining () const;
+
+  /**
+   * \brief Whether links are advertised at MAX_LINK_METRIC, while draining
+   * or for StubRouterPeriod after Enable().
+   */
+  bool IsStubRouter () const;
+
+  static constexpr uint16_t MAX_LINK_METRIC = 0xffff; //!< RFC 6987 MaxLinkMetric
+
   /**
    * \brief Set a pointer to a routing table.
    * \param ipv4Routing Ipv4 routing table
    */
   void SetRouting (Ptr<Ipv4StaticRouting> ipv4Routing);
 
+  /**
+   * \brief Get the multipath routing table.
+   *
+   * Only created once a route is installed with MaxEcmpPaths above 1, or
+   * set by SetOspfRouting.
+   * \return the multipath routing table, or nullptr
+   */
+  Ptr<OspfRoutingProtocol> GetMultipathRouting () const;
+
+  /**
+   * \brief Program OSPF routes into this table only.
+   *
+   * The static routing table then keeps only the bound device routes.
+   * OspfAppHelper calls this when OspfRoutingHelper installed a table on
+   * the node.
+   * \param routing the table, already added to the node's Ipv4ListRouting
+   */
+  void SetOspfRouting (Ptr<OspfRoutingProtocol> routing);
+
   /**
    * \brief Register network devices as OSPF interfaces.Abs
    * 
@@ -157,6 +199,55 @@ public:
    */
   void SetAreaLeader (bool isLeader);
 
+  /**
+   * \brief Add an address range summarized in the area's L2 Summary-LSA
+   *
+   * The area leader advertises the range, with the highest metric of the
+   * area's prefixes inside it, instead of those prefixes; a prefix inside
+   * several ranges goes to the outermost one. Routers of the area install
+   * a discard route for it. Ranges without prefixes are not advertised.
+   * \param network the range network
+   * \param mask the range mask
+   * \param advertise false to hide the range and its prefixes from other areas
+   */
+  void AddAreaRange (Ipv4Address network, Ipv4Mask mask, bool advertise = true);
+
+  /**
+   * \brief Remove an area address range
+   * \param network the range network
+   * \param mask the range mask
+   */
+  void RemoveAreaRange (Ipv4Address network, Ipv4Mask mask);
+
+  /**
+   * \brief Remove every area address range
+   */
+  void ClearAreaRanges ();
+
+  /**
+   * \brief Set the installation priority of the prefixes inside a range
+   *
+   * When a route update writes many prefixes, the lowest priority values
+   * are written first. The longest range covering a prefix decides; other
+   * prefixes get 0 if at least HighPriorityPrefixLength long, 1 otherwise.
+   * \param network the range network
+   * \param mask the range mask
+   * \param priority the priority, 0 first
+   */
+  void SetPrefixPriority (Ipv4Address network, Ipv4Mask mask, uint32_t priority);
+
+  /**
+   * \brief Remove a prefix priority range
+   * \param network the range network
+   * \param mask the range mask
+   */
+  void RemovePrefixPriority (Ipv4Address network, Ipv4Mask mask);
+
+  /**
+   * \brief Remove every prefix priority range
+   */
+  void ClearPrefixPriorities ();
+
   /**
    * \brief Set if LSAs are already preloaded
    * \param doInitialize the status
@@ -200,6 +291,12 @@ public:
   std::map<uint32_t, std::pair<LsaHeader, Ptr<L1SummaryLsa>>> GetL1SummaryLsdb ();
   std::map<uint32_t, std::pair<LsaHeader, Ptr<AreaLsa>>> GetAreaLsdb ();
   std::map<uint32_t, std::pair<LsaHeader, Ptr<L2SummaryLsa>>> GetL2SummaryLsdb ();
+  /**
+   * \brief Check every installed OSPF route against what OSPF last programmed;
+   * only use for testing/debugging
+   * \return true if the routing tables hold exactly the programmed routes
+   */
+  bool IsRoutingTableInSync () const;
   /**
    * \brief Print Router LSDB
    */
@@ -231,27 +328,48 @@ public:
 
   /**
    * \brief Get Router LSDB hash for comparison.
+   *
+   * Order-independent digest kept up to date as LSAs are installed and
+   * removed, so reading it is O(1). The same holds for the other LSDBs.
    * \return Router LSDB hash
    */
-  uint32_t GetLsdbHash ();
+  uint64_t GetLsdbHash ();
 
   /**
    * \brief Get AS External LSDB hash for comparison.
    * \return Router LSDB hash
    */
-  uint32_t GetL1SummaryLsdbHash ();
+  uint64_t GetL1SummaryLsdbHash ();
 
   /**
    * \brief Get Area LSDB hash for comparison.
    * \return Area LSDB hash
    */
-  uint32_t GetAreaLsdbHash ();
+  uint64_t GetAreaLsdbHash ();
 
   /**
    * \brief Get Summary LSDB hash for comparison.
    * \return Summary LSDB hash
    */
-  uint32_t GetL2SummaryLsdbHash ();
+  uint64_t GetL2SummaryLsdbHash ();
+
+  /**
+   * \brief Get a digest of all four LSDBs, equal on routers with equal LSDBs.
+   * \return LSDB digest
+   */
+  uint64_t GetLsdbDigest ();
+
+  /**
+   * \brief Get a digest of the Router and L1 Summary LSDBs, shared within an area.
+   * \return L1 LSDB digest
+   */
+  uint64_t GetL1LsdbDigest ();
+
+  /**
+   * \brief Get a digest of the Area and L2 Summary LSDBs, shared by every area.
+   * \return L2 LSDB digest
+   */
+  uint64_t GetL2LsdbDigest ();
 
   /**
    * \brief Print LSDB hash.
@@ -369,15 +487,203 @@ public:
    */
   void ResetLsaThrottleStats ();
 
+  struct SpfStats
+  {
+    uint64_t fullRuns = 0; //!< L1 SPF runs that recomputed the whole tree
+    uint64_t incrementalRuns = 0; //!< L1 SPF runs that only repaired the changed part of the tree
+    uint64_t sharedGraphHits = 0; //!< Full runs on a graph another router had already built
+    uint64_t unchangedRuns = 0; //!< L1 SPF runs skipped because the Router-LSDB had not changed
+    uint64_t batchedRuns = 0; //!< Full runs computed in a batch on the SPF worker pool
+  };
+
+  /**
+   * \brief Return L1 SPF run statistics.
+   *
+   * Incremental runs only happen when the EnableIncrementalSpf attribute is true,
+   * shared graph hits and unchanged runs when ShareSpfGraph is true, and
+   * batched runs when ParallelSpfThreads is above 0.
+   */
+  SpfStats GetSpfStats () const;
+
+  /**
+   * \brief Reset L1 SPF run statistics to zero.
+   */
+  void ResetSpfStats ();
+
+  struct SpfBackoffStats
+  {
+    uint64_t events = 0; //!< L1 or L2 SPF requests seen by the back-off
+    uint64_t quietToShortWait = 0; //!< First event after a quiet period
+    uint64_t shortToLongWait = 0; //!< Events kept coming past TimeToLearn
+    uint64_t shortWaitToQuiet = 0; //!< HoldDown expired before TimeToLearn
+    uint64_t longWaitToQuiet = 0; //!< HoldDown expired after a long wait
+  };
+
+  /**
+   * \brief Return SPF back-off state transition statistics.
+   *
+   * Only events while the EnableSpfBackoff attribute is true are counted.
+   */
+  SpfBackoffStats GetSpfBackoffStats () const;
+
+  /**
+   * \brief Reset SPF back-off statistics to zero.
+   */
+  void ResetSpfBackoffStats ();
+
+  struct LfaStats
+  {
+    uint32_t destinations = 0; //!< Routers with a primary next hop after the last SPF
+    uint32_t protectedDestinations = 0; //!< ... of which have a loop-free alternate
+    uint32_t nodeProtected = 0; //!< ... of which avoid the primary next-hop router too
+    uint64_t activations = 0; //!< Next hops switched to a backup on adjacency loss
+  };
+
+  /**
+   * \brief Return loop-free alternate coverage statistics.
+   *
+   * Only computed when the EnableLfa attribute is true.
+   */
+  LfaStats GetLfaStats () const;
+
+  /**
+   * \brief Reset the LFA activation count to zero.
+   */
+  void ResetLfaStats ();
+
+  struct OrderedFibStats
+  {
+    uint64_t holds = 0; //!< L1 SPF runs held back to order the FIB update
+    uint32_t lastRank = 0; //!< Rank of the last due run, 0 if it was not held
+  };
+
+  /**
+   * \brief Return ordered FIB update statistics.
+   *
+   * Only counted while the EnableOrderedFib attribute is true.
+   */
+  OrderedFibStats GetOrderedFibStats () const;
+
+  /**
+   * \brief Reset the ordered FIB hold count to zero.
+   */
+  void ResetOrderedFibStats ();
+
+  struct NextHopGroupStats
+  {
+    uint32_t groups = 0; //!< Next-hop groups in use
+    uint32_t prefixes = 0; //!< Prefixes attached to them
+    uint64_t groupUpdates = 0; //!< Groups whose resolved next hops changed
+    uint64_t routeUpdates = 0; //!< Per-prefix routing table writes
+  };
+
+  /**
+   * \brief Return next-hop group statistics.
+   *
+   * Groups are kept in either case; the EnableNextHopGroups attribute only
+   * decides whether the routing table forwards through them.
+   */
+  NextHopGroupStats GetNextHopGroupStats () const;
+
+  /**
+   * \brief Reset the next-hop group update counts to zero.
+   */
+  void ResetNextHopGroupStats ();
+
+  struct LazyFibStats
+  {
+    uint32_t materialized = 0; //!< Host routes currently installed
+    uint64_t resolutions = 0; //!< Destinations resolved on lookup
+    uint64_t invalidations = 0; //!< Host routes dropped by updates
+  };
+
+  /**
+   * \brief Return lazy FIB statistics; all zero unless LazyFib is set.
+   */
+  LazyFibStats GetLazyFibStats () const;
+
+  /**
+   * \brief Reset the lazy FIB resolution and invalidation counts to zero.
+   */
+  void ResetLazyFibStats ();
+
+  struct FibCompressionStats
+  {
+    uint32_t prefixes = 0; //!< Prefixes OSPF would install
+    uint32_t entries = 0; //!< Aggregated routes installed in their place
+    double ratio = 1.0; //!< entries / prefixes, 1 with no prefixes
+  };
+
+  struct FibWriteStats
+  {
+    uint32_t pending = 0; //!< Prefixes waiting for a later write batch
+    uint64_t deferredBatches = 0; //!< Write batches run after the update that queued them
+  };
+
+  /**
+   * \brief Return prioritized installation statistics.
+   *
+   * Prefixes are only deferred while FibWriteBatchSize is above 0.
+   */
+  FibWriteStats GetFibWriteStats () const;
+
+  /**
+   * \brief Reset the deferred batch count to zero.
+   */
+  void ResetFibWriteStats ();
+
+  /**
+   * \brief Return FIB compression statistics; all zero unless FibCompression is set.
+   */
+  FibCompressionStats GetFibCompressionStats () const;
+
+  /**
+   * \brief Time until the next scheduled SPF run, FIB write batch, deferred
+   * LSA origination, area leadership attempt, stub router end or drain.
+   * \return the delay, or Time::Max () if no routing work is scheduled
+   */
+  Time GetRoutingDelayLeft () const;
+
+  /**
+   * \brief Number of LSAs with an aging timer, one per installed LSA.
+   * \return timers on the aging timer wheel
+   */
+  uint32_t GetNAgingTimers () const;
+
+  /**
+   * \brief Number of keys the LSDB keeps state for: installed LSAs, sequence
+   * numbers and origination state.
+   * \return LSDB keys
+   */
+  uint32_t GetNLsdbKeys () const;
+
+  /**
+   * TracedCallback signature for LSDB changes.
+   *
+   * \param [in] routerId this router
+   * \param [in] digest the new GetLsdbDigest ()
+   */
+  typedef void (*LsdbChangedCallback) (Ipv4Address routerId, uint64_t digest);
+
+  /**
+   * TracedCallback signature for routing table writes.
+   *
+   * \param [in] routerId this router
+   */
+  typedef void (*FibChangedCallback) (Ipv4Address routerId);
+
 protected:
   virtual void DoDispose (void);
 
 private:
   void ResetStateForRestart ();
+  // Fire LsdbChanged if the LSDB digest moved since it last fired
+  void NotifyLsdbChanged ();
   void FlushOspfRoutes ();
   friend class OspfAppIo;
   friend class OspfNeighborFsm;
   friend class OspfLsaProcessor;
+  friend class OspfLsaAging;
   friend class OspfStateSerializer;
   friend class OspfAppSockets;
   friend class OspfAppLogging;
@@ -388,6 +694,7 @@ private:
   std::unique_ptr<OspfAppIo> m_io;
   std::unique_ptr<OspfNeighborFsm> m_neighborFsm;
   std::unique_ptr<OspfLsaProcessor> m_lsa;
+  std::unique_ptr<OspfLsaAging> m_aging;
   std::unique_ptr<OspfStateSerializer> m_state;
   std::unique_ptr<OspfAppSockets> m_socketsMgr;
   std::unique_ptr<OspfAppLogging> m_logging;
@@ -650,6 +957,11 @@ private:
    * \brief Recompute Area Summary-LSA, increment its Sequence Number, and inject to L2 Summary LSDB
    */
   bool RecomputeL2SummaryLsa ();
+  /**
+   * \brief Summarize the area's L1 Summary-LSA prefixes with the area ranges and AutoSummarize
+   * \return the L2 Summary-LSA routes
+   */
+  std::set<SummaryRoute> SummarizeL2Routes ();
   /**
    * \brief Throttled version of RecomputeL2SummaryLsa that respects MinLsInterval
    */
@@ -662,12 +974,6 @@ private:
    */
   Time GetLsaThrottleDelay (const LsaHeader::LsaKey &lsaKey);
 
-  /**
-   * \brief Clean up completed throttle events for an LSA key
-   * \param lsaKey the LSA key to clean
-   */
-  void CleanupThrottleEvent (const LsaHeader::LsaKey &lsaKey);
-
   /**
    * \brief Wrapper for RecomputeAreaLsa (void return type for Simulator::Schedule)
    */
@@ -682,6 +988,18 @@ private:
    */
   void UpdateRouting ();
 
+  /**
+   * \brief Update routes for the prefixes whose L1 Summary-LSA changed
+   * \param routerId the originating router ID
+   */
+  void UpdateL1SummaryRoutes (uint32_t routerId);
+
+  /**
+   * \brief Update routes for the prefixes whose L2 Summary-LSA changed
+   * \param areaId the originating area ID
+   */
+  void UpdateL2SummaryRoutes (uint32_t areaId);
+
   /**
    * \brief Schedule to update shortest paths and prefixes for L1
    */
@@ -808,6 +1126,43 @@ private:
   bool m_protocolRunning = false;
   bool m_resetStateOnDisable = false;
 
+  // Stub router (RFC 6987) and graceful drain
+  /**
+   * Time after Enable() during which every link is advertised at
+   * MAX_LINK_METRIC (RFC 6987), so that no transit traffic comes through
+   * before this router's own routes are in. Zero disables it.
+   */
+  Time m_stubRouterPeriod;
+  /**
+   * End m_stubRouterPeriod at the first L1 SPF after some adjacency is
+   * FULL and none is still exchanging databases.
+   */
+  bool m_stubRouterUntilSync = true;
+  /**
+   * Upper bound on the time between Drain() raising the metrics and
+   * disabling the router. It is disabled earlier once every FULL neighbor
+   * has acknowledged the max-metric Router-LSA and no SPF run, FIB write
+   * batch or origination is pending here.
+   */
+  Time m_drainTime;
+  bool m_stubRouter = false;
+  bool m_draining = false;
+  bool m_drainRerouted = false; //!< Disable is scheduled off the drain's progress
+  Time m_drainStart;
+  EventId m_stubRouterEvent;
+  EventId m_drainEvent;
+  EventId m_drainCheckEvent;
+  // Schedule Disable once the network has routed around a draining router
+  void CheckDrain ();
+  // Every FULL neighbor acknowledged our current Router-LSA
+  bool IsRouterLsaAcked () const;
+  void EndStubRouter ();
+  // Ends a startup period early once IsLsdbSynchronized
+  void NotifyL1RoutesInstalled ();
+  bool IsLsdbSynchronized () const;
+  // Refresh the Router-LSA after a metric change, if there is one yet
+  void ReoriginateRouterLsa ();
+
   // Area
   /**
    * \brief Begin as an area leader
@@ -859,8 +1214,111 @@ private:
   // Routing
   Ptr<Ipv4StaticRouting> m_routing; // !< Routing table
   std::unordered_map<uint32_t, NextHop> m_l1NextHop; //!< Next Hopto routers
+  std::unordered_map<uint32_t, NextHop> m_l1BackupNextHop; //!< Loop-free alternates to routers
+  /**
+   * Compute a loop-free alternate next hop (RFC 5286) per router on every
+   * L1 SPF, preferring node-protecting ones. When an adjacency is lost,
+   * routes through it move to an equal-cost sibling or their alternate at
+   * once, ahead of the reconvergence.
+   */
+  bool m_enableLfa = false;
+  uint32_t m_lfaDestinations = 0;
+  uint32_t m_lfaProtected = 0;
+  uint32_t m_lfaNodeProtected = 0;
+  uint64_t m_lfaActivations = 0;
+  /**
+   * Hold a due L1 SPF for m_orderedFibDelay times this router's rank
+   * (RFC 6976) before updating the FIB. Routers that reach a failed or
+   * worse link through this one update first; after an improvement,
+   * routers closer to the link do. No transient forwarding loop forms.
+   */
+  bool m_enableOrderedFib = false;
+  Time m_orderedFibDelay; //!< Hold per rank, longer than a FIB update takes
+  uint64_t m_orderedFibHolds = 0;
+  uint32_t m_orderedFibLastRank = 0;
   std::unordered_map<uint32_t, std::vector<uint32_t>> m_l1Addresses; //!< Addresses for L1 routers
   Time m_shortestPathUpdateDelay; // !< Shortest path before shortest path calculation
+  /**
+   * Delay SPF by the RFC 8405 back-off (m_initialSpfDelay through
+   * m_spfTimeToLearn) instead of m_shortestPathUpdateDelay. The L1 and L2
+   * schedulers share one back-off state.
+   */
+  bool m_enableSpfBackoff = false;
+  Time m_initialSpfDelay; //!< Back-off delay from QUIET
+  Time m_shortSpfDelay; //!< Back-off delay in SHORT_WAIT
+  Time m_longSpfDelay; //!< Back-off delay in LONG_WAIT
+  Time m_spfHoldDown; //!< Quiet time before the back-off returns to QUIET
+  Time m_spfTimeToLearn; //!< Time in SHORT_WAIT before LONG_WAIT
+  /**
+   * Keep the L1 shortest-path tree between runs and recompute only the
+   * part affected by changed Router-LSAs.
+   */
+  bool m_enableIncrementalSpf = false;
+  uint64_t m_spfFullRuns = 0;
+  uint64_t m_spfIncrementalRuns = 0;
+  /**
+   * Share L1 SPF graphs between routers with the same Router-LSDB, through
+   * a process-wide cache keyed by the LSDB digest. A router skips SPF
+   * while its digest is unchanged. Takes precedence over
+   * m_enableIncrementalSpf.
+   */
+  bool m_shareSpfGraph = false;
+  uint64_t m_spfSharedGraphHits = 0;
+  uint64_t m_spfUnchangedRuns = 0;
+  /**
+   * If above 0, L1 SPF runs due at the same simulation time are batched on
+   * a process-wide pool of up to this many threads. Their results are
+   * installed in the order the runs were scheduled. Ignored while
+   * m_shareSpfGraph is set.
+   */
+  uint32_t m_parallelSpfThreads = 0;
+  uint64_t m_spfBatchedRuns = 0;
+  /**
+   * Maximum equal-cost next hops per route. Above 1, routes with several
+   * next hops go to m_multipathRouting, which hashes flows over them.
+   */
+  uint32_t m_maxEcmpPaths = 1;
+  Ptr<OspfRoutingProtocol> m_multipathRouting; //!< Multipath table, used with ECMP or next-hop groups
+  bool m_ospfRoutingOnly = false; //!< OSPF routes go to m_multipathRouting only
+  /**
+   * Install OSPF routes in m_multipathRouting as prefixes pointing at
+   * next-hop groups, one per set of origins. A topology change then
+   * rewrites only the groups, not the prefixes behind them.
+   */
+  bool m_enableNextHopGroups = false;
+  uint64_t m_nextHopGroupUpdates = 0;
+  uint64_t m_prefixRouteUpdates = 0;
+  /**
+   * Resolve routes on first lookup instead of installing them all.
+   * m_multipathRouting installs a host route from the prefix index the
+   * first time a destination is looked up, and routing updates drop only
+   * the host routes whose resolution changed.
+   */
+  bool m_lazyFib = false;
+  uint64_t m_lazyFibResolutions = 0;
+  uint64_t m_lazyFibInvalidations = 0;
+  /**
+   * Aggregate OSPF routes into the smallest set of prefixes that forwards
+   * every address the same way (ORTC), and install them in
+   * m_multipathRouting. Routing updates recompute only the aggregates they
+   * touch. Ignored with m_lazyFib.
+   */
+  bool m_fibCompression = false;
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> m_prefixPriorities; // <network, mask> -> priority
+  /**
+   * Prefixes at least this long, such as router loopbacks, are written to
+   * the routing table ahead of the others, unless m_prefixPriorities says
+   * otherwise.
+   */
+  uint32_t m_highPriorityPrefixLength = 32;
+  /**
+   * Routing table writes per batch, modeling a limited FIB write rate.
+   * Further prefixes wait for later batches, highest priority first. 0
+   * writes them all at once. Ignored with m_fibCompression and m_lazyFib.
+   */
+  uint32_t m_fibWriteBatchSize = 0;
+  Time m_fibWriteInterval; //!< Time between write batches
+  uint64_t m_fibWriteBatches = 0;
   std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> m_externalRoutes;
 
   // Area
@@ -870,15 +1328,24 @@ private:
 
   // LSA
   bool m_enableAreaProxy; // True if Proxied L2 LSAs are generated
+  std::map<std::pair<uint32_t, uint32_t>, bool> m_areaRanges; // <network, mask> -> advertise
+  /**
+   * Aggregate the area leader's L2 Summary-LSA outside of the area ranges.
+   * Prefixes covered by another prefix of the area are dropped and sibling
+   * prefixes are merged into their parent, each with the highest metric it
+   * replaces. The advertised address space does not change.
+   */
+  bool m_autoSummarize = false;
   Time m_rxmtInterval; // retransmission timer
   EventId m_areaLeaderBeginTimer; // area leadership begin timer
   Ipv4Address m_lsaAddress; //!< multicast address for LSA
-  std::map<LsaHeader::LsaKey, uint16_t> m_seqNumbers; // sequence number of stored LSA
 
-  // LSA Throttling (RFC 2328 MinLSInterval)
+  // LSA Throttling (RFC 2328 MinLSInterval), kept per LSA in m_lsdb
   Time m_minLsInterval; //!< Minimum interval between originating the same LSA
-  std::map<LsaHeader::LsaKey, Time> m_lastLsaOriginationTime; //!< Last origination time per LSA key
-  std::map<LsaHeader::LsaKey, EventId> m_pendingLsaRegeneration; //!< Pending regeneration events
+
+  // LSA aging (RFC 2328)
+  Time m_lsRefreshTime; //!< Age at which our own LSAs are re-originated
+  Time m_maxAge; //!< Age at which other routers' LSAs are flushed
 
   bool m_enableLsaThrottleStats = false;
   uint64_t m_lsaThrottleRecomputeTriggers = 0;
@@ -887,20 +1354,20 @@ private:
   uint64_t m_lsaThrottleSuppressed = 0;
   uint64_t m_lsaThrottleCancelledPending = 0;
 
+  // Every LSA with its sequence numbers, viewed by type below
+  OspfLsdb m_lsdb;
+
   // L1 LSDB
-  std::map<uint32_t, std::pair<LsaHeader, Ptr<RouterLsa>>>
-      m_routerLsdb; // LSDB for each remote router ID
-  std::map<uint32_t, std::pair<LsaHeader, Ptr<L1SummaryLsa>>>
-      m_l1SummaryLsdb; // LSDB for each remote router ID
+  OspfLsdbView<RouterLsa> m_routerLsdb {m_lsdb}; // LSDB for each remote router ID
+  OspfLsdbView<L1SummaryLsa> m_l1SummaryLsdb {m_lsdb}; // LSDB for each remote router ID
   std::unordered_map<uint32_t, std::pair<uint32_t, NextHop>>
       m_nextHopToShortestBorderRouter; // next hop
   std::vector<uint32_t> m_advertisingPrefixes;
   EventId m_updateL1ShortestPathTimeout; // timeout to update the L1 shortest path
 
   // L2 LSDB
-  std::map<uint32_t, std::pair<LsaHeader, Ptr<AreaLsa>>> m_areaLsdb; // LSDB for each remote area ID
-  std::map<uint32_t, std::pair<LsaHeader, Ptr<L2SummaryLsa>>>
-      m_l2SummaryLsdb; // LSDB for summary prefixes
+  OspfLsdbView<AreaLsa> m_areaLsdb {m_lsdb}; // LSDB for each remote area ID
+  OspfLsdbView<L2SummaryLsa> m_l2SummaryLsdb {m_lsdb}; // LSDB for summary prefixes
   EventId m_updateL2ShortestPathTimeout; // timeout to update the L2 shortest path
 
   /// Callbacks for tracing the packet Tx events
@@ -914,6 +1381,13 @@ private:
 
   /// Callbacks for tracing the packet Rx events, includes source and destination addresses
   TracedCallback<Ptr<const Packet>, const Address &, const Address &> m_rxTraceWithAddresses;
+
+  /// Callbacks for tracing LSDB changes, with the new LSDB digest
+  TracedCallback<Ipv4Address, uint64_t> m_lsdbChangedTrace;
+  uint64_t m_notifiedLsdbDigest = 0; //!< Digest LsdbChanged last reported
+
+  /// Callbacks for tracing routing table writes
+  TracedCallback<Ipv4Address> m_fibChangedTrace;
 };
 
 } // namespace ns3
@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ospf-fib-compressor.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace ns3 {
+
+void
+OspfFibCompressor::Set (uint32_t prefix, uint8_t length, uint32_t nextHop)
+{
+  prefix = Mask (prefix, length);
+  if (nextHop == NO_ROUTE && Get (prefix, length) == NO_ROUTE)
+    {
+      return;
+    }
+  if (m_root == NO_NODE)
+    {
+      m_root = AddNode ();
+    }
+
+  // Everything on the path is recomputed on the next Compress
+  std::vector<uint32_t> path;
+  uint32_t index = m_root;
+  for (uint8_t depth = 0;; depth++)
+    {
+      path.push_back (index);
+      m_nodes[index].stale = true;
+      m_nodes[index].entryStale = true;
+      if (depth == length)
+        {
+          break;
+        }
+      if (m_nodes[index].child[0] == NO_NODE)
+        {
+          uint32_t left = AddNode ();
+          uint32_t right = AddNode ();
+          m_nodes[index].child[0] = left;
+          m_nodes[index].child[1] = right;
+        }
+      index = m_nodes[index].child[Bit (prefix, depth)];
+    }
+
+  Node &node = m_nodes[index];
+  m_nPrefixes += (node.nextHop == NO_ROUTE) - (nextHop == NO_ROUTE);
+  node.nextHop = nextHop;
+
+  // Fold pairs of empty leaves back into their parent
+  for (uint32_t depth = length; depth-- > 0;)
+    {
+      Node &parent = m_nodes[path[depth]];
+      const Node &left = m_nodes[parent.child[0]];
+      const Node &right = m_nodes[parent.child[1]];
+      if (left.child[0] != NO_NODE || right.child[0] != NO_NODE || left.nextHop != NO_ROUTE ||
+          right.nextHop != NO_ROUTE)
+        {
+          break;
+        }
+      uint32_t network = Mask (prefix, depth);
+      ReleaseLeaf (parent.child[0], network, depth + 1);
+      ReleaseLeaf (parent.child[1], network | (0x80000000u >> depth), depth + 1);
+      parent.child[0] = NO_NODE;
+      parent.child[1] = NO_NODE;
+    }
+}
+
+uint32_t
+OspfFibCompressor::Get (uint32_t prefix, uint8_t length) const
+{
+  uint32_t index = m_root;
+  for (uint8_t depth = 0; index != NO_NODE; depth++)
+    {
+      if (depth == length)
+        {
+          return m_nodes[index].nextHop;
+        }
+      index = m_nodes[index].child[Bit (prefix, depth)];
+    }
+  return NO_ROUTE;
+}
+
+void
+OspfFibCompressor::Compress (std::vector<Entry> &removed, std::vector<Entry> &added)
+{
+  removed.insert (removed.end (), m_released.begin (), m_released.end ());
+  m_released.clear ();
+  if (m_root == NO_NODE)
+    {
+      return;
+    }
+  UpdateCandidates (m_root, NO_ROUTE);
+  UpdateEntries (m_root, 0, 0, NO_ROUTE, removed, added);
+}
+
+uint32_t
+OspfFibCompressor::GetNPrefixes () const
+{
+  return m_nPrefixes;
+}
+
+uint32_t
+OspfFibCompressor::GetNEntries () const
+{
+  return m_nEntries;
+}
+
+std::vector<OspfFibCompressor::Entry>
+OspfFibCompressor::GetEntries () const
+{
+  std::vector<Entry> entries;
+  entries.reserve (m_nEntries);
+  // <node, prefix, length>, child 0 popped first
+  std::vector<std::tuple<uint32_t, uint32_t, uint8_t>> stack;
+  if (m_root != NO_NODE)
+    {
+      stack.emplace_back (m_root, 0, 0);
+    }
+  while (!stack.empty ())
+    {
+      auto [index, prefix, length] = stack.back ();
+      stack.pop_back ();
+      const Node &node = m_nodes[index];
+      if (node.entry != NO_ROUTE)
+        {
+          entries.emplace_back (prefix, length, node.entry);
+        }
+      if (node.child[0] != NO_NODE)
+        {
+          stack.emplace_back (node.child[1], prefix | (0x80000000u >> length), length + 1);
+          stack.emplace_back (node.child[0], prefix, length + 1);
+        }
+    }
+  return entries;
+}
+
+void
+OspfFibCompressor::Clear ()
+{
+  m_nodes.clear ();
+  m_freeNodes.clear ();
+  m_root = NO_NODE;
+  m_nPrefixes = 0;
+  m_nEntries = 0;
+  m_released.clear ();
+}
+
+uint32_t
+OspfFibCompressor::AddNode ()
+{
+  if (!m_freeNodes.empty ())
+    {
+      uint32_t index = m_freeNodes.back ();
+      m_freeNodes.pop_back ();
+      m_nodes[index] = Node ();
+      return index;
+    }
+  m_nodes.emplace_back ();
+  return m_nodes.size () - 1;
+}
+
+void
+OspfFibCompressor::ReleaseLeaf (uint32_t index, uint32_t prefix, uint8_t length)
+{
+  Node &node = m_nodes[index];
+  if (node.entry != NO_ROUTE)
+    {
+      m_released.emplace_back (prefix, length, node.entry);
+      m_nEntries--;
+    }
+  node = Node ();
+  m_freeNodes.push_back (index);
+}
+
+bool
+OspfFibCompressor::UpdateCandidates (uint32_t index, uint32_t inherited)
+{
+  // Pass 1 pushes next hops down to the leaves; a node's candidates only
+  // depend on the next hop it would pass down
+  Node &node = m_nodes[index];
+  uint32_t own = node.nextHop != NO_ROUTE ? node.nextHop : inherited;
+  if (!node.stale && node.candidatesFor == own)
+    {
+      return false;
+    }
+  node.stale = false;
+  node.candidatesFor = own;
+
+  // Pass 2: the intersection of the children's candidates if not empty,
+  // else their union. A hole anywhere below rules out every entry here.
+  std::vector<uint32_t> candidates;
+  bool changed = false;
+  if (node.child[0] == NO_NODE)
+    {
+      candidates.push_back (own);
+    }
+  else
+    {
+      changed |= UpdateCandidates (node.child[0], own);
+      changed |= UpdateCandidates (node.child[1], own);
+      const std::vector<uint32_t> &left = m_nodes[node.child[0]].candidates;
+      const std::vector<uint32_t> &right = m_nodes[node.child[1]].candidates;
+      if (left.front () == NO_ROUTE || right.front () == NO_ROUTE)
+        {
+          candidates.push_back (NO_ROUTE);
+        }
+      else
+        {
+          std::set_intersection (left.begin (), left.end (), right.begin (), right.end (),
+                                 std::back_inserter (candidates));
+          if (candidates.empty ())
+            {
+              std::set_union (left.begin (), left.end (), right.begin (), right.end (),
+                              std::back_inserter (candidates));
+            }
+        }
+    }
+  if (candidates != node.candidates)
+    {
+      node.candidates.swap (candidates);
+      changed = true;
+    }
+  node.entryStale |= changed;
+  return changed;
+}
+
+void
+OspfFibCompressor::UpdateEntries (uint32_t index, uint32_t prefix, uint8_t length,
+                                  uint32_t inherited, std::vector<Entry> &removed,
+                                  std::vector<Entry> &added)
+{
+  Node &node = m_nodes[index];
+  if (!node.entryStale && node.entryFor == inherited)
+    {
+      return;
+    }
+  node.entryStale = false;
+  node.entryFor = inherited;
+
+  // Pass 3: an entry only where the inherited next hop is not a candidate.
+  // Holes are only ever under holes, so they inherit NO_ROUTE.
+  uint32_t entry = std::binary_search (node.candidates.begin (), node.candidates.end (), inherited)
+                       ? NO_ROUTE
+                       : node.candidates.front ();
+  if (entry != node.entry)
+    {
+      if (node.entry != NO_ROUTE)
+        {
+          removed.emplace_back (prefix, length, node.entry);
+          m_nEntries--;
+        }
+      if (entry != NO_ROUTE)
+        {
+          added.emplace_back (prefix, length, entry);
+          m_nEntries++;
+        }
+      node.entry = entry;
+    }
+  if (node.child[0] != NO_NODE)
+    {
+      uint32_t next = entry != NO_ROUTE ? entry : inherited;
+      uint32_t left = node.child[0];
+      uint32_t right = node.child[1];
+      UpdateEntries (left, prefix, length + 1, next, removed, added);
+      UpdateEntries (right, prefix | (0x80000000u >> length), length + 1, next, removed, added);
+    }
+}
+
+} // namespace ns3
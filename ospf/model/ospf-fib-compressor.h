@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef OSPF_FIB_COMPRESSOR_H
+#define OSPF_FIB_COMPRESSOR_H
+
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ *
+ * \brief Incremental ORTC aggregation of an IPv4 forwarding table
+ *
+ * Keeps a set of prefixes, each with an opaque next hop, and the smallest
+ * table that forwards every address the same way under longest-prefix
+ * match (Draves et al., "Constructing Optimal IP Routing Tables"). The
+ * table is also never allowed to cover an address that no prefix covers,
+ * since a forwarding table cannot express "no route here" below a route;
+ * within that constraint it is still optimal.
+ *
+ * The prefixes live in a binary trie where every node has zero or two
+ * children. Each node caches its ORTC candidate set and its compressed
+ * entry. A change only marks the nodes on its path, so Compress revisits
+ * those paths and the subtree under a changed prefix down to the next
+ * prefix below it, and reports the entries that changed.
+ */
+class OspfFibCompressor
+{
+public:
+  static constexpr uint32_t NO_ROUTE = 0;
+
+  // <prefix, length, next hop>
+  typedef std::tuple<uint32_t, uint8_t, uint32_t> Entry;
+
+  // Set the next hop of a prefix, NO_ROUTE to remove it; bits past the
+  // length are ignored. Applied to the table on the next Compress.
+  void Set (uint32_t prefix, uint8_t length, uint32_t nextHop);
+  // Next hop of exactly this prefix, NO_ROUTE if absent
+  uint32_t Get (uint32_t prefix, uint8_t length) const;
+  // Bring the table up to date. Entries that left it are appended to
+  // removed, those that joined it to added; a changed next hop is both.
+  void Compress (std::vector<Entry> &removed, std::vector<Entry> &added);
+
+  uint32_t GetNPrefixes () const;
+  // Table size as of the last Compress
+  uint32_t GetNEntries () const;
+  // The table, in <prefix, length> order
+  std::vector<Entry> GetEntries () const;
+  void Clear ();
+
+private:
+  static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max ();
+
+  struct Node
+  {
+    uint32_t child[2] = {NO_NODE, NO_NODE}; // both or neither
+    uint32_t nextHop = NO_ROUTE; // of exactly this prefix
+    bool stale = true; // candidates may be out of date
+    bool entryStale = true; // entries here or below may be out of date
+    uint32_t candidatesFor = NO_ROUTE; // next hop the candidates were computed with
+    uint32_t entryFor = NO_ROUTE; // inherited next hop the entry was chosen under
+    uint32_t entry = NO_ROUTE; // table entry at this prefix
+    // Sorted; {NO_ROUTE} if some address below has no route
+    std::vector<uint32_t> candidates;
+  };
+
+  static uint32_t Mask (uint32_t address, uint8_t length);
+  static uint32_t Bit (uint32_t address, uint8_t position);
+  uint32_t AddNode ();
+  // Drop a leaf, reporting its entry as removed
+  void ReleaseLeaf (uint32_t index, uint32_t prefix, uint8_t length);
+  // ORTC passes 1 and 2; returns true if any candidate set changed
+  bool UpdateCandidates (uint32_t index, uint32_t inherited);
+  // ORTC pass 3
+  void UpdateEntries (uint32_t index, uint32_t prefix, uint8_t length, uint32_t inherited,
+                      std::vector<Entry> &removed, std::vector<Entry> &added);
+
+  std::vector<Node> m_nodes;
+  std::vector<uint32_t> m_freeNodes;
+  uint32_t m_root = NO_NODE;
+  uint32_t m_nPrefixes = 0;
+  uint32_t m_nEntries = 0;
+  // Entries of leaves released since the last Compress
+  std::vector<Entry> m_released;
+};
+
+inline uint32_t
+OspfFibCompressor::Mask (uint32_t address, uint8_t length)
+{
+  return length == 0 ? 0 : address & (~0u << (32 - length));
+}
+
+inline uint32_t
+OspfFibCompressor::Bit (uint32_t address, uint8_t position)
+{
+  return (address >> (31 - position)) & 1;
+}
+
+} // namespace ns3
+
+#endif // OSPF_FIB_COMPRESSOR_H
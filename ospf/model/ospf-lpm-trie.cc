@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ospf-lpm-trie.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+namespace {
+
+// Leading bits two addresses share
+uint8_t
+CommonLength (uint32_t a, uint32_t b)
+{
+  uint8_t length = 0;
+  for (uint32_t diff = a ^ b; length < 32 && !(diff & 0x80000000u); diff <<= 1)
+    {
+      length++;
+    }
+  return length;
+}
+
+} // namespace
+
+bool
+OspfLpmTrie::Insert (uint32_t prefix, uint8_t length, uint32_t value)
+{
+  prefix = Mask (prefix, length);
+  m_bulkChanges++;
+  uint32_t parent = NO_NODE;
+  uint32_t bit = 0;
+  uint32_t index = m_root;
+  while (index != NO_NODE)
+    {
+      Node node = m_nodes[index];
+      uint8_t common = std::min ({CommonLength (node.prefix, prefix), node.length, length});
+      if (common == node.length && node.length == length)
+        {
+          bool added = node.value == NO_VALUE;
+          m_nodes[index].value = value;
+          m_size += added;
+          return added;
+        }
+      if (common == node.length)
+        {
+          parent = index;
+          bit = Bit (prefix, node.length);
+          index = node.child[bit];
+          continue;
+        }
+
+      // The new prefix or a branching node goes between parent and index
+      uint32_t added;
+      if (common == length)
+        {
+          added = AddNode (prefix, length, value);
+        }
+      else
+        {
+          added = AddNode (Mask (prefix, common), common, NO_VALUE);
+          m_nodes[added].child[Bit (prefix, common)] = AddNode (prefix, length, value);
+        }
+      m_nodes[added].child[Bit (node.prefix, common)] = index;
+      SetLink (parent, bit, added);
+      m_size++;
+      return true;
+    }
+  SetLink (parent, bit, AddNode (prefix, length, value));
+  m_size++;
+  return true;
+}
+
+bool
+OspfLpmTrie::Remove (uint32_t prefix, uint8_t length)
+{
+  prefix = Mask (prefix, length);
+  uint32_t index = m_root;
+  while (index != NO_NODE)
+    {
+      Node &node = m_nodes[index];
+      if (node.length > length || Mask (prefix, node.length) != node.prefix)
+        {
+          return false;
+        }
+      if (node.length == length)
+        {
+          if (node.value == NO_VALUE)
+            {
+              return false;
+            }
+          node.value = NO_VALUE;
+          m_size--;
+          m_bulkChanges++;
+          if (m_bulkDepth == 0)
+            {
+              RebuildIfSparse ();
+            }
+          return true;
+        }
+      index = node.child[Bit (prefix, node.length)];
+    }
+  return false;
+}
+
+uint32_t
+OspfLpmTrie::Find (uint32_t prefix, uint8_t length) const
+{
+  prefix = Mask (prefix, length);
+  uint32_t index = m_root;
+  while (index != NO_NODE)
+    {
+      const Node &node = m_nodes[index];
+      if (node.length > length || Mask (prefix, node.length) != node.prefix)
+        {
+          return NO_VALUE;
+        }
+      if (node.length == length)
+        {
+          return node.value;
+        }
+      index = node.child[Bit (prefix, node.length)];
+    }
+  return NO_VALUE;
+}
+
+uint32_t
+OspfLpmTrie::Lookup (uint32_t address) const
+{
+  return Lookup (address, [] (uint32_t) { return true; });
+}
+
+uint32_t
+OspfLpmTrie::GetSize () const
+{
+  return m_size;
+}
+
+uint32_t
+OspfLpmTrie::GetNNodes () const
+{
+  return m_nodes.size ();
+}
+
+std::vector<OspfLpmTrie::Entry>
+OspfLpmTrie::GetEntries () const
+{
+  // Pre-order, child 0 first, is <prefix, length> order
+  std::vector<Entry> entries;
+  entries.reserve (m_size);
+  std::vector<uint32_t> stack;
+  if (m_root != NO_NODE)
+    {
+      stack.push_back (m_root);
+    }
+  while (!stack.empty ())
+    {
+      const Node &node = m_nodes[stack.back ()];
+      stack.pop_back ();
+      if (node.value != NO_VALUE)
+        {
+          entries.emplace_back (node.prefix, node.length, node.value);
+        }
+      for (uint32_t bit : {1, 0})
+        {
+          if (node.child[bit] != NO_NODE)
+            {
+              stack.push_back (node.child[bit]);
+            }
+        }
+    }
+  return entries;
+}
+
+void
+OspfLpmTrie::Clear ()
+{
+  m_nodes.clear ();
+  m_root = NO_NODE;
+  m_size = 0;
+  m_bulkChanges = 0;
+}
+
+void
+OspfLpmTrie::BeginBulkUpdate ()
+{
+  if (m_bulkDepth++ == 0)
+    {
+      m_bulkChanges = 0;
+    }
+}
+
+void
+OspfLpmTrie::EndBulkUpdate ()
+{
+  if (m_bulkDepth == 0 || --m_bulkDepth > 0)
+    {
+      return;
+    }
+  if (m_bulkChanges > m_size / 2)
+    {
+      Rebuild ();
+    }
+  else
+    {
+      RebuildIfSparse ();
+    }
+}
+
+uint32_t
+OspfLpmTrie::AddNode (uint32_t prefix, uint8_t length, uint32_t value)
+{
+  m_nodes.push_back (Node{prefix, length, value, {NO_NODE, NO_NODE}});
+  return m_nodes.size () - 1;
+}
+
+void
+OspfLpmTrie::SetLink (uint32_t parent, uint32_t bit, uint32_t node)
+{
+  if (parent == NO_NODE)
+    {
+      m_root = node;
+    }
+  else
+    {
+      m_nodes[parent].child[bit] = node;
+    }
+}
+
+void
+OspfLpmTrie::Rebuild ()
+{
+  // Inserting in order appends every node after its parent
+  std::vector<Entry> entries = GetEntries ();
+  Clear ();
+  m_nodes.reserve (2 * entries.size ());
+  for (auto &[prefix, length, value] : entries)
+    {
+      Insert (prefix, length, value);
+    }
+  m_bulkChanges = 0;
+}
+
+void
+OspfLpmTrie::RebuildIfSparse ()
+{
+  // A trie of n entries needs fewer than 2n nodes
+  if (m_nodes.size () > 4 * m_size + 64)
+    {
+      Rebuild ();
+    }
+}
+
+} // namespace ns3
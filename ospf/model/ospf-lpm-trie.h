@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef OSPF_LPM_TRIE_H
+#define OSPF_LPM_TRIE_H
+
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ *
+ * \brief Path-compressed binary trie for IPv4 longest-prefix match
+ *
+ * Every node holds the whole prefix it stands for and branches on the first
+ * bit past it, so a lookup only visits the prefixes on its path plus the
+ * branching nodes between them. Nodes live in one array. A removal only
+ * clears the value of its node; emptied nodes are reclaimed by rebuilding
+ * the array once they outnumber the entries. A bulk update defers that
+ * check to its end, where a large batch also triggers the rebuild, which
+ * lays the nodes out in depth-first order.
+ */
+class OspfLpmTrie
+{
+public:
+  static constexpr uint32_t NO_VALUE = std::numeric_limits<uint32_t>::max ();
+
+  // <prefix, length, value>
+  typedef std::tuple<uint32_t, uint8_t, uint32_t> Entry;
+
+  // Add or replace the value of a prefix; bits past the length are ignored.
+  // Returns true if the prefix was new.
+  bool Insert (uint32_t prefix, uint8_t length, uint32_t value);
+  // Returns true if the prefix was present
+  bool Remove (uint32_t prefix, uint8_t length);
+  // Value of exactly this prefix, NO_VALUE if absent
+  uint32_t Find (uint32_t prefix, uint8_t length) const;
+  // Value of the longest prefix covering the address, NO_VALUE if none
+  uint32_t Lookup (uint32_t address) const;
+  // Same, but only among values the filter accepts
+  template <typename Filter>
+  uint32_t Lookup (uint32_t address, Filter accept) const;
+
+  uint32_t GetSize () const;
+  uint32_t GetNNodes () const;
+  // Every entry, in <prefix, length> order
+  std::vector<Entry> GetEntries () const;
+  void Clear ();
+
+  // Changes between these only update values; the array is checked for
+  // reclaiming, or rebuilt if most entries changed, at the end. Nests.
+  void BeginBulkUpdate ();
+  void EndBulkUpdate ();
+
+private:
+  static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max ();
+
+  struct Node
+  {
+    uint32_t prefix; // masked to length
+    uint8_t length;
+    uint32_t value; // NO_VALUE for a branching node
+    uint32_t child[2]; // by the bit past length
+  };
+
+  static uint32_t Mask (uint32_t address, uint8_t length);
+  static uint32_t Bit (uint32_t address, uint8_t position);
+  uint32_t AddNode (uint32_t prefix, uint8_t length, uint32_t value);
+  void SetLink (uint32_t parent, uint32_t bit, uint32_t node);
+  void Rebuild ();
+  void RebuildIfSparse ();
+
+  std::vector<Node> m_nodes;
+  uint32_t m_root = NO_NODE;
+  uint32_t m_size = 0;
+  uint32_t m_bulkDepth = 0;
+  uint32_t m_bulkChanges = 0;
+};
+
+inline uint32_t
+OspfLpmTrie::Mask (uint32_t address, uint8_t length)
+{
+  return length == 0 ? 0 : address & (~0u << (32 - length));
+}
+
+inline uint32_t
+OspfLpmTrie::Bit (uint32_t address, uint8_t position)
+{
+  return (address >> (31 - position)) & 1;
+}
+
+template <typename Filter>
+uint32_t
+OspfLpmTrie::Lookup (uint32_t address, Filter accept) const
+{
+  uint32_t best = NO_VALUE;
+  uint32_t index = m_root;
+  while (index != NO_NODE)
+    {
+      const Node &node = m_nodes[index];
+      if (Mask (address, node.length) != node.prefix)
+        {
+          break;
+        }
+      if (node.value != NO_VALUE && accept (node.value))
+        {
+          best = node.value;
+        }
+      if (node.length == 32)
+        {
+          break;
+        }
+      index = node.child[Bit (address, node.length)];
+    }
+  return best;
+}
+
+} // namespace ns3
+
+#endif // OSPF_LPM_TRIE_H
@@ -0,0 +1,372 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ospf-lsdb.h"
+
+#include "ns3/simulator.h"
+
+#include <set>
+
+namespace ns3 {
+
+namespace {
+
+constexpr uint32_t MIN_SLOTS = 16;
+
+template <typename T>
+std::pair<LsaHeader, Ptr<Lsa>>
+GetEntry (const std::vector<OspfLsdbEntry<T>> &entries, uint32_t entry)
+{
+  return {entries[entry].second.first, entries[entry].second.second};
+}
+
+// Heap order for the earliest event first
+bool
+LaterEvent (const EventId &a, const EventId &b)
+{
+  return a.GetTs () > b.GetTs ();
+}
+
+uint64_t
+HashRoutes (uint64_t hash, const std::set<SummaryRoute> &routes, uint64_t (*mix) (uint64_t))
+{
+  for (const SummaryRoute &route : routes)
+    {
+      hash = mix (hash ^ (static_cast<uint64_t> (route.m_address) << 32 | route.m_mask));
+      hash = mix (hash ^ route.m_metric);
+    }
+  return hash;
+}
+
+} // namespace
+
+OspfLsdb::OspfLsdb ()
+{
+  m_slots.resize (MIN_SLOTS);
+}
+
+uint64_t
+OspfLsdb::Hash (Key key)
+{
+  // splitmix64 finalizer; Link-State IDs are router IDs and area IDs, which
+  // tend to differ only in their low bits
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
+uint64_t
+OspfLsdb::HashEntry (uint32_t lsId, const Ptr<RouterLsa> &lsa)
+{
+  if (lsa == nullptr)
+    {
+      return 0;
+    }
+  // Link data and metric only, the fields GetLsdbHash has always compared
+  uint64_t hash = Hash (lsId);
+  for (uint32_t i = 0; i < lsa->GetNLink (); i++)
+    {
+      RouterLink link = lsa->GetLink (i);
+      hash = Hash (hash ^ (static_cast<uint64_t> (link.m_linkData) << 16 | link.m_metric));
+    }
+  return hash;
+}
+
+uint64_t
+OspfLsdb::HashEntry (uint32_t lsId, const Ptr<L1SummaryLsa> &lsa)
+{
+  if (lsa == nullptr)
+    {
+      return 0;
+    }
+  return HashRoutes (Hash (lsId), lsa->GetRoutes (), &Hash);
+}
+
+uint64_t
+OspfLsdb::HashEntry (uint32_t lsId, const Ptr<AreaLsa> &lsa)
+{
+  if (lsa == nullptr)
+    {
+      return 0;
+    }
+  uint64_t hash = Hash (lsId);
+  for (uint32_t i = 0; i < lsa->GetNLink (); i++)
+    {
+      AreaLink link = lsa->GetLink (i);
+      hash = Hash (hash ^ (static_cast<uint64_t> (link.m_areaId) << 32 | link.m_ipAddress));
+      hash = Hash (hash ^ link.m_metric);
+    }
+  return hash;
+}
+
+uint64_t
+OspfLsdb::HashEntry (uint32_t lsId, const Ptr<L2SummaryLsa> &lsa)
+{
+  if (lsa == nullptr)
+    {
+      return 0;
+    }
+  return HashRoutes (Hash (lsId), lsa->GetRoutes (), &Hash);
+}
+
+uint32_t
+OspfLsdb::FindSlot (Key key) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  for (uint32_t i = Hash (key) & mask;; i = (i + 1) & mask)
+    {
+      if (m_slots[i].key == key)
+        {
+          return i;
+        }
+      if (m_slots[i].key == NO_KEY)
+        {
+          return NO_INDEX;
+        }
+    }
+}
+
+uint32_t
+OspfLsdb::InsertSlot (Key key)
+{
+  uint32_t slot = FindSlot (key);
+  if (slot != NO_INDEX)
+    {
+      return slot;
+    }
+  // Keep at most half of the slots in use so probes stay short
+  if (2 * (m_nKeys + 1) > m_slots.size ())
+    {
+      Rehash (2 * m_slots.size ());
+    }
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t i = Hash (key) & mask;
+  while (m_slots[i].key != NO_KEY)
+    {
+      i = (i + 1) & mask;
+    }
+  m_slots[i].key = key;
+  m_nKeys++;
+  return i;
+}
+
+void
+OspfLsdb::EraseSlot (uint32_t slot)
+{
+  // Shift the rest of the probe run back over the hole instead of leaving a
+  // tombstone
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t hole = slot;
+  for (uint32_t i = (hole + 1) & mask; m_slots[i].key != NO_KEY; i = (i + 1) & mask)
+    {
+      uint32_t home = Hash (m_slots[i].key) & mask;
+      if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+          m_slots[hole] = std::move (m_slots[i]);
+          hole = i;
+        }
+    }
+  m_slots[hole] = Slot ();
+  m_nKeys--;
+}
+
+void
+OspfLsdb::Rehash (uint32_t capacity)
+{
+  std::vector<Slot> slots (capacity);
+  std::swap (slots, m_slots);
+  uint32_t mask = capacity - 1;
+  for (Slot &slot : slots)
+    {
+      if (slot.key == NO_KEY)
+        {
+          continue;
+        }
+      uint32_t i = Hash (slot.key) & mask;
+      while (m_slots[i].key != NO_KEY)
+        {
+          i = (i + 1) & mask;
+        }
+      m_slots[i] = std::move (slot);
+    }
+}
+
+std::pair<LsaHeader, Ptr<Lsa>>
+OspfLsdb::Fetch (const LsaHeader::LsaKey &lsaKey) const
+{
+  uint8_t type = std::get<0> (lsaKey);
+  uint32_t slot = FindSlot (PackKey (type, std::get<1> (lsaKey)));
+  if (slot == NO_INDEX || m_slots[slot].entry == NO_INDEX)
+    {
+      return {LsaHeader (), nullptr};
+    }
+  uint32_t entry = m_slots[slot].entry;
+  switch (type)
+    {
+    case LsaHeader::RouterLSAs:
+      return GetEntry (GetTable<RouterLsa> ().entries, entry);
+    case LsaHeader::L1SummaryLSAs:
+      return GetEntry (GetTable<L1SummaryLsa> ().entries, entry);
+    case LsaHeader::AreaLSAs:
+      return GetEntry (GetTable<AreaLsa> ().entries, entry);
+    case LsaHeader::L2SummaryLSAs:
+      return GetEntry (GetTable<L2SummaryLsa> ().entries, entry);
+    default:
+      return {LsaHeader (), nullptr};
+    }
+}
+
+uint16_t
+OspfLsdb::GetSeqNum (const LsaHeader::LsaKey &lsaKey) const
+{
+  uint32_t slot = FindSlot (PackKey (std::get<0> (lsaKey), std::get<1> (lsaKey)));
+  if (slot == NO_INDEX)
+    {
+      return 0;
+    }
+  for (const auto &[advertisingRouter, seqNum] : m_slots[slot].seqNums)
+    {
+      if (advertisingRouter == std::get<2> (lsaKey))
+        {
+          return seqNum;
+        }
+    }
+  return 0;
+}
+
+void
+OspfLsdb::SetSeqNum (const LsaHeader::LsaKey &lsaKey, uint16_t seqNum)
+{
+  Slot &slot = m_slots[InsertSlot (PackKey (std::get<0> (lsaKey), std::get<1> (lsaKey)))];
+  for (auto &[advertisingRouter, stored] : slot.seqNums)
+    {
+      if (advertisingRouter == std::get<2> (lsaKey))
+        {
+          stored = seqNum;
+          return;
+        }
+    }
+  slot.seqNums.emplace_back (std::get<2> (lsaKey), seqNum);
+}
+
+void
+OspfLsdb::EraseSeqNum (const LsaHeader::LsaKey &lsaKey)
+{
+  uint32_t slot = FindSlot (PackKey (std::get<0> (lsaKey), std::get<1> (lsaKey)));
+  if (slot == NO_INDEX)
+    {
+      return;
+    }
+  auto &seqNums = m_slots[slot].seqNums;
+  seqNums.erase (std::remove_if (seqNums.begin (), seqNums.end (),
+                                 [&lsaKey] (const std::pair<uint32_t, uint16_t> &seqNum) {
+                                   return seqNum.first == std::get<2> (lsaKey);
+                                 }),
+                 seqNums.end ());
+  if (m_slots[slot].entry == NO_INDEX && seqNums.empty () &&
+      !m_slots[slot].origination.originated)
+    {
+      EraseSlot (slot);
+    }
+}
+
+OspfLsdb::Origination &
+OspfLsdb::GetOrigination (const LsaHeader::LsaKey &lsaKey)
+{
+  return m_slots[InsertSlot (PackKey (std::get<0> (lsaKey), std::get<1> (lsaKey)))].origination;
+}
+
+void
+OspfLsdb::DeferOrigination (const LsaHeader::LsaKey &lsaKey, const EventId &event)
+{
+  GetOrigination (lsaKey).pending = event;
+  m_pendingOriginations.push_back (event);
+  std::push_heap (m_pendingOriginations.begin (), m_pendingOriginations.end (), &LaterEvent);
+}
+
+Time
+OspfLsdb::GetPendingOriginationDelay () const
+{
+  while (!m_pendingOriginations.empty () && !m_pendingOriginations.front ().IsRunning ())
+    {
+      std::pop_heap (m_pendingOriginations.begin (), m_pendingOriginations.end (), &LaterEvent);
+      m_pendingOriginations.pop_back ();
+    }
+  if (m_pendingOriginations.empty ())
+    {
+      return Time::Max ();
+    }
+  return Simulator::GetDelayLeft (m_pendingOriginations.front ());
+}
+
+uint64_t
+OspfLsdb::GetDigest ()
+{
+  uint64_t digest = Hash (GetDigest<RouterLsa> ());
+  digest = Hash (digest ^ GetDigest<L1SummaryLsa> ());
+  digest = Hash (digest ^ GetDigest<AreaLsa> ());
+  return Hash (digest ^ GetDigest<L2SummaryLsa> ());
+}
+
+uint64_t
+OspfLsdb::GetL1Digest ()
+{
+  return Hash (Hash (GetDigest<RouterLsa> ()) ^ GetDigest<L1SummaryLsa> ());
+}
+
+uint64_t
+OspfLsdb::GetL2Digest ()
+{
+  return Hash (Hash (GetDigest<AreaLsa> ()) ^ GetDigest<L2SummaryLsa> ());
+}
+
+uint32_t
+OspfLsdb::GetNLsas () const
+{
+  return m_nLsas;
+}
+
+uint32_t
+OspfLsdb::GetNKeys () const
+{
+  return m_nKeys;
+}
+
+void
+OspfLsdb::Clear ()
+{
+  for (Slot &slot : m_slots)
+    {
+      if (slot.origination.pending.IsRunning ())
+        {
+          Simulator::Cancel (slot.origination.pending);
+        }
+    }
+  m_slots.assign (MIN_SLOTS, Slot ());
+  m_pendingOriginations.clear ();
+  m_nKeys = 0;
+  m_nLsas = 0;
+  m_tables = decltype (m_tables) ();
+}
+
+} // namespace ns3
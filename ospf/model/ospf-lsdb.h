@@ -0,0 +1,582 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef OSPF_LSDB_H
+#define OSPF_LSDB_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/lsa-header.h"
+#include "ns3/lsa.h"
+#include "ns3/router-lsa.h"
+#include "ns3/l1-summary-lsa.h"
+#include "ns3/area-lsa.h"
+#include "ns3/l2-summary-lsa.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+// <Link-State ID, <header, body>>, what a typed view iterates over
+template <typename T>
+using OspfLsdbEntry = std::pair<uint32_t, std::pair<LsaHeader, Ptr<T>>>;
+
+// LS type stored under each LSA body
+template <typename T>
+struct OspfLsdbType;
+template <>
+struct OspfLsdbType<RouterLsa>
+{
+  static const uint8_t value = LsaHeader::RouterLSAs;
+};
+template <>
+struct OspfLsdbType<L1SummaryLsa>
+{
+  static const uint8_t value = LsaHeader::L1SummaryLSAs;
+};
+template <>
+struct OspfLsdbType<AreaLsa>
+{
+  static const uint8_t value = LsaHeader::AreaLSAs;
+};
+template <>
+struct OspfLsdbType<L2SummaryLsa>
+{
+  static const uint8_t value = LsaHeader::L2SummaryLSAs;
+};
+
+template <typename T>
+class OspfLsdbView;
+
+/**
+ * \ingroup ospf
+ *
+ * \brief Link-state database of every LSA type
+ *
+ * LSAs are found by their LS type and Link-State ID packed into one 64-bit
+ * key. The advertising router is left out: each type keeps one instance per
+ * Link-State ID. One open-addressing table maps the key to the sequence
+ * numbers heard for it, per advertising router, the origination state of our
+ * own instance, and the position of the installed header and body in the
+ * array of their type. A received LSA is checked and installed with a single
+ * probe.
+ *
+ * OspfLsdbView gives each type the interface of a map from Link-State ID to
+ * <header, body>, iterated in Link-State ID order. The arrays are unordered;
+ * the order is rebuilt when iterating after an LSA was added or removed.
+ *
+ * Each type also keeps an order-independent 64-bit digest of its LSAs: the
+ * sum of one hash per LSA, over its Link-State ID and body. Hashes are added
+ * and subtracted as LSAs are installed and removed. The entry last given out
+ * by operator [] is hashed on the next operation on its type, once the caller
+ * has stored into it.
+ */
+class OspfLsdb
+{
+public:
+  typedef uint64_t Key;
+
+  // State of an LSA we originate
+  struct Origination
+  {
+    bool originated = false;
+    Time last; //!< Last origination, for MinLSInterval
+    EventId pending; //!< Deferred re-origination
+  };
+
+  OspfLsdb ();
+  OspfLsdb (const OspfLsdb &) = delete;
+  OspfLsdb &operator= (const OspfLsdb &) = delete;
+
+  static Key PackKey (uint8_t type, uint32_t lsId);
+  static uint8_t GetType (Key key);
+  static uint32_t GetLsId (Key key);
+
+  // Installed instance under the type and Link-State ID of the key,
+  // {LsaHeader (), nullptr} if there is none
+  std::pair<LsaHeader, Ptr<Lsa>> Fetch (const LsaHeader::LsaKey &lsaKey) const;
+
+  // Last sequence number heard from the key's advertising router, 0 if none
+  uint16_t GetSeqNum (const LsaHeader::LsaKey &lsaKey) const;
+  void SetSeqNum (const LsaHeader::LsaKey &lsaKey, uint16_t seqNum);
+  // Forget the sequence number; the key goes with it once nothing else is kept
+  void EraseSeqNum (const LsaHeader::LsaKey &lsaKey);
+
+  // Added on first use; valid until the next LSA is added
+  Origination &GetOrigination (const LsaHeader::LsaKey &lsaKey);
+  // Store event as the key's pending re-origination; cancel it through
+  // Simulator::Cancel as usual
+  void DeferOrigination (const LsaHeader::LsaKey &lsaKey, const EventId &event);
+  // Time to the first deferred re-origination, Time::Max () if there is none.
+  // Amortized O(log n) in the deferrals, no scan of the keys.
+  Time GetPendingOriginationDelay () const;
+
+  // Digest of the installed LSAs of type T; equal LSDBs have equal digests
+  template <typename T>
+  uint64_t GetDigest ();
+  // Digest of the LSAs of every type
+  uint64_t GetDigest ();
+  // Digests of the L1 (Router, L1 Summary) and L2 (Area, L2 Summary) LSAs
+  uint64_t GetL1Digest ();
+  uint64_t GetL2Digest ();
+
+  // Installed LSAs of every type
+  uint32_t GetNLsas () const;
+  // Keys with an LSA, a sequence number or origination state
+  uint32_t GetNKeys () const;
+
+  // Also cancels pending re-originations
+  void Clear ();
+
+private:
+  template <typename T>
+  friend class OspfLsdbView;
+
+  static constexpr Key NO_KEY = std::numeric_limits<Key>::max ();
+  static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max ();
+
+  struct Slot
+  {
+    Key key = NO_KEY;
+    uint32_t entry = NO_INDEX; //!< Position in the array of the type
+    std::vector<std::pair<uint32_t, uint16_t>> seqNums; //!< <advertising router, seq num>
+    Origination origination;
+  };
+
+  template <typename T>
+  struct Table
+  {
+    std::vector<OspfLsdbEntry<T>> entries;
+    std::vector<uint32_t> order; //!< Positions in Link-State ID order
+    bool sorted = true;
+    // Per entry, the body counted in the digest and its hash
+    std::vector<std::pair<Ptr<T>, uint64_t>> hashes;
+    uint64_t digest = 0; //!< Sum of the hashes
+    bool pending = false; //!< An entry was given out by operator []
+    uint32_t pendingLsId = 0;
+  };
+
+  static uint64_t Hash (Key key);
+  // What an LSA adds to the digest of its type; nothing while it has no body
+  static uint64_t HashEntry (uint32_t lsId, const Ptr<RouterLsa> &lsa);
+  static uint64_t HashEntry (uint32_t lsId, const Ptr<L1SummaryLsa> &lsa);
+  static uint64_t HashEntry (uint32_t lsId, const Ptr<AreaLsa> &lsa);
+  static uint64_t HashEntry (uint32_t lsId, const Ptr<L2SummaryLsa> &lsa);
+  uint32_t FindSlot (Key key) const;
+  uint32_t InsertSlot (Key key);
+  void EraseSlot (uint32_t slot);
+  void Rehash (uint32_t capacity);
+
+  template <typename T>
+  Table<T> &GetTable ();
+  template <typename T>
+  const Table<T> &GetTable () const;
+  // Position of the entry, NO_INDEX if not installed
+  template <typename T>
+  uint32_t FindEntry (uint32_t lsId) const;
+  // Adds an empty entry if not installed
+  template <typename T>
+  uint32_t InsertEntry (uint32_t lsId);
+  // Returns true if it was installed. Sequence numbers are kept.
+  template <typename T>
+  bool EraseEntry (uint32_t lsId);
+  template <typename T>
+  void ClearEntries ();
+  template <typename T>
+  const std::vector<uint32_t> &GetOrder ();
+  // Brings the digest up to date with the entry last given out
+  template <typename T>
+  void HashPending ();
+
+  std::vector<Slot> m_slots;
+  // Min-heap by expiry of the deferred re-originations. Fired and cancelled
+  // ones are dropped once they reach the top.
+  mutable std::vector<EventId> m_pendingOriginations;
+  uint32_t m_nKeys = 0;
+  uint32_t m_nLsas = 0;
+  std::tuple<Table<RouterLsa>, Table<L1SummaryLsa>, Table<AreaLsa>, Table<L2SummaryLsa>> m_tables;
+};
+
+/**
+ * \ingroup ospf
+ *
+ * \brief The LSAs of one type in an OspfLsdb, as a map from Link-State ID
+ *
+ * Iterators are invalidated by adding or removing an LSA of the same type. An
+ * iterator from find () does not advance to the next LSA; incrementing it
+ * gives end ().
+ */
+template <typename T>
+class OspfLsdbView
+{
+public:
+  typedef OspfLsdbEntry<T> value_type;
+  typedef typename value_type::second_type mapped_type;
+
+  class iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef OspfLsdbEntry<T> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef value_type *pointer;
+    typedef value_type &reference;
+
+    iterator ();
+    value_type &operator* () const;
+    value_type *operator-> () const;
+    iterator &operator++ ();
+    bool operator== (const iterator &other) const;
+    bool operator!= (const iterator &other) const;
+
+  private:
+    friend class OspfLsdbView;
+    iterator (std::vector<value_type> *entries, const uint32_t *position, const uint32_t *last);
+
+    std::vector<value_type> *m_entries;
+    const uint32_t *m_position; //!< nullptr at the end
+    const uint32_t *m_last; //!< End of the order, nullptr from find ()
+  };
+
+  explicit OspfLsdbView (OspfLsdb &lsdb);
+
+  iterator begin () const;
+  iterator end () const;
+  bool empty () const;
+  std::size_t size () const;
+  iterator find (uint32_t lsId) const;
+  std::size_t count (uint32_t lsId) const;
+  // Adds an empty <header, body> if absent, like std::map
+  mapped_type &operator[] (uint32_t lsId);
+  std::size_t erase (uint32_t lsId);
+  void clear ();
+
+private:
+  OspfLsdb *m_lsdb;
+};
+
+inline OspfLsdb::Key
+OspfLsdb::PackKey (uint8_t type, uint32_t lsId)
+{
+  return (static_cast<Key> (type) << 32) | lsId;
+}
+
+inline uint8_t
+OspfLsdb::GetType (Key key)
+{
+  return static_cast<uint8_t> (key >> 32);
+}
+
+inline uint32_t
+OspfLsdb::GetLsId (Key key)
+{
+  return static_cast<uint32_t> (key);
+}
+
+template <typename T>
+OspfLsdb::Table<T> &
+OspfLsdb::GetTable ()
+{
+  return std::get<Table<T>> (m_tables);
+}
+
+template <typename T>
+const OspfLsdb::Table<T> &
+OspfLsdb::GetTable () const
+{
+  return std::get<Table<T>> (m_tables);
+}
+
+template <typename T>
+uint32_t
+OspfLsdb::FindEntry (uint32_t lsId) const
+{
+  uint32_t slot = FindSlot (PackKey (OspfLsdbType<T>::value, lsId));
+  return slot == NO_INDEX ? NO_INDEX : m_slots[slot].entry;
+}
+
+template <typename T>
+uint32_t
+OspfLsdb::InsertEntry (uint32_t lsId)
+{
+  HashPending<T> ();
+  Table<T> &table = GetTable<T> ();
+  uint32_t slot = InsertSlot (PackKey (OspfLsdbType<T>::value, lsId));
+  if (m_slots[slot].entry == NO_INDEX)
+    {
+      m_slots[slot].entry = table.entries.size ();
+      table.entries.emplace_back (lsId, typename OspfLsdbEntry<T>::second_type ());
+      table.hashes.emplace_back (nullptr, 0);
+      table.sorted = false;
+      m_nLsas++;
+    }
+  // The caller may store a new instance through the entry
+  table.pending = true;
+  table.pendingLsId = lsId;
+  return m_slots[slot].entry;
+}
+
+template <typename T>
+bool
+OspfLsdb::EraseEntry (uint32_t lsId)
+{
+  HashPending<T> ();
+  uint32_t slot = FindSlot (PackKey (OspfLsdbType<T>::value, lsId));
+  if (slot == NO_INDEX || m_slots[slot].entry == NO_INDEX)
+    {
+      return false;
+    }
+  uint32_t entry = m_slots[slot].entry;
+  m_slots[slot].entry = NO_INDEX;
+  // Sequence numbers outlive the instance
+  if (m_slots[slot].seqNums.empty () && !m_slots[slot].origination.originated)
+    {
+      EraseSlot (slot);
+    }
+
+  // Move the last entry into the hole
+  Table<T> &table = GetTable<T> ();
+  table.digest -= table.hashes[entry].second;
+  if (entry + 1 != table.entries.size ())
+    {
+      table.entries[entry] = std::move (table.entries.back ());
+      table.hashes[entry] = std::move (table.hashes.back ());
+      m_slots[FindSlot (PackKey (OspfLsdbType<T>::value, table.entries[entry].first))].entry =
+          entry;
+    }
+  table.entries.pop_back ();
+  table.hashes.pop_back ();
+  table.sorted = false;
+  m_nLsas--;
+  return true;
+}
+
+template <typename T>
+void
+OspfLsdb::ClearEntries ()
+{
+  Table<T> &table = GetTable<T> ();
+  while (!table.entries.empty ())
+    {
+      EraseEntry<T> (table.entries.back ().first);
+    }
+}
+
+template <typename T>
+const std::vector<uint32_t> &
+OspfLsdb::GetOrder ()
+{
+  Table<T> &table = GetTable<T> ();
+  if (!table.sorted)
+    {
+      table.order.resize (table.entries.size ());
+      std::iota (table.order.begin (), table.order.end (), 0);
+      std::sort (table.order.begin (), table.order.end (), [&table] (uint32_t a, uint32_t b) {
+        return table.entries[a].first < table.entries[b].first;
+      });
+      table.sorted = true;
+    }
+  return table.order;
+}
+
+template <typename T>
+void
+OspfLsdb::HashPending ()
+{
+  Table<T> &table = GetTable<T> ();
+  if (!table.pending)
+    {
+      return;
+    }
+  table.pending = false;
+  uint32_t entry = FindEntry<T> (table.pendingLsId);
+  if (entry == NO_INDEX)
+    {
+      return;
+    }
+  const Ptr<T> &body = table.entries[entry].second.second;
+  auto &[hashed, hash] = table.hashes[entry];
+  // Bodies do not change once installed, so the same body has the same hash
+  if (body == hashed)
+    {
+      return;
+    }
+  uint64_t updated = HashEntry (table.pendingLsId, body);
+  table.digest += updated - hash;
+  hashed = body;
+  hash = updated;
+}
+
+template <typename T>
+uint64_t
+OspfLsdb::GetDigest ()
+{
+  HashPending<T> ();
+  return GetTable<T> ().digest;
+}
+
+template <typename T>
+OspfLsdbView<T>::iterator::iterator ()
+    : m_entries (nullptr), m_position (nullptr), m_last (nullptr)
+{
+}
+
+template <typename T>
+OspfLsdbView<T>::iterator::iterator (std::vector<value_type> *entries, const uint32_t *position,
+                                     const uint32_t *last)
+    : m_entries (entries), m_position (position), m_last (last)
+{
+}
+
+template <typename T>
+typename OspfLsdbView<T>::value_type &
+OspfLsdbView<T>::iterator::operator* () const
+{
+  return (*m_entries)[*m_position];
+}
+
+template <typename T>
+typename OspfLsdbView<T>::value_type *
+OspfLsdbView<T>::iterator::operator-> () const
+{
+  return &(*m_entries)[*m_position];
+}
+
+template <typename T>
+typename OspfLsdbView<T>::iterator &
+OspfLsdbView<T>::iterator::operator++ ()
+{
+  if (m_last == nullptr || ++m_position == m_last)
+    {
+      m_position = nullptr;
+    }
+  return *this;
+}
+
+template <typename T>
+bool
+OspfLsdbView<T>::iterator::operator== (const iterator &other) const
+{
+  if (m_position == nullptr || other.m_position == nullptr)
+    {
+      return m_position == other.m_position;
+    }
+  return *m_position == *other.m_position;
+}
+
+template <typename T>
+bool
+OspfLsdbView<T>::iterator::operator!= (const iterator &other) const
+{
+  return !(*this == other);
+}
+
+template <typename T>
+OspfLsdbView<T>::OspfLsdbView (OspfLsdb &lsdb)
+    : m_lsdb (&lsdb)
+{
+}
+
+template <typename T>
+typename OspfLsdbView<T>::iterator
+OspfLsdbView<T>::begin () const
+{
+  const std::vector<uint32_t> &order = m_lsdb->GetOrder<T> ();
+  if (order.empty ())
+    {
+      return end ();
+    }
+  return iterator (&m_lsdb->GetTable<T> ().entries, order.data (), order.data () + order.size ());
+}
+
+template <typename T>
+typename OspfLsdbView<T>::iterator
+OspfLsdbView<T>::end () const
+{
+  return iterator (&m_lsdb->GetTable<T> ().entries, nullptr, nullptr);
+}
+
+template <typename T>
+bool
+OspfLsdbView<T>::empty () const
+{
+  return size () == 0;
+}
+
+template <typename T>
+std::size_t
+OspfLsdbView<T>::size () const
+{
+  return m_lsdb->GetTable<T> ().entries.size ();
+}
+
+template <typename T>
+typename OspfLsdbView<T>::iterator
+OspfLsdbView<T>::find (uint32_t lsId) const
+{
+  uint32_t slot = m_lsdb->FindSlot (OspfLsdb::PackKey (OspfLsdbType<T>::value, lsId));
+  if (slot == OspfLsdb::NO_INDEX || m_lsdb->m_slots[slot].entry == OspfLsdb::NO_INDEX)
+    {
+      return end ();
+    }
+  return iterator (&m_lsdb->GetTable<T> ().entries, &m_lsdb->m_slots[slot].entry, nullptr);
+}
+
+template <typename T>
+std::size_t
+OspfLsdbView<T>::count (uint32_t lsId) const
+{
+  return m_lsdb->FindEntry<T> (lsId) != OspfLsdb::NO_INDEX;
+}
+
+template <typename T>
+typename OspfLsdbView<T>::mapped_type &
+OspfLsdbView<T>::operator[] (uint32_t lsId)
+{
+  uint32_t entry = m_lsdb->InsertEntry<T> (lsId);
+  return m_lsdb->GetTable<T> ().entries[entry].second;
+}
+
+template <typename T>
+std::size_t
+OspfLsdbView<T>::erase (uint32_t lsId)
+{
+  return m_lsdb->EraseEntry<T> (lsId);
+}
+
+template <typename T>
+void
+OspfLsdbView<T>::clear ()
+{
+  m_lsdb->ClearEntries<T> ();
+}
+
+} // namespace ns3
+
+#endif // OSPF_LSDB_H
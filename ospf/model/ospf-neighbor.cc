@@ -373,6 +373,12 @@ OspfNeighbor::RemoveKeyedTimeout (LsaHeader::LsaKey lsaKey)
     }
   return false;
 }
+bool
+OspfNeighbor::HasKeyedTimeout (LsaHeader::LsaKey lsaKey) const
+{
+  auto it = m_keyedTimeouts.find (lsaKey);
+  return it != m_keyedTimeouts.end () && it->second.IsRunning ();
+}
 void
 OspfNeighbor::ClearKeyedTimeouts (void)
 {
@@ -128,6 +128,8 @@ public:
   void BindKeyedTimeout (LsaHeader::LsaKey lsaKey, EventId event);
   EventId GetKeyedTimeout (LsaHeader::LsaKey lsaKey);
   bool RemoveKeyedTimeout (LsaHeader::LsaKey lsaKey);
+  // Still waiting for an ack of the LSA
+  bool HasKeyedTimeout (LsaHeader::LsaKey lsaKey) const;
   void ClearKeyedTimeouts ();
 
   // Neighbor-specific timeout
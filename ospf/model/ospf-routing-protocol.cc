@@ -0,0 +1,609 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ospf-routing-protocol.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OspfRoutingProtocol");
+
+NS_OBJECT_ENSURE_REGISTERED (OspfRoutingProtocol);
+
+namespace {
+
+// Final mix of MurmurHash3
+uint32_t
+Mix (uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+} // namespace
+
+TypeId
+OspfRoutingProtocol::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OspfRoutingProtocol")
+                          .SetParent<Ipv4RoutingProtocol> ()
+                          .SetGroupName ("Ospf")
+                          .AddConstructor<OspfRoutingProtocol> ()
+                          .AddAttribute ("FlowCacheSize",
+                                         "Number of destinations whose lookup is cached, 0 to disable the cache",
+                                         UintegerValue (0),
+                                         MakeUintegerAccessor (&OspfRoutingProtocol::SetFlowCacheSize,
+                                                               &OspfRoutingProtocol::GetFlowCacheSize),
+                                         MakeUintegerChecker<uint32_t> ())
+                          .AddAttribute ("FlowCacheHits", "Number of lookups answered by the cache",
+                                         TypeId::ATTR_GET, UintegerValue (0),
+                                         MakeUintegerAccessor (&OspfRoutingProtocol::GetFlowCacheHits),
+                                         MakeUintegerChecker<uint64_t> ())
+                          .AddAttribute ("FlowCacheMisses",
+                                         "Number of cached lookups that went to the routing table",
+                                         TypeId::ATTR_GET, UintegerValue (0),
+                                         MakeUintegerAccessor (&OspfRoutingProtocol::GetFlowCacheMisses),
+                                         MakeUintegerChecker<uint64_t> ());
+  return tid;
+}
+
+OspfRoutingProtocol::OspfRoutingProtocol ()
+  : m_ipv4 (nullptr),
+    m_hashSeed (0),
+    m_generation (0),
+    m_flowCacheSize (0),
+    m_flowCacheHand (0),
+    m_flowCacheHits (0),
+    m_flowCacheMisses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OspfRoutingProtocol::~OspfRoutingProtocol ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+OspfRoutingProtocol::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  m_resolver = RouteResolver ();
+  m_ipv4 = nullptr;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+OspfRoutingProtocol::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                                        const std::vector<Path> &paths, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << network << networkMask << paths.size () << metric);
+  NS_ASSERT_MSG (!paths.empty (), "OspfRoutingProtocol: a route needs at least one path");
+  SetRoute (network, networkMask, Route{NextHops{paths, metric}, 0});
+}
+
+void
+OspfRoutingProtocol::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                                        uint32_t group)
+{
+  NS_LOG_FUNCTION (this << network << networkMask << group);
+  NS_ASSERT_MSG (group != 0, "OspfRoutingProtocol: next-hop group 0 is reserved");
+  SetRoute (network, networkMask, Route{NextHops{{}, 0}, group});
+}
+
+void
+OspfRoutingProtocol::SetRoute (Ipv4Address network, Ipv4Mask networkMask, const Route &route)
+{
+  m_generation++;
+  uint8_t length = networkMask.GetPrefixLength ();
+  uint32_t slot = m_trie.Find (network.Get (), length);
+  if (slot == OspfLpmTrie::NO_VALUE)
+    {
+      if (m_freeSlots.empty ())
+        {
+          slot = m_slots.size ();
+          m_slots.emplace_back ();
+        }
+      else
+        {
+          slot = m_freeSlots.back ();
+          m_freeSlots.pop_back ();
+        }
+      m_trie.Insert (network.Get (), length, slot);
+    }
+  m_slots[slot] = route;
+  m_slots[slot].length = length;
+}
+
+void
+OspfRoutingProtocol::SetNextHopGroup (uint32_t group, const std::vector<Path> &paths,
+                                      uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << group << paths.size () << metric);
+  NS_ASSERT_MSG (group != 0, "OspfRoutingProtocol: next-hop group 0 is reserved");
+  m_generation++;
+  m_groups[group] = NextHops{paths, metric};
+}
+
+bool
+OspfRoutingProtocol::RemoveNextHopGroup (uint32_t group)
+{
+  NS_LOG_FUNCTION (this << group);
+  m_generation++;
+  return m_groups.erase (group) > 0;
+}
+
+uint32_t
+OspfRoutingProtocol::GetNNextHopGroups (void) const
+{
+  return m_groups.size ();
+}
+
+bool
+OspfRoutingProtocol::RemoveNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask)
+{
+  NS_LOG_FUNCTION (this << network << networkMask);
+  uint8_t length = networkMask.GetPrefixLength ();
+  uint32_t slot = m_trie.Find (network.Get (), length);
+  if (slot == OspfLpmTrie::NO_VALUE)
+    {
+      return false;
+    }
+  m_generation++;
+  m_trie.Remove (network.Get (), length);
+  m_slots[slot] = Route{};
+  m_freeSlots.push_back (slot);
+  return true;
+}
+
+void
+OspfRoutingProtocol::AddDiscardRouteTo (Ipv4Address network, Ipv4Mask networkMask)
+{
+  NS_LOG_FUNCTION (this << network << networkMask);
+  uint8_t length = networkMask.GetPrefixLength ();
+  if (m_discards.Insert (network.Get (), length, length))
+    {
+      m_generation++;
+    }
+}
+
+bool
+OspfRoutingProtocol::RemoveDiscardRouteTo (Ipv4Address network, Ipv4Mask networkMask)
+{
+  NS_LOG_FUNCTION (this << network << networkMask);
+  if (!m_discards.Remove (network.Get (), networkMask.GetPrefixLength ()))
+    {
+      return false;
+    }
+  m_generation++;
+  return true;
+}
+
+bool
+OspfRoutingProtocol::IsDiscardRoute (Ipv4Address network, Ipv4Mask networkMask) const
+{
+  return m_discards.Find (network.Get (), networkMask.GetPrefixLength ()) !=
+         OspfLpmTrie::NO_VALUE;
+}
+
+uint32_t
+OspfRoutingProtocol::GetNDiscardRoutes (void) const
+{
+  return m_discards.GetSize ();
+}
+
+void
+OspfRoutingProtocol::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_generation++;
+  m_trie.Clear ();
+  m_slots.clear ();
+  m_freeSlots.clear ();
+  m_groups.clear ();
+  m_discards.Clear ();
+}
+
+uint32_t
+OspfRoutingProtocol::GetNRoutes (void) const
+{
+  return m_trie.GetSize ();
+}
+
+void
+OspfRoutingProtocol::BeginBulkUpdate (void)
+{
+  m_trie.BeginBulkUpdate ();
+}
+
+void
+OspfRoutingProtocol::EndBulkUpdate (void)
+{
+  m_trie.EndBulkUpdate ();
+}
+
+std::vector<OspfRoutingProtocol::Path>
+OspfRoutingProtocol::GetPaths (Ipv4Address network, Ipv4Mask networkMask) const
+{
+  uint32_t slot = m_trie.Find (network.Get (), networkMask.GetPrefixLength ());
+  const NextHops *hops = slot == OspfLpmTrie::NO_VALUE ? nullptr : Resolve (m_slots[slot]);
+  if (hops == nullptr)
+    {
+      return {};
+    }
+  return hops->paths;
+}
+
+void
+OspfRoutingProtocol::SetHashSeed (uint32_t seed)
+{
+  m_hashSeed = seed;
+}
+
+void
+OspfRoutingProtocol::SetFlowCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_flowCacheSize = size;
+  m_flowCache.clear ();
+  m_flowCache.reserve (size);
+  m_flowCacheIndex.clear ();
+  m_flowCacheHand = 0;
+}
+
+uint32_t
+OspfRoutingProtocol::GetFlowCacheSize (void) const
+{
+  return m_flowCacheSize;
+}
+
+uint64_t
+OspfRoutingProtocol::GetFlowCacheHits (void) const
+{
+  return m_flowCacheHits;
+}
+
+uint64_t
+OspfRoutingProtocol::GetFlowCacheMisses (void) const
+{
+  return m_flowCacheMisses;
+}
+
+void
+OspfRoutingProtocol::ResetFlowCacheStats (void)
+{
+  m_flowCacheHits = 0;
+  m_flowCacheMisses = 0;
+}
+
+uint64_t
+OspfRoutingProtocol::GetGeneration (void) const
+{
+  return m_generation;
+}
+
+void
+OspfRoutingProtocol::FlushFlowCache (void)
+{
+  m_generation++;
+}
+
+void
+OspfRoutingProtocol::SetRouteResolver (RouteResolver resolver)
+{
+  NS_LOG_FUNCTION (this);
+  m_resolver = resolver;
+  m_generation++;
+}
+
+const OspfRoutingProtocol::NextHops *
+OspfRoutingProtocol::Resolve (const Route &route) const
+{
+  const NextHops *hops = &route.own;
+  if (route.group != 0)
+    {
+      auto it = m_groups.find (route.group);
+      hops = it == m_groups.end () ? nullptr : &it->second;
+    }
+  return hops == nullptr || hops->paths.empty () ? nullptr : hops;
+}
+
+const OspfRoutingProtocol::NextHops *
+OspfRoutingProtocol::LookupRoute (Ipv4Address dest) const
+{
+  // Unresolved routes fall through to shorter prefixes
+  uint32_t slot = m_trie.Lookup (dest.Get (), [this] (uint32_t candidate) {
+    return Resolve (m_slots[candidate]) != nullptr;
+  });
+  // A route as long as the discard route wins
+  uint32_t discard =
+      m_discards.GetSize () == 0 ? OspfLpmTrie::NO_VALUE : m_discards.Lookup (dest.Get ());
+  if (discard != OspfLpmTrie::NO_VALUE &&
+      (slot == OspfLpmTrie::NO_VALUE || m_slots[slot].length < discard))
+    {
+      return &m_discardRoute;
+    }
+  return slot == OspfLpmTrie::NO_VALUE ? nullptr : Resolve (m_slots[slot]);
+}
+
+const OspfRoutingProtocol::NextHops *
+OspfRoutingProtocol::ResolveRoute (Ipv4Address dest)
+{
+  const NextHops *route = LookupRoute (dest);
+  if (route == nullptr && !m_resolver.IsNull () && m_resolver (dest))
+    {
+      route = LookupRoute (dest);
+    }
+  return route;
+}
+
+const OspfRoutingProtocol::NextHops *
+OspfRoutingProtocol::CachedLookupRoute (Ipv4Address dest)
+{
+  if (m_flowCacheSize == 0)
+    {
+      return ResolveRoute (dest);
+    }
+
+  // Entries take the generation after the lookup, which may add a route
+  auto it = m_flowCacheIndex.find (dest.Get ());
+  if (it != m_flowCacheIndex.end ())
+    {
+      FlowCacheEntry &entry = m_flowCache[it->second];
+      if (entry.generation == m_generation)
+        {
+          m_flowCacheHits++;
+          entry.referenced = true;
+          return entry.route;
+        }
+      // Stale: refresh in place
+      m_flowCacheMisses++;
+      entry.route = ResolveRoute (dest);
+      entry.generation = m_generation;
+      entry.referenced = true;
+      return entry.route;
+    }
+
+  m_flowCacheMisses++;
+  const NextHops *route = ResolveRoute (dest);
+  if (m_flowCache.size () < m_flowCacheSize)
+    {
+      m_flowCacheIndex[dest.Get ()] = m_flowCache.size ();
+      m_flowCache.push_back (FlowCacheEntry{dest.Get (), m_generation, route, false});
+      return route;
+    }
+
+  // CLOCK: skip recently used entries once, stale ones are fair game
+  while (m_flowCache[m_flowCacheHand].referenced &&
+         m_flowCache[m_flowCacheHand].generation == m_generation)
+    {
+      m_flowCache[m_flowCacheHand].referenced = false;
+      m_flowCacheHand = (m_flowCacheHand + 1) % m_flowCacheSize;
+    }
+  FlowCacheEntry &victim = m_flowCache[m_flowCacheHand];
+  m_flowCacheIndex.erase (victim.dest);
+  m_flowCacheIndex[dest.Get ()] = m_flowCacheHand;
+  victim = FlowCacheEntry{dest.Get (), m_generation, route, false};
+  m_flowCacheHand = (m_flowCacheHand + 1) % m_flowCacheSize;
+  return route;
+}
+
+bool
+OspfRoutingProtocol::IsOnLink (Ipv4Address dest) const
+{
+  for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
+    {
+      for (uint32_t j = 0; j < m_ipv4->GetNAddresses (i); j++)
+        {
+          Ipv4InterfaceAddress address = m_ipv4->GetAddress (i, j);
+          if (address.GetLocal ().CombineMask (address.GetMask ()) ==
+              dest.CombineMask (address.GetMask ()))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+uint32_t
+OspfRoutingProtocol::FlowHash (const Ipv4Header &header, Ptr<const Packet> p) const
+{
+  uint32_t h = Mix (m_hashSeed ^ header.GetSource ().Get ());
+  h = Mix (h ^ header.GetDestination ().Get ());
+  h = Mix (h ^ header.GetProtocol ());
+  // TCP and UDP both start with the source and destination ports
+  if (p != nullptr && (header.GetProtocol () == 6 || header.GetProtocol () == 17) &&
+      p->GetSize () >= 4)
+    {
+      uint8_t ports[4];
+      p->CopyData (ports, 4);
+      h = Mix (h ^ (uint32_t (ports[0]) << 24 | uint32_t (ports[1]) << 16 |
+                    uint32_t (ports[2]) << 8 | uint32_t (ports[3])));
+    }
+  return h;
+}
+
+Ptr<Ipv4Route>
+OspfRoutingProtocol::MakeRoute (Ipv4Address dest, const Path &path) const
+{
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetDestination (dest);
+  route->SetGateway (path.first);
+  route->SetOutputDevice (m_ipv4->GetNetDevice (path.second));
+  route->SetSource (m_ipv4->SourceAddressSelection (path.second, dest));
+  return route;
+}
+
+Ptr<Ipv4Route>
+OspfRoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                  Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << header << oif);
+  Ipv4Address dest = header.GetDestination ();
+  sockerr = Socket::ERROR_NOROUTETOHOST;
+  if (m_ipv4 == nullptr || dest.IsMulticast () || dest.IsBroadcast () || IsOnLink (dest))
+    {
+      return nullptr;
+    }
+
+  const NextHops *route = CachedLookupRoute (dest);
+  if (route == nullptr || route->paths.empty ())
+    {
+      return nullptr;
+    }
+
+  // Ports are not in the packet yet when sockets look up routes
+  uint32_t hash = FlowHash (header, nullptr);
+  if (oif == nullptr)
+    {
+      sockerr = Socket::ERROR_NOTERROR;
+      return MakeRoute (dest, route->paths[hash % route->paths.size ()]);
+    }
+
+  std::vector<const Path *> usable;
+  for (auto &path : route->paths)
+    {
+      if (m_ipv4->GetNetDevice (path.second) == oif)
+        {
+          usable.push_back (&path);
+        }
+    }
+  if (usable.empty ())
+    {
+      return nullptr;
+    }
+  sockerr = Socket::ERROR_NOTERROR;
+  return MakeRoute (dest, *usable[hash % usable.size ()]);
+}
+
+bool
+OspfRoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                                 Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                                 MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                                 ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+  Ipv4Address dest = header.GetDestination ();
+  if (m_ipv4 == nullptr || dest.IsMulticast () || dest.IsBroadcast () || IsOnLink (dest))
+    {
+      return false;
+    }
+
+  // Local delivery and the forwarding check are done by Ipv4ListRouting
+  const NextHops *route = CachedLookupRoute (dest);
+  if (route == nullptr)
+    {
+      return false;
+    }
+  if (route->paths.empty ())
+    {
+      NS_LOG_LOGIC ("Discarding packet to " << dest);
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+  const Path &path = route->paths[FlowHash (header, p) % route->paths.size ()];
+  ucb (MakeRoute (dest, path), p, header);
+  return true;
+}
+
+void
+OspfRoutingProtocol::NotifyInterfaceUp (uint32_t interface)
+{
+}
+
+void
+OspfRoutingProtocol::NotifyInterfaceDown (uint32_t interface)
+{
+}
+
+void
+OspfRoutingProtocol::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+OspfRoutingProtocol::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+OspfRoutingProtocol::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (m_ipv4 == nullptr && ipv4 != nullptr);
+  m_ipv4 = ipv4;
+}
+
+void
+OspfRoutingProtocol::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream *os = stream->GetStream ();
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", OspfRoutingProtocol table" << std::endl;
+  if (m_trie.GetSize () == 0 && m_discards.GetSize () == 0)
+    {
+      return;
+    }
+
+  *os << "Destination     Gateway         Genmask         Iface Metric" << std::endl;
+  for (auto &[network, length, slot] : m_trie.GetEntries ())
+    {
+      const NextHops *route = Resolve (m_slots[slot]);
+      if (route == nullptr)
+        {
+          continue;
+        }
+      for (auto &path : route->paths)
+        {
+          std::ostringstream dest, gw, mask;
+          dest << Ipv4Address (network);
+          gw << path.first;
+          mask << Ipv4Mask (length == 0 ? 0 : ~0u << (32 - length));
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ()
+              << std::setw (16) << gw.str () << std::setw (16) << mask.str ()
+              << std::setw (6) << path.second << route->metric << std::endl;
+        }
+    }
+  for (auto &[network, length, value] : m_discards.GetEntries ())
+    {
+      (void)value;
+      std::ostringstream dest, mask;
+      dest << Ipv4Address (network);
+      mask << Ipv4Mask (length == 0 ? 0 : ~0u << (32 - length));
+      *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ()
+          << std::setw (16) << "discard" << std::setw (16) << mask.str () << std::setw (6) << "-"
+          << "-" << std::endl;
+    }
+}
+
+} // namespace ns3
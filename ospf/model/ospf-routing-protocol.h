@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef OSPF_ROUTING_PROTOCOL_H
+#define OSPF_ROUTING_PROTOCOL_H
+
+#include "ns3/callback.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/packet.h"
+
+#include "ospf-lpm-trie.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ *
+ * \brief Multipath forwarding table programmed by OspfApp
+ *
+ * Holds every OSPF route with all of its equal-cost next hops and picks one
+ * per flow by hashing the source, destination and protocol, plus the TCP/UDP
+ * ports of forwarded packets. Routes are kept in a longest-prefix-match
+ * trie. It sits in front of Ipv4StaticRouting, which either keeps the
+ * single-path copy of the same routes or, once OspfRoutingHelper installed
+ * this table for OSPF to program directly, only the connected ones.
+ * Destinations on directly connected networks are left to the lower
+ * priority protocols.
+ *
+ * A route either carries its own next hops or points at a shared next-hop
+ * group. Replacing a group reroutes every route that uses it at once, which
+ * keeps convergence independent of the number of prefixes.
+ *
+ * Discard routes drop what they match unless a route of at least the same
+ * prefix length matches too. Area border aggregates use them so that
+ * destinations in the gaps between an area's prefixes are dropped rather
+ * than sent back out along a shorter route. Forwarded packets are dropped
+ * with an error; locally originated ones get no route here and fall
+ * through to the lower priority protocols.
+ *
+ * An optional destination cache with CLOCK eviction sits in front of the
+ * trie lookup. Every change to the routes or groups bumps a generation
+ * counter, and cache entries from an older generation count as misses.
+ */
+class OspfRoutingProtocol : public Ipv4RoutingProtocol
+{
+public:
+  /// <gateway, interface index>
+  typedef std::pair<Ipv4Address, uint32_t> Path;
+  /// Called for a destination without a route; returns true if it added one
+  typedef Callback<bool, Ipv4Address> RouteResolver;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  OspfRoutingProtocol ();
+  virtual ~OspfRoutingProtocol ();
+
+  /**
+   * \brief Add or replace the route to a network
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \param paths the equal-cost next hops, at least one
+   * \param metric the route metric
+   */
+  void AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                          const std::vector<Path> &paths, uint32_t metric);
+
+  /**
+   * \brief Add or replace the route to a network through a next-hop group
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \param group the next-hop group, see SetNextHopGroup
+   */
+  void AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask, uint32_t group);
+
+  /**
+   * \brief Add or replace a next-hop group
+   *
+   * A group without paths, or one that was never set, leaves its routes
+   * unresolved: lookups skip them and fall through to shorter prefixes.
+   * \param group the group ID, not 0
+   * \param paths the equal-cost next hops, empty if unresolved
+   * \param metric the metric of the routes through the group
+   */
+  void SetNextHopGroup (uint32_t group, const std::vector<Path> &paths, uint32_t metric);
+
+  /**
+   * \brief Remove a next-hop group; routes still using it become unresolved
+   * \param group the group ID
+   * \return true if a group was removed
+   */
+  bool RemoveNextHopGroup (uint32_t group);
+
+  /**
+   * \return the number of next-hop groups
+   */
+  uint32_t GetNNextHopGroups (void) const;
+
+  /**
+   * \brief Remove the route to a network
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \return true if a route was removed
+   */
+  bool RemoveNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask);
+
+  /**
+   * \brief Add a discard route
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   */
+  void AddDiscardRouteTo (Ipv4Address network, Ipv4Mask networkMask);
+
+  /**
+   * \brief Remove a discard route
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \return true if a discard route was removed
+   */
+  bool RemoveDiscardRouteTo (Ipv4Address network, Ipv4Mask networkMask);
+
+  /**
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \return true if there is a discard route to exactly this network
+   */
+  bool IsDiscardRoute (Ipv4Address network, Ipv4Mask networkMask) const;
+
+  /**
+   * \return the number of discard routes
+   */
+  uint32_t GetNDiscardRoutes (void) const;
+
+  /**
+   * \brief Remove every route, discard route and next-hop group
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of installed routes, not counting discard routes
+   */
+  uint32_t GetNRoutes (void) const;
+
+  /**
+   * \brief Start a batch of route changes
+   *
+   * Changes are applied immediately; the trie only postpones reclaiming
+   * the nodes of removed routes, or compacting itself if most routes
+   * changed, until the matching EndBulkUpdate. Batches nest.
+   */
+  void BeginBulkUpdate (void);
+
+  /**
+   * \brief End a batch of route changes started by BeginBulkUpdate
+   */
+  void EndBulkUpdate (void);
+
+  /**
+   * \brief Get the next hops of an installed route
+   * \param network the destination network
+   * \param networkMask the destination network mask
+   * \return the equal-cost next hops, empty if there is no such route or
+   * it is unresolved
+   */
+  std::vector<Path> GetPaths (Ipv4Address network, Ipv4Mask networkMask) const;
+
+  /**
+   * \brief Set the seed mixed into the flow hash
+   *
+   * Routers with different seeds spread the same flows differently, which
+   * avoids polarization across consecutive ECMP stages.
+   * \param seed the hash seed
+   */
+  void SetHashSeed (uint32_t seed);
+
+  /**
+   * \brief Set the number of destinations the lookup cache holds
+   * \param size the cache capacity, 0 to disable the cache
+   */
+  void SetFlowCacheSize (uint32_t size);
+
+  /**
+   * \return the lookup cache capacity
+   */
+  uint32_t GetFlowCacheSize (void) const;
+
+  /**
+   * \return the number of lookups answered by the cache
+   */
+  uint64_t GetFlowCacheHits (void) const;
+
+  /**
+   * \return the number of cached lookups that went to the trie
+   */
+  uint64_t GetFlowCacheMisses (void) const;
+
+  /**
+   * \brief Reset the cache hit and miss counters
+   */
+  void ResetFlowCacheStats (void);
+
+  /**
+   * \return the generation, bumped by every route or next-hop group change
+   */
+  uint64_t GetGeneration (void) const;
+
+  /**
+   * \brief Invalidate every cached lookup by bumping the generation
+   *
+   * For changes the table cannot see, e.g. ones that make the resolver
+   * answer differently.
+   */
+  void FlushFlowCache (void);
+
+  /**
+   * \brief Set a resolver for destinations without a route
+   *
+   * A lookup that finds no route calls the resolver, and retries if it
+   * returns true. OspfApp uses this to add routes on demand with LazyFib.
+   * \param resolver the resolver, or a null callback to remove it
+   */
+  void SetRouteResolver (RouteResolver resolver);
+
+  // Inherited from Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
+                                      Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                           Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                           MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                           ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream,
+                                  Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  struct NextHops
+  {
+    std::vector<Path> paths;
+    uint32_t metric;
+  };
+  struct Route
+  {
+    NextHops own;
+    uint32_t group; // 0 if the route has its own next hops
+    uint8_t length; // prefix length, set by SetRoute
+  };
+
+  struct FlowCacheEntry
+  {
+    uint32_t dest;
+    uint64_t generation; // m_generation when looked up
+    const NextHops *route; // nullptr if there was no route
+    bool referenced; // CLOCK bit
+  };
+
+  void SetRoute (Ipv4Address network, Ipv4Mask networkMask, const Route &route);
+  // Next hops of a route, nullptr if it is unresolved
+  const NextHops *Resolve (const Route &route) const;
+  // &m_discardRoute if a discard route wins
+  const NextHops *LookupRoute (Ipv4Address dest) const;
+  // LookupRoute, then the resolver if there is no route
+  const NextHops *ResolveRoute (Ipv4Address dest);
+  // ResolveRoute through the cache, if enabled
+  const NextHops *CachedLookupRoute (Ipv4Address dest);
+  bool IsOnLink (Ipv4Address dest) const;
+  uint32_t FlowHash (const Ipv4Header &header, Ptr<const Packet> p) const;
+  Ptr<Ipv4Route> MakeRoute (Ipv4Address dest, const Path &path) const;
+
+  Ptr<Ipv4> m_ipv4; //!< IPv4 stack of the node
+  uint32_t m_hashSeed; //!< Seed mixed into the flow hash
+  OspfLpmTrie m_trie; //!< Routes by prefix; values index m_slots
+  std::vector<Route> m_slots; //!< Route storage
+  std::vector<uint32_t> m_freeSlots; //!< Unused entries of m_slots
+  std::unordered_map<uint32_t, NextHops> m_groups; //!< Next-hop groups by ID
+  OspfLpmTrie m_discards; //!< Discard routes by prefix; values are the prefix lengths
+  NextHops m_discardRoute; //!< Looked up for discarded destinations, without paths
+  RouteResolver m_resolver; //!< Adds routes on demand, may be null
+  uint64_t m_generation; //!< Bumped by every route or group change
+  uint32_t m_flowCacheSize; //!< Lookup cache capacity, 0 if disabled
+  std::vector<FlowCacheEntry> m_flowCache; //!< Cached lookups
+  std::unordered_map<uint32_t, uint32_t> m_flowCacheIndex; //!< Cache entry by destination
+  uint32_t m_flowCacheHand; //!< Next CLOCK eviction candidate
+  uint64_t m_flowCacheHits; //!< Lookups answered by the cache
+  uint64_t m_flowCacheMisses; //!< Cached lookups that went to the trie
+};
+
+} // namespace ns3
+
+#endif /* OSPF_ROUTING_PROTOCOL_H */
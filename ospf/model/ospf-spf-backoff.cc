@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ospf-spf-backoff.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OspfSpfBackoff");
+
+OspfSpfBackoff::~OspfSpfBackoff ()
+{
+  // Cancel only flags the events, which is safe after Simulator::Destroy
+  m_learnTimer.Cancel ();
+  m_holdDownTimer.Cancel ();
+}
+
+Time
+OspfSpfBackoff::Trigger (const Config &config)
+{
+  m_stats.events++;
+  m_holdDownEnd = Simulator::Now () + config.holdDown;
+  if (!m_holdDownTimer.IsRunning ())
+    {
+      m_holdDownTimer =
+          Simulator::Schedule (config.holdDown, &OspfSpfBackoff::HoldDownTimerExpired, this);
+    }
+
+  switch (m_state)
+    {
+    case QUIET:
+      NS_LOG_INFO ("SPF back-off QUIET -> SHORT_WAIT");
+      m_state = SHORT_WAIT;
+      m_stats.quietToShortWait++;
+      m_learnTimer =
+          Simulator::Schedule (config.timeToLearn, &OspfSpfBackoff::LearnTimerExpired, this);
+      return config.initialDelay;
+    case SHORT_WAIT:
+      return config.shortDelay;
+    case LONG_WAIT:
+    default:
+      return config.longDelay;
+    }
+}
+
+void
+OspfSpfBackoff::LearnTimerExpired ()
+{
+  if (m_state == SHORT_WAIT)
+    {
+      NS_LOG_INFO ("SPF back-off SHORT_WAIT -> LONG_WAIT");
+      m_state = LONG_WAIT;
+      m_stats.shortToLongWait++;
+    }
+}
+
+void
+OspfSpfBackoff::HoldDownTimerExpired ()
+{
+  Time now = Simulator::Now ();
+  if (now < m_holdDownEnd)
+    {
+      m_holdDownTimer = Simulator::Schedule (m_holdDownEnd - now,
+                                             &OspfSpfBackoff::HoldDownTimerExpired, this);
+      return;
+    }
+
+  NS_LOG_INFO ("SPF back-off " << (m_state == SHORT_WAIT ? "SHORT_WAIT" : "LONG_WAIT")
+                               << " -> QUIET");
+  if (m_state == SHORT_WAIT)
+    {
+      m_stats.shortWaitToQuiet++;
+    }
+  else if (m_state == LONG_WAIT)
+    {
+      m_stats.longWaitToQuiet++;
+    }
+  m_state = QUIET;
+  m_learnTimer.Cancel ();
+}
+
+void
+OspfSpfBackoff::Reset ()
+{
+  m_state = QUIET;
+  m_learnTimer.Remove ();
+  m_holdDownTimer.Remove ();
+}
+
+OspfSpfBackoff::State
+OspfSpfBackoff::GetState () const
+{
+  return m_state;
+}
+
+const OspfSpfBackoff::Stats &
+OspfSpfBackoff::GetStats () const
+{
+  return m_stats;
+}
+
+void
+OspfSpfBackoff::ResetStats ()
+{
+  m_stats = Stats ();
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef OSPF_SPF_BACKOFF_H
+#define OSPF_SPF_BACKOFF_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+
+namespace ns3 {
+
+// SPF back-off state machine of RFC 8405. Every event that calls for SPF
+// is reported; the returned delay is what the SPF timer should be armed
+// with if it is not running yet. The first event after a quiet period is
+// served after InitialSpfDelay; events within TimeToLearn of it are
+// served after ShortSpfDelay, later ones after LongSpfDelay, until no
+// event was seen for HoldDown. One instance is shared by the L1 and L2
+// schedulers, which keep their own SPF timers.
+class OspfSpfBackoff
+{
+public:
+  enum State
+  {
+    QUIET,
+    SHORT_WAIT,
+    LONG_WAIT,
+  };
+
+  struct Config
+  {
+    Time initialDelay;
+    Time shortDelay;
+    Time longDelay;
+    Time holdDown;
+    Time timeToLearn;
+  };
+
+  struct Stats
+  {
+    uint64_t events = 0;
+    uint64_t quietToShortWait = 0;
+    uint64_t shortToLongWait = 0;
+    uint64_t shortWaitToQuiet = 0;
+    uint64_t longWaitToQuiet = 0;
+  };
+
+  ~OspfSpfBackoff ();
+
+  // Report an event and return the SPF delay of the resulting state
+  Time Trigger (const Config &config);
+  // Cancel the timers and go back to QUIET
+  void Reset ();
+
+  State GetState () const;
+  const Stats &GetStats () const;
+  void ResetStats ();
+
+private:
+  void LearnTimerExpired ();
+  void HoldDownTimerExpired ();
+
+  State m_state = QUIET;
+  EventId m_learnTimer;
+  EventId m_holdDownTimer;
+  // Restarting HOLDDOWN_TIMER on every event only moves this; the timer
+  // is re-armed for the remainder when it fires early
+  Time m_holdDownEnd;
+  Stats m_stats;
+};
+
+} // namespace ns3
+
+#endif // OSPF_SPF_BACKOFF_H
@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ospf-spf-batch.h"
+#include "ospf-app-routing-engine.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OspfSpfBatch");
+
+namespace {
+
+// Workers sleep between batches and are joined at exit
+class WorkerPool
+{
+public:
+  ~WorkerPool ()
+  {
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all ();
+    for (std::thread &worker : m_workers)
+      {
+        worker.join ();
+      }
+  }
+
+  // Grows only; the caller is the extra thread
+  void
+  Reserve (uint32_t workers)
+  {
+    while (m_workers.size () < workers)
+      {
+        // Only called between batches, so the generation is stable
+        m_workers.emplace_back (&WorkerPool::Loop, this, m_generation);
+      }
+  }
+
+  void
+  Run (uint32_t n, const std::function<void (uint32_t)> &task)
+  {
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_task = &task;
+      m_n = n;
+      m_next = 0;
+      m_busy = m_workers.size ();
+      m_generation++;
+    }
+    m_wake.notify_all ();
+    Work ();
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_done.wait (lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+  }
+
+private:
+  void
+  Loop (uint64_t seen)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (true)
+      {
+        m_wake.wait (lock, [this, seen] { return m_stop || m_generation != seen; });
+        if (m_stop)
+          {
+            return;
+          }
+        seen = m_generation;
+        lock.unlock ();
+        Work ();
+        lock.lock ();
+        if (--m_busy == 0)
+          {
+            m_done.notify_one ();
+          }
+      }
+  }
+
+  void
+  Work ()
+  {
+    for (uint32_t i = m_next++; i < m_n; i = m_next++)
+      {
+        (*m_task) (i);
+      }
+  }
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  bool m_stop = false;
+  uint64_t m_generation = 0;
+  uint32_t m_busy = 0; // workers still in the current batch
+  const std::function<void (uint32_t)> *m_task = nullptr;
+  uint32_t m_n = 0;
+  std::atomic<uint32_t> m_next{0};
+};
+
+WorkerPool &
+GetPool ()
+{
+  static WorkerPool pool;
+  return pool;
+}
+
+// Runs waiting for the next flush, in the order they were queued
+std::vector<OspfRoutingEngine *> g_queue;
+std::unordered_set<const OspfRoutingEngine *> g_queued;
+uint32_t g_threads = 1;
+// Runs of the flush in progress; removed ones are set to nullptr
+std::vector<OspfRoutingEngine *> *g_flushing = nullptr;
+
+} // namespace
+
+void
+OspfSpfBatch::Add (OspfRoutingEngine *engine, uint32_t threads)
+{
+  if (!g_queued.insert (engine).second)
+    {
+      return;
+    }
+  if (g_queue.empty ())
+    {
+      Simulator::ScheduleNow (&OspfSpfBatch::Flush);
+    }
+  g_queue.push_back (engine);
+  g_threads = std::max (g_threads, threads);
+}
+
+void
+OspfSpfBatch::Remove (OspfRoutingEngine *engine)
+{
+  if (g_queued.erase (engine) > 0)
+    {
+      g_queue.erase (std::find (g_queue.begin (), g_queue.end (), engine));
+    }
+  if (g_flushing != nullptr)
+    {
+      std::replace (g_flushing->begin (), g_flushing->end (), engine,
+                    static_cast<OspfRoutingEngine *> (nullptr));
+    }
+}
+
+bool
+OspfSpfBatch::IsQueued (const OspfRoutingEngine *engine)
+{
+  return g_queued.count (engine) > 0;
+}
+
+void
+OspfSpfBatch::ParallelFor (uint32_t n, uint32_t threads,
+                           const std::function<void (uint32_t)> &task)
+{
+  threads = std::min (threads, n);
+  if (threads <= 1)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          task (i);
+        }
+      return;
+    }
+  WorkerPool &pool = GetPool ();
+  pool.Reserve (threads - 1);
+  pool.Run (n, task);
+}
+
+void
+OspfSpfBatch::Flush ()
+{
+  std::vector<OspfRoutingEngine *> batch;
+  batch.swap (g_queue);
+  g_queued.clear ();
+  uint32_t threads = g_threads;
+  g_threads = 1;
+  NS_LOG_FUNCTION (batch.size () << threads);
+
+  // Runs queued from here on go to the next flush
+  g_flushing = &batch;
+  std::vector<OspfRoutingEngine *> dijkstra;
+  for (OspfRoutingEngine *engine : batch)
+    {
+      if (engine != nullptr && engine->PrepareBatchL1Spt ())
+        {
+          dijkstra.push_back (engine);
+        }
+    }
+  // Each run only touches its own graph
+  ParallelFor (dijkstra.size (), threads,
+               [&dijkstra] (uint32_t i) { dijkstra[i]->RunBatchL1Spt (); });
+  for (OspfRoutingEngine *engine : batch)
+    {
+      if (engine != nullptr)
+        {
+          engine->CommitBatchL1Spt ();
+        }
+    }
+  g_flushing = nullptr;
+}
+
+} // namespace ns3
@@ -0,0 +1,39 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef OSPF_SPF_BATCH_H
+#define OSPF_SPF_BATCH_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ns3 {
+
+class OspfRoutingEngine;
+
+// Process-wide batch of L1 SPF runs due at the same simulation time. The
+// first router queued schedules a flush behind the events already pending
+// at that time. The flush prepares every run on the simulator thread, runs
+// the Dijkstra passes on a worker pool, and commits the results back in
+// queue order, so the outcome does not depend on thread timing.
+class OspfSpfBatch
+{
+public:
+  // Queue an L1 SPF run; a router already queued is only queued once.
+  // threads is the pool size the router asks for, the caller included.
+  static void Add (OspfRoutingEngine *engine, uint32_t threads);
+  // Drop a queued run, e.g. because the router was reset or disposed
+  static void Remove (OspfRoutingEngine *engine);
+  static bool IsQueued (const OspfRoutingEngine *engine);
+
+  // Run task (i) for every i in [0, n) on up to threads threads, the
+  // caller included. Returns once every task has finished.
+  static void ParallelFor (uint32_t n, uint32_t threads, const std::function<void (uint32_t)> &task);
+
+private:
+  static void Flush ();
+};
+
+} // namespace ns3
+
+#endif // OSPF_SPF_BATCH_H
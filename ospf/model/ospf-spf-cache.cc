@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ospf-spf-cache.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace ns3 {
+
+namespace {
+
+// Finalizer of SplitMix64
+uint64_t
+Mix64 (uint64_t h)
+{
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+// Expired entries are swept once the map grows past this
+size_t g_sweepAt = 64;
+
+} // namespace
+
+uint64_t
+OspfSpfCache::DigestEdges (uint32_t id, const std::vector<std::pair<uint32_t, uint32_t>> &edges)
+{
+  uint64_t h = Mix64 (id);
+  for (auto &[neighbor, metric] : edges)
+    {
+      h = Mix64 (h ^ (uint64_t (neighbor) << 32 | metric));
+    }
+  return h;
+}
+
+std::unordered_map<uint64_t, std::weak_ptr<OspfSpfGraph>> &
+OspfSpfCache::GetEntries ()
+{
+  static std::unordered_map<uint64_t, std::weak_ptr<OspfSpfGraph>> entries;
+  return entries;
+}
+
+std::shared_ptr<OspfSpfGraph>
+OspfSpfCache::Lookup (uint64_t digest, const Builder &builder, bool &hit)
+{
+  auto &entries = GetEntries ();
+  std::weak_ptr<OspfSpfGraph> &entry = entries[digest];
+  std::shared_ptr<OspfSpfGraph> graph = entry.lock ();
+  hit = graph != nullptr;
+  if (hit)
+    {
+      return graph;
+    }
+
+  graph = std::make_shared<OspfSpfGraph> ();
+  builder (*graph);
+  entry = graph;
+  if (entries.size () >= g_sweepAt)
+    {
+      for (auto it = entries.begin (); it != entries.end ();)
+        {
+          it = it->second.expired () ? entries.erase (it) : std::next (it);
+        }
+      g_sweepAt = std::max<size_t> (64, entries.size () * 2);
+    }
+  return graph;
+}
+
+uint32_t
+OspfSpfCache::GetNGraphs ()
+{
+  auto &entries = GetEntries ();
+  return std::count_if (entries.begin (), entries.end (),
+                        [] (const std::pair<const uint64_t, std::weak_ptr<OspfSpfGraph>> &entry) {
+                          return !entry.second.expired ();
+                        });
+}
+
+} // namespace ns3
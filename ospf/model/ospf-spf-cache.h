@@ -0,0 +1,44 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef OSPF_SPF_CACHE_H
+#define OSPF_SPF_CACHE_H
+
+#include "ospf-spf-graph.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+// Process-wide cache of L1 SPF graphs keyed by a Router-LSDB digest. Every
+// router of an area converges to the same LSDB, so they can share one
+// graph and each only runs Dijkstra from its own root. An entry lives as
+// long as some router holds it.
+class OspfSpfCache
+{
+public:
+  typedef std::function<void (OspfSpfGraph &)> Builder;
+
+  // Digest of one router's out-edges, <neighbor ID, metric> sorted by
+  // neighbor. An LSDB digest is the sum over its routers, so it can be
+  // patched one router at a time.
+  static uint64_t DigestEdges (uint32_t id,
+                               const std::vector<std::pair<uint32_t, uint32_t>> &edges);
+
+  // Graph for an LSDB digest, built by the builder on a miss
+  static std::shared_ptr<OspfSpfGraph> Lookup (uint64_t digest, const Builder &builder,
+                                               bool &hit);
+  // Graphs still held by some router
+  static uint32_t GetNGraphs ();
+
+private:
+  static std::unordered_map<uint64_t, std::weak_ptr<OspfSpfGraph>> &GetEntries ();
+};
+
+} // namespace ns3
+
+#endif // OSPF_SPF_CACHE_H
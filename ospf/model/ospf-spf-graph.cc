@@ -0,0 +1,332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#include "ospf-spf-graph.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace ns3 {
+
+constexpr uint32_t OspfSpfGraph::NO_VERTEX;
+constexpr uint32_t OspfSpfGraph::INFINITE_DISTANCE;
+constexpr uint32_t OspfSpfGraph::MAX_BUCKET_METRIC;
+
+uint32_t
+OspfSpfGraph::AddVertex (uint32_t id)
+{
+  auto result = m_index.emplace (id, m_ids.size ());
+  if (result.second)
+    {
+      m_ids.push_back (id);
+      m_offset.push_back (m_edges.size ());
+      m_degree.push_back (0);
+      m_capacity.push_back (0);
+      m_distance.push_back (INFINITE_DISTANCE);
+      m_parent.push_back (NO_VERTEX);
+      m_firstHop.push_back (NO_VERTEX);
+    }
+  return result.first->second;
+}
+
+uint32_t
+OspfSpfGraph::FindVertex (uint32_t id) const
+{
+  auto it = m_index.find (id);
+  return it == m_index.end () ? NO_VERTEX : it->second;
+}
+
+uint32_t
+OspfSpfGraph::GetId (uint32_t vertex) const
+{
+  return m_ids[vertex];
+}
+
+uint32_t
+OspfSpfGraph::GetNVertices () const
+{
+  return m_ids.size ();
+}
+
+void
+OspfSpfGraph::SetEdges (uint32_t id, const std::vector<std::pair<uint32_t, uint32_t>> &edges)
+{
+  uint32_t v = AddVertex (id);
+  // Heads first, AddVertex may grow the arrays
+  std::vector<Edge> resolved;
+  resolved.reserve (edges.size ());
+  for (auto &[neighbor, metric] : edges)
+    {
+      resolved.push_back (Edge{AddVertex (neighbor), metric});
+    }
+
+  CountMetrics (v, -1);
+  uint32_t n = resolved.size ();
+  if (n > m_capacity[v])
+    {
+      if (m_offset[v] + m_capacity[v] == m_edges.size ())
+        {
+          // Last slot, grow in place
+          m_edges.resize (m_offset[v] + n);
+        }
+      else
+        {
+          m_unused += m_capacity[v];
+          m_offset[v] = m_edges.size ();
+          m_edges.resize (m_edges.size () + n);
+        }
+      m_capacity[v] = n;
+    }
+  std::copy (resolved.begin (), resolved.end (), m_edges.begin () + m_offset[v]);
+  m_degree[v] = n;
+  CountMetrics (v, 1);
+
+  if (m_unused > m_edges.size () / 2)
+    {
+      Compact ();
+    }
+}
+
+void
+OspfSpfGraph::ClearEdges (uint32_t id)
+{
+  uint32_t v = FindVertex (id);
+  if (v != NO_VERTEX)
+    {
+      CountMetrics (v, -1);
+      m_degree[v] = 0;
+    }
+}
+
+void
+OspfSpfGraph::CountMetrics (uint32_t vertex, int32_t sign)
+{
+  for (const Edge *e = EdgesBegin (vertex); e != EdgesEnd (vertex); ++e)
+    {
+      if (e->metric == 0)
+        {
+          m_zeroMetricEdges += sign;
+        }
+      else if (e->metric > MAX_BUCKET_METRIC)
+        {
+          m_largeMetricEdges += sign;
+        }
+    }
+}
+
+void
+OspfSpfGraph::Clear ()
+{
+  m_index.clear ();
+  m_ids.clear ();
+  m_offset.clear ();
+  m_degree.clear ();
+  m_capacity.clear ();
+  m_edges.clear ();
+  m_unused = 0;
+  m_zeroMetricEdges = 0;
+  m_largeMetricEdges = 0;
+  m_distance.clear ();
+  m_parent.clear ();
+  m_firstHop.clear ();
+  m_reached.clear ();
+  m_heap.clear ();
+  m_buckets.clear ();
+}
+
+void
+OspfSpfGraph::Compact ()
+{
+  std::vector<Edge> edges;
+  edges.reserve (m_edges.size () - m_unused);
+  for (uint32_t v = 0; v < m_ids.size (); v++)
+    {
+      auto begin = m_edges.begin () + m_offset[v];
+      m_offset[v] = edges.size ();
+      m_capacity[v] = m_degree[v];
+      edges.insert (edges.end (), begin, begin + m_degree[v]);
+    }
+  m_edges.swap (edges);
+  m_unused = 0;
+}
+
+const OspfSpfGraph::Edge *
+OspfSpfGraph::EdgesBegin (uint32_t vertex) const
+{
+  return m_edges.data () + m_offset[vertex];
+}
+
+const OspfSpfGraph::Edge *
+OspfSpfGraph::EdgesEnd (uint32_t vertex) const
+{
+  return m_edges.data () + m_offset[vertex] + m_degree[vertex];
+}
+
+void
+OspfSpfGraph::SetQueue (Queue queue)
+{
+  m_queue = queue;
+}
+
+bool
+OspfSpfGraph::CanUseBucketQueue () const
+{
+  return m_zeroMetricEdges == 0 && m_largeMetricEdges == 0;
+}
+
+void
+OspfSpfGraph::ComputeShortestPaths (uint32_t root)
+{
+  for (uint32_t v : m_reached)
+    {
+      m_distance[v] = INFINITE_DISTANCE;
+      m_parent[v] = NO_VERTEX;
+      m_firstHop[v] = NO_VERTEX;
+    }
+  m_reached.clear ();
+  m_distance[root] = 0;
+  m_reached.push_back (root);
+
+  if (m_queue != BINARY_HEAP && CanUseBucketQueue ())
+    {
+      RunBucketQueue (root);
+    }
+  else
+    {
+      RunBinaryHeap (root);
+    }
+}
+
+void
+OspfSpfGraph::RunBinaryHeap (uint32_t root)
+{
+  // Keyed by <distance, ID>: the iSPF tie-break expects ties to settle in ID order
+  auto greater = std::greater<std::pair<uint64_t, uint32_t>> ();
+  m_heap.clear ();
+  m_heap.emplace_back (uint64_t (m_ids[root]), root);
+  while (!m_heap.empty ())
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), greater);
+      uint32_t u = m_heap.back ().second;
+      uint32_t w = m_heap.back ().first >> 32;
+      m_heap.pop_back ();
+      // Stale entry, u was already expanded with a shorter distance
+      if (w > m_distance[u])
+        {
+          continue;
+        }
+      for (const Edge *e = EdgesBegin (u); e != EdgesEnd (u); ++e)
+        {
+          uint32_t v = e->head;
+          uint32_t d = w + e->metric;
+          if (d < m_distance[v])
+            {
+              if (m_distance[v] == INFINITE_DISTANCE)
+                {
+                  m_reached.push_back (v);
+                }
+              m_distance[v] = d;
+              SetParent (v, u, root);
+              m_heap.emplace_back (uint64_t (d) << 32 | m_ids[v], v);
+              std::push_heap (m_heap.begin (), m_heap.end (), greater);
+            }
+        }
+    }
+}
+
+void
+OspfSpfGraph::RunBucketQueue (uint32_t root)
+{
+  // With metrics in [1, MAX_BUCKET_METRIC], pending distances span fewer
+  // buckets than there are, and nothing lands in the bucket being scanned
+  m_buckets.resize (MAX_BUCKET_METRIC + 1);
+  m_buckets[0].push_back (root);
+  uint32_t pending = 1;
+  for (uint32_t w = 0; pending > 0; w++)
+    {
+      std::vector<uint32_t> &bucket = m_buckets[w % m_buckets.size ()];
+      for (uint32_t u : bucket)
+        {
+          // Stale entry, u was moved to a closer bucket
+          if (m_distance[u] != w)
+            {
+              continue;
+            }
+          for (const Edge *e = EdgesBegin (u); e != EdgesEnd (u); ++e)
+            {
+              uint32_t v = e->head;
+              uint32_t d = w + e->metric;
+              if (d < m_distance[v])
+                {
+                  if (m_distance[v] == INFINITE_DISTANCE)
+                    {
+                      m_reached.push_back (v);
+                    }
+                  m_distance[v] = d;
+                  SetParent (v, u, root);
+                  m_buckets[d % m_buckets.size ()].push_back (v);
+                  pending++;
+                }
+              else if (d == m_distance[v] && m_ids[u] < m_ids[m_parent[v]] &&
+                       m_distance[u] == m_distance[m_parent[v]])
+                {
+                  // Same parent the heap would settle first
+                  SetParent (v, u, root);
+                }
+            }
+        }
+      pending -= bucket.size ();
+      bucket.clear ();
+    }
+}
+
+void
+OspfSpfGraph::SetParent (uint32_t vertex, uint32_t parent, uint32_t root)
+{
+  // The parent is settled, so its first hop is final
+  m_parent[vertex] = parent;
+  m_firstHop[vertex] = parent == root ? vertex : m_firstHop[parent];
+}
+
+uint32_t
+OspfSpfGraph::GetDistance (uint32_t vertex) const
+{
+  return m_distance[vertex];
+}
+
+uint32_t
+OspfSpfGraph::GetParent (uint32_t vertex) const
+{
+  return m_parent[vertex];
+}
+
+uint32_t
+OspfSpfGraph::GetFirstHop (uint32_t vertex) const
+{
+  return m_firstHop[vertex];
+}
+
+const std::vector<uint32_t> &
+OspfSpfGraph::GetReached () const
+{
+  return m_reached;
+}
+
+} // namespace ns3
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025 Sirapop Theeranantachai
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sirapop Theeranantachaoi <stheera@g.ucla.edu>
+ */
+
+#ifndef OSPF_SPF_GRAPH_H
+#define OSPF_SPF_GRAPH_H
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ospf
+ *
+ * \brief SPF graph over dense vertex indices
+ *
+ * Router or area IDs are mapped to indices on first use, and out-edges are
+ * kept in a compressed sparse row array. Every vertex owns a slot of the
+ * edge array; a vertex whose edges outgrow its slot moves to the end, and
+ * the array is compacted once half of it is unused. Shortest paths run on a
+ * bucket queue when every metric is small and nonzero, and on a binary heap
+ * otherwise.
+ */
+class OspfSpfGraph
+{
+public:
+  static constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max ();
+  static constexpr uint32_t INFINITE_DISTANCE = std::numeric_limits<uint32_t>::max ();
+  // Largest metric the bucket queue handles; one bucket per distance modulo this + 1
+  static constexpr uint32_t MAX_BUCKET_METRIC = 255;
+
+  enum Queue
+  {
+    AUTO_QUEUE, // bucket queue whenever it applies, binary heap otherwise
+    BINARY_HEAP,
+    BUCKET_QUEUE, // Dial's algorithm, falls back to the heap if it does not apply
+  };
+
+  struct Edge
+  {
+    uint32_t head; // vertex index
+    uint32_t metric;
+  };
+
+  // Vertex index of an ID, added if unknown
+  uint32_t AddVertex (uint32_t id);
+  // Vertex index of an ID, NO_VERTEX if unknown
+  uint32_t FindVertex (uint32_t id) const;
+  uint32_t GetId (uint32_t vertex) const;
+  uint32_t GetNVertices () const;
+
+  // Replace the out-edges of an ID; edges are <neighbor ID, metric>
+  void SetEdges (uint32_t id, const std::vector<std::pair<uint32_t, uint32_t>> &edges);
+  void ClearEdges (uint32_t id);
+  void Clear ();
+
+  const Edge *EdgesBegin (uint32_t vertex) const;
+  const Edge *EdgesEnd (uint32_t vertex) const;
+
+  // Dijkstra from a vertex. Among equal-cost parents the one with the
+  // lowest <distance, ID> wins, as if vertices settled in <distance, ID>
+  // order, whichever queue runs.
+  void ComputeShortestPaths (uint32_t root);
+  void SetQueue (Queue queue);
+  // True if every metric is within [1, MAX_BUCKET_METRIC]. Zero-cost links
+  // can tie a vertex with its own parent, which only the heap order settles.
+  bool CanUseBucketQueue () const;
+  uint32_t GetDistance (uint32_t vertex) const;
+  uint32_t GetParent (uint32_t vertex) const;
+  // Neighbor of the root the tree path leaves through, NO_VERTEX for the
+  // root. Inherited from the parent during relaxation, no tree walk needed.
+  uint32_t GetFirstHop (uint32_t vertex) const;
+  // Vertices reached by the last run
+  const std::vector<uint32_t> &GetReached () const;
+
+private:
+  void Compact ();
+  void CountMetrics (uint32_t vertex, int32_t sign);
+  void RunBinaryHeap (uint32_t root);
+  void RunBucketQueue (uint32_t root);
+  void SetParent (uint32_t vertex, uint32_t parent, uint32_t root);
+
+  std::unordered_map<uint32_t, uint32_t> m_index; // ID to vertex
+  std::vector<uint32_t> m_ids; // vertex to ID
+
+  // CSR: edges of vertex v are m_edges[m_offset[v], m_offset[v] + m_degree[v])
+  std::vector<uint32_t> m_offset;
+  std::vector<uint32_t> m_degree;
+  std::vector<uint32_t> m_capacity;
+  std::vector<Edge> m_edges;
+  uint32_t m_unused = 0; // edge slots no vertex owns
+  uint32_t m_zeroMetricEdges = 0;
+  uint32_t m_largeMetricEdges = 0; // above MAX_BUCKET_METRIC
+  Queue m_queue = AUTO_QUEUE;
+
+  // Per-run scratch, kept between runs and only reset where it was touched
+  std::vector<uint32_t> m_distance;
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_firstHop;
+  std::vector<uint32_t> m_reached;
+  std::vector<std::pair<uint64_t, uint32_t>> m_heap; // <<distance, ID>, vertex>
+  std::vector<std::vector<uint32_t>> m_buckets; // vertices by distance modulo the bucket count
+};
+
+} // namespace ns3
+
+#endif // OSPF_SPF_GRAPH_H
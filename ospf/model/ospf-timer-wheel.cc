@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ospf-timer-wheel.h"
+
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+OspfTimerWheel::OspfTimerWheel (Time tick, uint32_t nSlots)
+  : m_tick (tick),
+    m_slots (nSlots)
+{
+  NS_ASSERT_MSG (tick.IsStrictlyPositive () && nSlots > 0, "Empty timer wheel");
+}
+
+OspfTimerWheel::~OspfTimerWheel ()
+{
+  // Cancel only flags the event, which is safe after Simulator::Destroy
+  m_event.Cancel ();
+}
+
+void
+OspfTimerWheel::SetExpireCallback (ExpireCallback expire)
+{
+  m_expire = expire;
+}
+
+Time
+OspfTimerWheel::GetTickTime (uint64_t tick) const
+{
+  return TimeStep (tick * m_tick.GetTimeStep ());
+}
+
+void
+OspfTimerWheel::Schedule (Key key, Time delay)
+{
+  // Round up, a timer never fires early
+  uint64_t step = m_tick.GetTimeStep ();
+  uint64_t at = (Simulator::Now () + std::max (delay, Time (0))).GetTimeStep ();
+  uint64_t tick = (at + step - 1) / step;
+
+  auto it = m_due.find (key);
+  if (it != m_due.end () && it->second == tick)
+    {
+      return;
+    }
+  m_due[key] = tick;
+  m_slots[tick % m_slots.size ()].push_back ({key, tick});
+  Arm (tick);
+}
+
+void
+OspfTimerWheel::Cancel (Key key)
+{
+  m_due.erase (key);
+}
+
+bool
+OspfTimerWheel::IsScheduled (Key key) const
+{
+  return m_due.find (key) != m_due.end ();
+}
+
+Time
+OspfTimerWheel::GetDelayLeft (Key key) const
+{
+  auto it = m_due.find (key);
+  if (it == m_due.end ())
+    {
+      return Time::Max ();
+    }
+  return std::max (GetTickTime (it->second) - Simulator::Now (), Time (0));
+}
+
+uint32_t
+OspfTimerWheel::GetN () const
+{
+  return m_due.size ();
+}
+
+void
+OspfTimerWheel::Clear ()
+{
+  m_event.Cancel ();
+  m_due.clear ();
+  for (auto &slot : m_slots)
+    {
+      slot.clear ();
+    }
+}
+
+void
+OspfTimerWheel::Arm (uint64_t tick)
+{
+  if (m_event.IsRunning () && m_eventTick <= tick)
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_eventTick = tick;
+  m_event = Simulator::Schedule (std::max (GetTickTime (tick) - Simulator::Now (), Time (0)),
+                                 &OspfTimerWheel::Expire, this);
+}
+
+void
+OspfTimerWheel::Expire ()
+{
+  uint64_t now = m_eventTick;
+  m_event = EventId ();
+
+  // Take the slot out first, the callbacks may schedule into it again
+  std::vector<Entry> entries;
+  std::swap (entries, m_slots[now % m_slots.size ()]);
+  std::vector<Key> expired;
+  for (const Entry &entry : entries)
+    {
+      auto it = m_due.find (entry.key);
+      if (it == m_due.end () || it->second != entry.tick)
+        {
+          // Cancelled or moved
+          continue;
+        }
+      if (entry.tick <= now)
+        {
+          m_due.erase (it);
+          expired.push_back (entry.key);
+        }
+      else
+        {
+          m_slots[now % m_slots.size ()].push_back (entry);
+        }
+    }
+
+  for (Key key : expired)
+    {
+      if (!m_expire.IsNull ())
+        {
+          m_expire (key);
+        }
+    }
+
+  if (m_due.empty ())
+    {
+      return;
+    }
+  for (uint64_t tick = now + 1; tick <= now + m_slots.size (); tick++)
+    {
+      if (!m_slots[tick % m_slots.size ()].empty ())
+        {
+          Arm (tick);
+          return;
+        }
+    }
+}
+
+} // namespace ns3
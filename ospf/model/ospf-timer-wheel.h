@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef OSPF_TIMER_WHEEL_H
+#define OSPF_TIMER_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// Hashed timer wheel (Varghese and Lauck) for many coarse, keyed timers
+// behind one simulator event. Expiry times are rounded up to a whole tick
+// and a key lands in slot (tick % slots). The event is armed for the next
+// slot holding anything, so a timer further out than one revolution costs
+// a visit per revolution. Scheduling a key again moves it; the entry it
+// leaves behind is dropped when its slot comes around.
+class OspfTimerWheel
+{
+public:
+  typedef uint64_t Key;
+  typedef Callback<void, Key> ExpireCallback;
+
+  OspfTimerWheel (Time tick, uint32_t nSlots);
+  ~OspfTimerWheel ();
+  OspfTimerWheel (const OspfTimerWheel &) = delete;
+  OspfTimerWheel &operator= (const OspfTimerWheel &) = delete;
+
+  // Called once per expired key, after the key is unscheduled
+  void SetExpireCallback (ExpireCallback expire);
+
+  // Expire the key after at least delay, replacing its previous timer
+  void Schedule (Key key, Time delay);
+  void Cancel (Key key);
+  bool IsScheduled (Key key) const;
+  // Time::Max () if the key is not scheduled
+  Time GetDelayLeft (Key key) const;
+  // Scheduled keys
+  uint32_t GetN () const;
+  // Unschedules every key and cancels the event
+  void Clear ();
+
+private:
+  struct Entry
+  {
+    Key key;
+    uint64_t tick;
+  };
+
+  Time GetTickTime (uint64_t tick) const;
+  void Arm (uint64_t tick);
+  void Expire ();
+
+  Time m_tick;
+  std::vector<std::vector<Entry>> m_slots;
+  std::unordered_map<Key, uint64_t> m_due; //!< Expiry tick of every scheduled key
+  EventId m_event;
+  uint64_t m_eventTick = 0; //!< Tick m_event runs at
+  ExpireCallback m_expire;
+};
+
+} // namespace ns3
+
+#endif // OSPF_TIMER_WHEEL_H
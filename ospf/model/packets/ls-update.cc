@@ -26,6 +26,7 @@
 #include "ns3/router-lsa.h"
 #include "ns3/l1-summary-lsa.h"
 #include "ns3/l2-summary-lsa.h"
+#include "ns3/lsa-pool.h"
 #include "ls-update.h"
 
 #include <vector>
@@ -36,6 +37,31 @@ NS_LOG_COMPONENT_DEFINE ("LsUpdate");
 
 NS_OBJECT_ENSURE_REGISTERED (LsUpdate);
 
+namespace {
+
+// A flooded instance reaches every router; only the first to receive it
+// decodes the body, the rest share it through the pool
+template <typename T>
+Ptr<T>
+DecodeLsa (const LsaHeader &lsaHeader, const std::vector<uint8_t> &payloadBytes)
+{
+  const uint32_t size = payloadBytes.size ();
+  const uint64_t digest = LsaPool::Digest (payloadBytes.data (), size);
+  Ptr<T> lsa = DynamicCast<T> (LsaPool::Find (lsaHeader, size, digest));
+  if (lsa != nullptr)
+    {
+      return lsa;
+    }
+  Buffer payloadBuffer;
+  payloadBuffer.AddAtStart (size);
+  payloadBuffer.Begin ().Write (payloadBytes.data (), size);
+  lsa = Create<T> ();
+  lsa->Deserialize (payloadBuffer.Begin ());
+  return DynamicCast<T> (LsaPool::Intern (lsaHeader, lsa, size, digest));
+}
+
+} // namespace
+
 LsUpdate::LsUpdate ()
 {
   m_serializedSize = 4;
@@ -196,16 +222,10 @@ LsUpdate::Deserialize (Buffer::Iterator start)
 
       std::vector<uint8_t> payloadBytes (declaredPayloadSize);
       i.Read (payloadBytes.data (), declaredPayloadSize);
-      Buffer payloadBuffer;
-      payloadBuffer.AddAtStart (declaredPayloadSize);
-      payloadBuffer.Begin ().Write (payloadBytes.data (), declaredPayloadSize);
-
-      Buffer::Iterator payloadIt = payloadBuffer.Begin ();
 
       if (lsaHeader.GetType () == LsaHeader::RouterLSAs)
         {
-          Ptr<RouterLsa> lsa = Create<RouterLsa> ();
-          payloadIt.Next (lsa->Deserialize (payloadIt));
+          Ptr<RouterLsa> lsa = DecodeLsa<RouterLsa> (lsaHeader, payloadBytes);
           m_lsaList.emplace_back (lsaHeader, lsa);
           const uint16_t expectedLength = static_cast<uint16_t> (
               lsaHeader.GetSerializedSize () + lsa->GetSerializedSize ());
@@ -222,8 +242,7 @@ LsUpdate::Deserialize (Buffer::Iterator start)
         }
       else if (lsaHeader.GetType () == LsaHeader::AreaLSAs)
         {
-          Ptr<AreaLsa> lsa = Create<AreaLsa> ();
-          payloadIt.Next (lsa->Deserialize (payloadIt));
+          Ptr<AreaLsa> lsa = DecodeLsa<AreaLsa> (lsaHeader, payloadBytes);
           m_lsaList.emplace_back (lsaHeader, lsa);
           const uint16_t expectedLength = static_cast<uint16_t> (
               lsaHeader.GetSerializedSize () + lsa->GetSerializedSize ());
@@ -239,8 +258,7 @@ LsUpdate::Deserialize (Buffer::Iterator start)
         }
       else if (lsaHeader.GetType () == LsaHeader::L2SummaryLSAs)
         {
-          Ptr<L2SummaryLsa> lsa = Create<L2SummaryLsa> ();
-          payloadIt.Next (lsa->Deserialize (payloadIt));
+          Ptr<L2SummaryLsa> lsa = DecodeLsa<L2SummaryLsa> (lsaHeader, payloadBytes);
           m_lsaList.emplace_back (lsaHeader, lsa);
           const uint16_t expectedLength = static_cast<uint16_t> (
               lsaHeader.GetSerializedSize () + lsa->GetSerializedSize ());
@@ -256,8 +274,7 @@ LsUpdate::Deserialize (Buffer::Iterator start)
         }
       else if (lsaHeader.GetType () == LsaHeader::L1SummaryLSAs)
         {
-          Ptr<L1SummaryLsa> lsa = Create<L1SummaryLsa> ();
-          payloadIt.Next (lsa->Deserialize (payloadIt));
+          Ptr<L1SummaryLsa> lsa = DecodeLsa<L1SummaryLsa> (lsaHeader, payloadBytes);
           m_lsaList.emplace_back (lsaHeader, lsa);
           const uint16_t expectedLength = static_cast<uint16_t> (
               lsaHeader.GetSerializedSize () + lsa->GetSerializedSize ());
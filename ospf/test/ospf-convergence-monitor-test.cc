@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/rng-seed-manager.h"
+
+#include "ns3/ospf-app-helper.h"
+#include "ns3/ospf-app.h"
+#include "ns3/ospf-convergence-monitor.h"
+
+#include "ospf-test-utils.h"
+
+#include <filesystem>
+#include <string>
+
+namespace ns3 {
+
+namespace {
+
+using ospf_test_utils::ReadAll;
+using ospf_test_utils::HasRouteLine;
+
+// Cold-start 3-node line; the apps start at 0.5s
+ApplicationContainer
+BuildColdStartLine (NodeContainer &nodes)
+{
+  nodes.Create (3);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer d01 = p2p.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  NetDeviceContainer d12 = p2p.Install (NodeContainer (nodes.Get (1), nodes.Get (2)));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.252");
+  ipv4.Assign (d01);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.252");
+  ipv4.Assign (d12);
+
+  OspfAppHelper ospf;
+  ospf.SetAttribute ("HelloAddress", Ipv4AddressValue (Ipv4Address ("224.0.0.5")));
+  ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+  ospf.SetAttribute ("ShortestPathUpdateDelay", TimeValue (MilliSeconds (50)));
+  ospf.SetAttribute ("InitialHelloDelay", TimeValue (Seconds (0)));
+  ospf.SetAttribute ("HelloInterval", TimeValue (MilliSeconds (200)));
+  ospf.SetAttribute ("RouterDeadInterval", TimeValue (MilliSeconds (600)));
+  ospf.SetAttribute ("LSUInterval", TimeValue (MilliSeconds (500)));
+
+  ApplicationContainer apps = ospf.Install (nodes);
+  ospf.ConfigureReachablePrefixesFromInterfaces (nodes);
+  apps.Start (Seconds (0.5));
+  apps.Stop (Seconds (8.0));
+  return apps;
+}
+
+// Cold-start 4-node line split into areas 0 (nodes 0, 1) and 1 (nodes 2, 3);
+// the apps start at 0.5s
+ApplicationContainer
+BuildTwoAreaLine (NodeContainer &nodes)
+{
+  nodes.Create (4);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer d01 = p2p.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  NetDeviceContainer d12 = p2p.Install (NodeContainer (nodes.Get (1), nodes.Get (2)));
+  NetDeviceContainer d23 = p2p.Install (NodeContainer (nodes.Get (2), nodes.Get (3)));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.252");
+  ipv4.Assign (d01);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.252");
+  ipv4.Assign (d12);
+  ipv4.SetBase ("10.1.3.0", "255.255.255.252");
+  ipv4.Assign (d23);
+
+  OspfAppHelper ospf;
+  ospf.SetAttribute ("HelloAddress", Ipv4AddressValue (Ipv4Address ("224.0.0.5")));
+  ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+  ospf.SetAttribute ("EnableAreaProxy", BooleanValue (true));
+  ospf.SetAttribute ("ShortestPathUpdateDelay", TimeValue (MilliSeconds (50)));
+  ospf.SetAttribute ("InitialHelloDelay", TimeValue (Seconds (0)));
+  ospf.SetAttribute ("HelloInterval", TimeValue (MilliSeconds (200)));
+  ospf.SetAttribute ("RouterDeadInterval", TimeValue (MilliSeconds (600)));
+  ospf.SetAttribute ("LSUInterval", TimeValue (MilliSeconds (500)));
+
+  ApplicationContainer apps = ospf.Install (nodes);
+  ospf.ConfigureReachablePrefixesFromInterfaces (nodes);
+  for (uint32_t i = 0; i < apps.GetN (); i++)
+    {
+      DynamicCast<OspfApp> (apps.Get (i))->SetArea (i < 2 ? 0 : 1);
+    }
+  apps.Start (Seconds (0.5));
+  apps.Stop (Seconds (10.0));
+  return apps;
+}
+
+} // namespace
+
+class OspfConvergenceMonitorColdStartTestCase : public TestCase
+{
+public:
+  OspfConvergenceMonitorColdStartTestCase ()
+    : TestCase ("OspfConvergenceMonitor records when a cold start converges")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildColdStartLine (nodes);
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+
+    OspfConvergenceMonitor monitor;
+    monitor.Install (nodes);
+    NS_TEST_ASSERT_MSG_EQ (monitor.IsLsdbConverged (), true, "empty LSDBs are equal");
+
+    const std::filesystem::path outDir = CreateTempDirFilename ("ospf-convergence-monitor");
+    std::filesystem::create_directories (outDir);
+    Simulator::Schedule (Seconds (7.0), &OspfApp::PrintRouting, app0, outDir, "n0.routes");
+
+    Simulator::Stop (Seconds (8.0));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (monitor.IsLsdbConverged (), true, "LSDBs converged");
+    NS_TEST_ASSERT_MSG_EQ (monitor.IsFibConverged (), true, "FIBs converged");
+    NS_TEST_ASSERT_MSG_EQ (monitor.GetNLsdbs (app0->GetArea ()), 1, "one LSDB in the area");
+    NS_TEST_ASSERT_MSG_GT (monitor.GetLsdbConvergenceTime (), Seconds (0.5), "after the start");
+    NS_TEST_ASSERT_MSG_LT (monitor.GetLsdbConvergenceTime (), Seconds (7.0), "well before the end");
+    NS_TEST_ASSERT_MSG_GT (monitor.GetFibConvergenceTime (), Seconds (0.5), "routes written");
+    NS_TEST_ASSERT_MSG_LT (monitor.GetFibConvergenceTime (), Seconds (7.0), "and then left alone");
+
+    const std::string n0 = ReadAll (outDir / "n0.routes");
+    NS_TEST_ASSERT_MSG_EQ (HasRouteLine (n0, "10.1.2.0", "10.1.1.2"), true,
+                           "node0 should have a route to 10.1.2.0/30 via 10.1.1.2\n" + n0);
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfConvergenceMonitorStopTestCase : public TestCase
+{
+public:
+  OspfConvergenceMonitorStopTestCase ()
+    : TestCase ("OspfConvergenceMonitor stops the simulation once the FIBs converge")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildColdStartLine (nodes);
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+
+    OspfConvergenceMonitor monitor;
+    monitor.Install (nodes);
+    monitor.SetStopOnConvergence (true);
+
+    Simulator::Stop (Seconds (8.0));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (monitor.IsFibConverged (), true, "stopped on convergence");
+    NS_TEST_ASSERT_MSG_LT (Simulator::Now (), Seconds (7.0), "before the scheduled stop");
+    NS_TEST_ASSERT_MSG_EQ ((Simulator::Now () >= monitor.GetFibConvergenceTime ()), true,
+                           "after the last routing table write");
+
+    const std::filesystem::path outDir = CreateTempDirFilename ("ospf-convergence-monitor-stop");
+    std::filesystem::create_directories (outDir);
+    app0->PrintRouting (outDir, "n0.routes");
+    const std::string n0 = ReadAll (outDir / "n0.routes");
+    NS_TEST_ASSERT_MSG_EQ (HasRouteLine (n0, "10.1.2.0", "10.1.1.2"), true,
+                           "routes are in place when the simulation stops\n" + n0);
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfConvergenceMonitorTwoAreasTestCase : public TestCase
+{
+public:
+  OspfConvergenceMonitorTwoAreasTestCase ()
+    : TestCase ("OspfConvergenceMonitor waits for the area leaders' L2 LSAs")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildTwoAreaLine (nodes);
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+
+    OspfConvergenceMonitor monitor;
+    monitor.Install (nodes);
+    monitor.SetStopOnConvergence (true);
+
+    Simulator::Stop (Seconds (10.0));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (monitor.IsFibConverged (), true, "stopped on convergence");
+    NS_TEST_ASSERT_MSG_LT (Simulator::Now (), Seconds (9.0), "before the scheduled stop");
+    NS_TEST_ASSERT_MSG_EQ (monitor.GetNLsdbs (0), 1, "one L1 LSDB in area 0");
+    NS_TEST_ASSERT_MSG_EQ (monitor.GetNLsdbs (1), 1, "one L1 LSDB in area 1");
+    NS_TEST_ASSERT_MSG_EQ (monitor.GetNL2Lsdbs (), 1, "one L2 LSDB across the areas");
+    for (uint32_t i = 0; i < apps.GetN (); i++)
+      {
+        Ptr<OspfApp> app = DynamicCast<OspfApp> (apps.Get (i));
+        NS_TEST_ASSERT_MSG_EQ (app->GetAreaLsdb ().size (), 2u,
+                               "both Area-LSAs installed before the stop");
+        NS_TEST_ASSERT_MSG_EQ (app->GetL2SummaryLsdb ().size (), 2u,
+                               "both L2 Summary-LSAs installed before the stop");
+      }
+
+    const std::filesystem::path outDir = CreateTempDirFilename ("ospf-convergence-monitor-areas");
+    std::filesystem::create_directories (outDir);
+    app0->PrintRouting (outDir, "n0.routes");
+    const std::string n0 = ReadAll (outDir / "n0.routes");
+    NS_TEST_ASSERT_MSG_EQ (HasRouteLine (n0, "10.1.3.0", "10.1.1.2"), true,
+                           "inter-area routes are in place when the simulation stops\n" + n0);
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfConvergenceMonitorTestSuite : public TestSuite
+{
+public:
+  OspfConvergenceMonitorTestSuite ()
+    : TestSuite ("ospf-convergence-monitor", UNIT)
+  {
+    AddTestCase (new OspfConvergenceMonitorColdStartTestCase, TestCase::QUICK);
+    AddTestCase (new OspfConvergenceMonitorStopTestCase, TestCase::QUICK);
+    AddTestCase (new OspfConvergenceMonitorTwoAreasTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfConvergenceMonitorTestSuite g_ospfConvergenceMonitorTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "../model/ospf-fib-compressor.h"
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class OspfFibCompressorAggregateTestCase : public TestCase
+{
+public:
+  OspfFibCompressorAggregateTestCase ()
+    : TestCase ("OspfFibCompressor aggregates prefixes without covering holes")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfFibCompressor fib;
+    std::vector<OspfFibCompressor::Entry> removed, added;
+
+    // Four /26s through the same next hop make one /24
+    for (uint32_t i = 0; i < 4; i++)
+      {
+        fib.Set (0x0a000000 | i << 6, 26, 1);
+      }
+    fib.Compress (removed, added);
+    NS_TEST_EXPECT_MSG_EQ (fib.GetNPrefixes (), 4, "four prefixes");
+    NS_TEST_EXPECT_MSG_EQ (added.size (), 1, "one aggregate");
+    NS_TEST_EXPECT_MSG_EQ ((added[0] == OspfFibCompressor::Entry (0x0a000000, 24, 1)), true,
+                           "10.0.0/24");
+
+    // One of them moves: the aggregate stays and the odd one overrides it
+    removed.clear ();
+    added.clear ();
+    fib.Set (0x0a000040, 26, 2);
+    fib.Compress (removed, added);
+    NS_TEST_EXPECT_MSG_EQ (removed.size (), 0, "aggregate kept");
+    NS_TEST_EXPECT_MSG_EQ (added.size (), 1, "one more-specific");
+    NS_TEST_EXPECT_MSG_EQ ((added[0] == OspfFibCompressor::Entry (0x0a000040, 26, 2)), true,
+                           "10.0.0.64/26");
+
+    // A covering route through the odd one's next hop
+    fib.Set (0x0a000000, 16, 2);
+    removed.clear ();
+    added.clear ();
+    fib.Compress (removed, added);
+    NS_TEST_EXPECT_MSG_EQ (fib.GetNEntries (), 3, "/16, then the /24, then the /26 again");
+
+    // Without the covering route, a withdrawn /26 is a hole the /24 may
+    // not cover
+    fib.Set (0x0a000000, 16, OspfFibCompressor::NO_ROUTE);
+    fib.Set (0x0a0000c0, 26, OspfFibCompressor::NO_ROUTE);
+    fib.Set (0x0a000040, 26, 1);
+    fib.Compress (removed, added);
+    NS_TEST_EXPECT_MSG_EQ (fib.GetNPrefixes (), 3, "three prefixes");
+    std::vector<OspfFibCompressor::Entry> expected = {{0x0a000000, 25, 1}, {0x0a000080, 26, 1}};
+    NS_TEST_EXPECT_MSG_EQ ((fib.GetEntries () == expected), true, "/25 and /26");
+    NS_TEST_EXPECT_MSG_EQ (fib.Get (0x0a000080, 26), 1, "input kept");
+    NS_TEST_EXPECT_MSG_EQ (fib.Get (0x0a000000, 25), OspfFibCompressor::NO_ROUTE,
+                           "aggregates are not input");
+  }
+};
+
+class OspfFibCompressorIncrementalTestCase : public TestCase
+{
+public:
+  OspfFibCompressorIncrementalTestCase ()
+    : TestCase ("OspfFibCompressor reports the changes that keep a table equivalent")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    // <prefix, length> -> next hop
+    typedef std::map<std::pair<uint32_t, uint8_t>, uint32_t> Table;
+    auto lookup = [] (const Table &table, uint32_t address) {
+      uint32_t nextHop = OspfFibCompressor::NO_ROUTE;
+      for (auto &[key, value] : table)
+        {
+          uint32_t mask = key.second == 0 ? 0 : ~0u << (32 - key.second);
+          if ((address & mask) == key.first)
+            {
+              nextHop = value; // longer prefixes come later
+            }
+        }
+      return nextHop;
+    };
+
+    OspfFibCompressor fib;
+    Table input, table;
+    uint32_t seed = 1;
+    for (uint32_t round = 0; round < 50; round++)
+      {
+        for (uint32_t i = 0; i < 8; i++)
+          {
+            seed = seed * 1103515245 + 12345;
+            uint8_t length = 20 + (seed >> 8) % 9;
+            uint32_t prefix = 0x0a000000 | ((seed >> 16) & 0xfff) << 4;
+            prefix &= ~0u << (32 - length);
+            uint32_t nextHop = (seed >> 4) % 4; // NO_ROUTE a quarter of the time
+            fib.Set (prefix, length, nextHop);
+            if (nextHop == OspfFibCompressor::NO_ROUTE)
+              {
+                input.erase ({prefix, length});
+              }
+            else
+              {
+                input[{prefix, length}] = nextHop;
+              }
+          }
+
+        std::vector<OspfFibCompressor::Entry> removed, added;
+        fib.Compress (removed, added);
+        for (auto &[prefix, length, nextHop] : removed)
+          {
+            auto it = table.find ({prefix, length});
+            NS_TEST_ASSERT_MSG_EQ ((it != table.end () && it->second == nextHop), true,
+                                   "removed entry was installed");
+            table.erase (it);
+          }
+        for (auto &[prefix, length, nextHop] : added)
+          {
+            NS_TEST_ASSERT_MSG_EQ (table.count ({prefix, length}), 0, "added entry is new");
+            table[{prefix, length}] = nextHop;
+          }
+        NS_TEST_ASSERT_MSG_EQ (fib.GetNEntries (), table.size (), "entry count");
+        NS_TEST_ASSERT_MSG_EQ (fib.GetNPrefixes (), input.size (), "prefix count");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ (table.size (), input.size (), "never larger");
+
+        // Same next hop at both ends of every prefix and just past them
+        for (auto &[key, value] : input)
+          {
+            (void)value;
+            uint32_t last = key.first | ~(~0u << (32 - key.second));
+            for (uint32_t address : {key.first - 1, key.first, last, last + 1})
+              {
+                NS_TEST_ASSERT_MSG_EQ (lookup (table, address), lookup (input, address),
+                                       "forwarding preserved");
+              }
+          }
+      }
+
+    fib.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (fib.GetNEntries (), 0, "cleared");
+    NS_TEST_EXPECT_MSG_EQ (fib.GetEntries ().size (), 0, "nothing left");
+  }
+};
+
+class OspfFibCompressorTestSuite : public TestSuite
+{
+public:
+  OspfFibCompressorTestSuite ()
+    : TestSuite ("ospf-fib-compressor", UNIT)
+  {
+    AddTestCase (new OspfFibCompressorAggregateTestCase, TestCase::QUICK);
+    AddTestCase (new OspfFibCompressorIncrementalTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfFibCompressorTestSuite g_ospfFibCompressorTestSuite;
+
+} // namespace ns3
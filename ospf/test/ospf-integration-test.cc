@@ -215,9 +215,9 @@ public:
 
     NS_TEST_ASSERT_MSG_GT (tx0 + tx1 + tx2, 0u, "expected at least one Tx trace event");
 
-    const uint32_t h0 = app0->GetLsdbHash ();
-    const uint32_t h1 = app1->GetLsdbHash ();
-    const uint32_t h2 = app2->GetLsdbHash ();
+    const uint64_t h0 = app0->GetLsdbHash ();
+    const uint64_t h1 = app1->GetLsdbHash ();
+    const uint64_t h2 = app2->GetLsdbHash ();
 
     NS_TEST_ASSERT_MSG_NE (h0, 0u, "expected non-zero LSDB hash after cold start");
     NS_TEST_ASSERT_MSG_EQ (h0, h1, "expected LSDB hashes to match after cold start (n0 vs n1)");
@@ -289,10 +289,10 @@ public:
         ospfApps.push_back (app);
       }
 
-    const uint32_t routerHash = ospfApps[0]->GetLsdbHash ();
-    const uint32_t l1Hash = ospfApps[0]->GetL1SummaryLsdbHash ();
-    const uint32_t areaHash = ospfApps[0]->GetAreaLsdbHash ();
-    const uint32_t l2Hash = ospfApps[0]->GetL2SummaryLsdbHash ();
+    const uint64_t routerHash = ospfApps[0]->GetLsdbHash ();
+    const uint64_t l1Hash = ospfApps[0]->GetL1SummaryLsdbHash ();
+    const uint64_t areaHash = ospfApps[0]->GetAreaLsdbHash ();
+    const uint64_t l2Hash = ospfApps[0]->GetL2SummaryLsdbHash ();
 
     for (uint32_t i = 1; i < ospfApps.size (); ++i)
       {
@@ -324,10 +324,10 @@ public:
     const std::filesystem::path outDir = CreateTempDirFilename ("ospf-integration-export");
     std::filesystem::create_directories (outDir);
 
-    std::vector<uint32_t> baselineRouterHashes;
-    std::vector<uint32_t> baselineL1Hashes;
-    std::vector<uint32_t> baselineAreaHashes;
-    std::vector<uint32_t> baselineL2Hashes;
+    std::vector<uint64_t> baselineRouterHashes;
+    std::vector<uint64_t> baselineL1Hashes;
+    std::vector<uint64_t> baselineAreaHashes;
+    std::vector<uint64_t> baselineL2Hashes;
 
     // Phase 1: preload and export.
     {
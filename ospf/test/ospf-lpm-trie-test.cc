@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "../model/ospf-lpm-trie.h"
+
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+class OspfLpmTrieLookupTestCase : public TestCase
+{
+public:
+  OspfLpmTrieLookupTestCase ()
+    : TestCase ("OspfLpmTrie finds the longest matching prefix and falls back on removal")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLpmTrie trie;
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a000001), OspfLpmTrie::NO_VALUE, "empty trie");
+
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x00000000, 0, 1), true, "default route");
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x0a000000, 8, 2), true, "10/8");
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x0a0100ff, 24, 3), true, "10.1.0/24, host bits ignored");
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x0a010001, 32, 4), true, "10.1.0.1/32");
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x0a020000, 16, 5), true, "10.2/16 branches off 10/8");
+    NS_TEST_EXPECT_MSG_EQ (trie.Insert (0x0a0100aa, 24, 6), false, "replacing is not new");
+    NS_TEST_EXPECT_MSG_EQ (trie.GetSize (), 5, "five prefixes");
+
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a010001), 4, "host route");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a010002), 6, "replaced /24");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a020304), 5, "/16");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a030000), 2, "/8");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0xc0a80001), 1, "default");
+    NS_TEST_EXPECT_MSG_EQ (trie.Find (0x0a010000, 24), 6, "exact match");
+    NS_TEST_EXPECT_MSG_EQ (trie.Find (0x0a010000, 23), OspfLpmTrie::NO_VALUE,
+                           "branching node is not a prefix");
+
+    // The filter skips values, e.g. unresolved routes
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a010001, [] (uint32_t value) { return value != 4; }),
+                           6, "filtered host route falls back to the /24");
+
+    NS_TEST_EXPECT_MSG_EQ (trie.Remove (0x0a010000, 24), true, "remove /24");
+    NS_TEST_EXPECT_MSG_EQ (trie.Remove (0x0a010000, 24), false, "already removed");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a010002), 2, "falls back to /8");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a010001), 4, "host route below it stays");
+    NS_TEST_EXPECT_MSG_EQ (trie.Remove (0x00000000, 0), true, "remove default");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0xc0a80001), OspfLpmTrie::NO_VALUE, "no match");
+    NS_TEST_EXPECT_MSG_EQ (trie.GetSize (), 3, "three prefixes left");
+  }
+};
+
+class OspfLpmTrieBulkUpdateTestCase : public TestCase
+{
+public:
+  OspfLpmTrieBulkUpdateTestCase ()
+    : TestCase ("OspfLpmTrie reclaims removed nodes after a bulk update")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLpmTrie trie;
+    for (uint32_t i = 0; i < 256; i++)
+      {
+        trie.Insert (0x0a000000 | i << 8, 24, i);
+      }
+    const uint32_t nodes = trie.GetNNodes ();
+    NS_TEST_EXPECT_MSG_LT (nodes, 2 * 256, "fewer than two nodes per prefix");
+
+    // Replace every /24 by its two /25 halves
+    trie.BeginBulkUpdate ();
+    for (uint32_t i = 0; i < 256; i++)
+      {
+        trie.Remove (0x0a000000 | i << 8, 24);
+        trie.Insert (0x0a000000 | i << 8, 25, 2 * i);
+        trie.Insert (0x0a000080 | i << 8, 25, 2 * i + 1);
+      }
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a0005c0), 11, "changes apply inside the batch");
+    trie.EndBulkUpdate ();
+
+    NS_TEST_EXPECT_MSG_EQ (trie.GetSize (), 512, "every half");
+    NS_TEST_EXPECT_MSG_LT (trie.GetNNodes (), 2 * 512, "rebuilt without the emptied nodes");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a00ff01), 510, "lower half");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a00ff81), 511, "upper half");
+
+    std::vector<OspfLpmTrie::Entry> entries = trie.GetEntries ();
+    NS_TEST_EXPECT_MSG_EQ (entries.size (), 512, "one entry per prefix");
+    bool sorted = true;
+    for (uint32_t i = 1; i < entries.size (); i++)
+      {
+        sorted = sorted && std::get<2> (entries[i - 1]) + 1 == std::get<2> (entries[i]);
+      }
+    NS_TEST_EXPECT_MSG_EQ (sorted, true, "entries in prefix order");
+
+    trie.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (trie.GetSize (), 0, "cleared");
+    NS_TEST_EXPECT_MSG_EQ (trie.Lookup (0x0a00ff01), OspfLpmTrie::NO_VALUE, "nothing left");
+  }
+};
+
+class OspfLpmTrieTestSuite : public TestSuite
+{
+public:
+  OspfLpmTrieTestSuite ()
+    : TestSuite ("ospf-lpm-trie", UNIT)
+  {
+    AddTestCase (new OspfLpmTrieLookupTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLpmTrieBulkUpdateTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfLpmTrieTestSuite g_ospfLpmTrieTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,348 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/rng-seed-manager.h"
+
+#include "ns3/ospf-app-helper.h"
+#include "ns3/ospf-app.h"
+#include "ns3/router-lsa.h"
+
+#include "../model/ospf-timer-wheel.h"
+
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+namespace {
+
+typedef std::vector<std::pair<OspfTimerWheel::Key, Time>> ExpiryLog;
+
+void
+RecordExpiry (ExpiryLog *log, OspfTimerWheel::Key key)
+{
+  log->emplace_back (key, Simulator::Now ());
+}
+
+void
+SnapshotSeqNum (uint32_t *out, Ptr<OspfApp> app, Ptr<OspfApp> origin)
+{
+  auto lsdb = app->GetLsdb ();
+  auto it = lsdb.find (origin->GetRouterId ().Get ());
+  *out = it == lsdb.end () ? 0 : it->second.first.GetSeqNum ();
+}
+
+void
+SnapshotHasRouterLsa (bool *out, Ptr<OspfApp> app, uint32_t routerId)
+{
+  auto lsdb = app->GetLsdb ();
+  *out = lsdb.find (routerId) != lsdb.end ();
+}
+
+void
+SnapshotHasL1SummaryLsa (bool *out, Ptr<OspfApp> app, uint32_t routerId)
+{
+  auto lsdb = app->GetL1SummaryLsdb ();
+  *out = lsdb.find (routerId) != lsdb.end ();
+}
+
+void
+SnapshotNLsdbKeys (uint32_t *out, Ptr<OspfApp> app)
+{
+  *out = app->GetNLsdbKeys ();
+}
+
+// Router-LSAs of routers that do not exist, 10.99.<round>.<i>
+std::vector<std::pair<LsaHeader, Ptr<Lsa>>>
+MakeGhostLsas (uint32_t round, uint32_t n)
+{
+  std::vector<std::pair<LsaHeader, Ptr<Lsa>>> lsaList;
+  for (uint32_t i = 1; i <= n; i++)
+    {
+      const uint32_t ghost = Ipv4Address ("10.99.0.0").Get () + (round << 8) + i;
+      Ptr<RouterLsa> lsa = Create<RouterLsa> (false, false, false);
+      LsaHeader header (std::make_tuple (LsaHeader::RouterLSAs, ghost, ghost));
+      header.SetSeqNum (1);
+      header.SetLength (header.GetSerializedSize () + lsa->GetSerializedSize ());
+      lsaList.emplace_back (header, lsa);
+    }
+  return lsaList;
+}
+
+uint32_t
+GetNLsas (Ptr<OspfApp> app)
+{
+  return app->GetLsdb ().size () + app->GetL1SummaryLsdb ().size () +
+         app->GetAreaLsdb ().size () + app->GetL2SummaryLsdb ().size ();
+}
+
+// 3-node line; the apps start at 0.5s
+ApplicationContainer
+BuildLine (NodeContainer &nodes, Time lsRefreshTime, Time maxAge, Time stop)
+{
+  nodes.Create (3);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer d01 = p2p.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  NetDeviceContainer d12 = p2p.Install (NodeContainer (nodes.Get (1), nodes.Get (2)));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.252");
+  ipv4.Assign (d01);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.252");
+  ipv4.Assign (d12);
+
+  OspfAppHelper ospf;
+  ospf.SetAttribute ("HelloAddress", Ipv4AddressValue (Ipv4Address ("224.0.0.5")));
+  ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+  ospf.SetAttribute ("ShortestPathUpdateDelay", TimeValue (MilliSeconds (50)));
+  ospf.SetAttribute ("InitialHelloDelay", TimeValue (Seconds (0)));
+  ospf.SetAttribute ("HelloInterval", TimeValue (MilliSeconds (200)));
+  ospf.SetAttribute ("RouterDeadInterval", TimeValue (MilliSeconds (600)));
+  ospf.SetAttribute ("LSUInterval", TimeValue (MilliSeconds (500)));
+  ospf.SetAttribute ("LSRefreshTime", TimeValue (lsRefreshTime));
+  ospf.SetAttribute ("MaxAge", TimeValue (maxAge));
+
+  ApplicationContainer apps = ospf.Install (nodes);
+  ospf.ConfigureReachablePrefixesFromInterfaces (nodes);
+  apps.Start (Seconds (0.5));
+  apps.Stop (stop);
+  return apps;
+}
+
+} // namespace
+
+class OspfTimerWheelTestCase : public TestCase
+{
+public:
+  OspfTimerWheelTestCase ()
+    : TestCase ("OspfTimerWheel expires moved and far-off timers on whole ticks")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    ExpiryLog log;
+    OspfTimerWheel wheel (Seconds (1), 4);
+    wheel.SetExpireCallback (MakeBoundCallback (&RecordExpiry, &log));
+
+    wheel.Schedule (1, MilliSeconds (2500));
+    // Two revolutions out
+    wheel.Schedule (2, Seconds (10));
+    wheel.Schedule (3, Seconds (5));
+    wheel.Schedule (3, Seconds (1));
+    wheel.Schedule (4, Seconds (2));
+    wheel.Cancel (4);
+
+    NS_TEST_ASSERT_MSG_EQ (wheel.GetN (), 3u, "key 4 is cancelled");
+    NS_TEST_ASSERT_MSG_EQ (wheel.IsScheduled (4), false, "key 4 is cancelled");
+    NS_TEST_ASSERT_MSG_EQ (wheel.GetDelayLeft (1), Seconds (3), "rounded up to a whole tick");
+    NS_TEST_ASSERT_MSG_EQ (wheel.GetDelayLeft (4), Time::Max (), "not scheduled");
+
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (log.size (), 3u, "one expiry per scheduled key");
+    NS_TEST_ASSERT_MSG_EQ (log[0].first, 3u, "moved key first");
+    NS_TEST_ASSERT_MSG_EQ (log[0].second, Seconds (1), "at its new time");
+    NS_TEST_ASSERT_MSG_EQ (log[1].first, 1u, "then key 1");
+    NS_TEST_ASSERT_MSG_EQ (log[1].second, Seconds (3), "on the next tick");
+    NS_TEST_ASSERT_MSG_EQ (log[2].first, 2u, "then key 2");
+    NS_TEST_ASSERT_MSG_EQ (log[2].second, Seconds (10), "after two revolutions");
+    NS_TEST_ASSERT_MSG_EQ (wheel.GetN (), 0u, "nothing left");
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsaAgingRefreshTestCase : public TestCase
+{
+public:
+  OspfLsaAgingRefreshTestCase ()
+    : TestCase ("Self-originated LSAs are refreshed before they reach MaxAge")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildLine (nodes, Seconds (10), Seconds (20), Seconds (60));
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+    Ptr<OspfApp> app2 = DynamicCast<OspfApp> (apps.Get (2));
+
+    uint32_t seqBefore = 0;
+    uint32_t seqAfter = 0;
+    Simulator::Schedule (Seconds (5), &SnapshotSeqNum, &seqBefore, app2, app0);
+    Simulator::Schedule (Seconds (55), &SnapshotSeqNum, &seqAfter, app2, app0);
+
+    Simulator::Stop (Seconds (55.5));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_GT (seqBefore, 0u, "node2 learned node0's router LSA");
+    NS_TEST_ASSERT_MSG_GT (seqAfter, seqBefore, "and keeps receiving its refreshes");
+    for (uint32_t i = 0; i < apps.GetN (); i++)
+      {
+        Ptr<OspfApp> app = DynamicCast<OspfApp> (apps.Get (i));
+        NS_TEST_ASSERT_MSG_EQ (app->GetLsdb ().size (), 3u, "no router LSA aged out");
+        NS_TEST_ASSERT_MSG_EQ (app->GetNAgingTimers (), GetNLsas (app), "one timer per LSA");
+      }
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsaAgingMaxAgeTestCase : public TestCase
+{
+public:
+  OspfLsaAgingMaxAgeTestCase ()
+    : TestCase ("An LSA nobody refreshes is flushed at MaxAge")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildLine (nodes, Seconds (10), Seconds (20), Seconds (30));
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+
+    const uint32_t ghost = Ipv4Address ("10.99.0.1").Get ();
+    Simulator::Schedule (Seconds (1), &OspfApp::InjectLsa, app0, MakeGhostLsas (0, 1));
+
+    bool beforeMaxAge = false;
+    bool afterMaxAge = true;
+    Simulator::Schedule (Seconds (15), &SnapshotHasRouterLsa, &beforeMaxAge, app0, ghost);
+    Simulator::Schedule (Seconds (25), &SnapshotHasRouterLsa, &afterMaxAge, app0, ghost);
+
+    Simulator::Stop (Seconds (26));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (beforeMaxAge, true, "installed until MaxAge");
+    NS_TEST_ASSERT_MSG_EQ (afterMaxAge, false, "flushed at MaxAge");
+    NS_TEST_ASSERT_MSG_EQ (app0->GetLsdb ().size (), 3u, "the live routers are kept");
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsaAgingChurnTestCase : public TestCase
+{
+public:
+  OspfLsaAgingChurnTestCase ()
+    : TestCase ("Routers coming and going leave no LSDB state behind")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildLine (nodes, Seconds (10), Seconds (20), Seconds (110));
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+
+    // A new batch of routers every 10s, each gone after MaxAge
+    const uint32_t nRounds = 9;
+    const uint32_t nGhosts = 10;
+    for (uint32_t round = 0; round < nRounds; round++)
+      {
+        Simulator::Schedule (Seconds (5 + 10 * round), &OspfApp::InjectLsa, app0,
+                             MakeGhostLsas (round, nGhosts));
+      }
+
+    uint32_t before = 0;
+    uint32_t during = 0;
+    uint32_t after = 0;
+    Simulator::Schedule (Seconds (4.9), &SnapshotNLsdbKeys, &before, app0);
+    Simulator::Schedule (Seconds (50), &SnapshotNLsdbKeys, &during, app0);
+    Simulator::Schedule (Seconds (105), &SnapshotNLsdbKeys, &after, app0);
+
+    Simulator::Stop (Seconds (106));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_GT (during, before, "the live batches are installed");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ (during, before + 3 * nGhosts, "at most three live batches");
+    NS_TEST_ASSERT_MSG_EQ (after, before, "every batch left with its keys");
+    NS_TEST_ASSERT_MSG_EQ (app0->GetNAgingTimers (), GetNLsas (app0), "one timer per LSA");
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsaAgingDisableTestCase : public TestCase
+{
+public:
+  OspfLsaAgingDisableTestCase ()
+    : TestCase ("Disable() flushes the router's LSAs from its neighbors")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    RngSeedManager::SetSeed (1);
+    RngSeedManager::SetRun (1);
+
+    NodeContainer nodes;
+    ApplicationContainer apps = BuildLine (nodes, Seconds (1800), Seconds (3600), Seconds (8));
+    Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+    Ptr<OspfApp> app2 = DynamicCast<OspfApp> (apps.Get (2));
+    const uint32_t routerId2 = app2->GetRouterId ().Get ();
+
+    bool routerLsaBefore = false;
+    bool routerLsaAfter = true;
+    bool summaryLsaAfter = true;
+    Simulator::Schedule (Seconds (4.9), &SnapshotHasRouterLsa, &routerLsaBefore, app0, routerId2);
+    Simulator::Schedule (Seconds (5), &OspfApp::Disable, app2);
+    Simulator::Schedule (Seconds (6), &SnapshotHasRouterLsa, &routerLsaAfter, app0, routerId2);
+    Simulator::Schedule (Seconds (6), &SnapshotHasL1SummaryLsa, &summaryLsaAfter, app0, routerId2);
+
+    Simulator::Stop (Seconds (7));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (routerLsaBefore, true, "node0 learned node2's router LSA");
+    NS_TEST_ASSERT_MSG_EQ (routerLsaAfter, false, "node2's router LSA is flushed");
+    NS_TEST_ASSERT_MSG_EQ (summaryLsaAfter, false, "node2's L1 summary LSA is flushed");
+    NS_TEST_ASSERT_MSG_EQ (app2->GetLsdb ().count (routerId2), 1u,
+                           "node2 keeps its own copy for Enable()");
+
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsaAgingTestSuite : public TestSuite
+{
+public:
+  OspfLsaAgingTestSuite ()
+    : TestSuite ("ospf-lsa-aging", UNIT)
+  {
+    AddTestCase (new OspfTimerWheelTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsaAgingRefreshTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsaAgingMaxAgeTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsaAgingChurnTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsaAgingDisableTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfLsaAgingTestSuite g_ospfLsaAgingTestSuite;
+
+} // namespace ns3
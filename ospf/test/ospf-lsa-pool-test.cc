@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ls-update.h"
+#include "ns3/lsa-header.h"
+#include "ns3/lsa-pool.h"
+#include "ns3/packet.h"
+#include "ns3/router-lsa.h"
+
+namespace ns3 {
+
+namespace {
+
+LsaHeader
+MakeRouterLsaHeader (uint32_t routerId, uint16_t seqNum, Ptr<RouterLsa> lsa)
+{
+  LsaHeader header (std::make_tuple (LsaHeader::RouterLSAs, routerId, routerId));
+  header.SetSeqNum (seqNum);
+  header.SetLength (header.GetSerializedSize () + lsa->GetSerializedSize ());
+  return header;
+}
+
+Ptr<RouterLsa>
+MakeRouterLsa (uint16_t metric)
+{
+  Ptr<RouterLsa> lsa = Create<RouterLsa> (false, false, false);
+  lsa->AddLink (RouterLink (Ipv4Address ("10.1.1.2").Get (), Ipv4Address ("10.1.1.1").Get (), 1,
+                            metric));
+  return lsa;
+}
+
+} // namespace
+
+class OspfLsaPoolInternTestCase : public TestCase
+{
+public:
+  OspfLsaPoolInternTestCase ()
+    : TestCase ("LsaPool shares equal LSA bodies and forgets them once unused")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    const uint32_t routerId = Ipv4Address ("10.1.1.1").Get ();
+    const uint32_t before = LsaPool::GetNLsas ();
+    {
+      Ptr<RouterLsa> first = MakeRouterLsa (1);
+      LsaHeader header = MakeRouterLsaHeader (routerId, 1, first);
+      NS_TEST_EXPECT_MSG_EQ (first->IsInterned (), false, "fresh body");
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::Intern (header, first), first, "first body interned");
+      NS_TEST_EXPECT_MSG_EQ (first->IsInterned (), true, "now shared");
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::Intern (header, first), first, "interning again is a no-op");
+
+      // Same content built by another router
+      Ptr<RouterLsa> second = MakeRouterLsa (1);
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::Intern (header, second), first, "equal body shared");
+      NS_TEST_EXPECT_MSG_EQ (second->IsInterned (), false, "duplicate left out");
+
+      // Another instance of the same LSA
+      Ptr<RouterLsa> changed = MakeRouterLsa (2);
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::Intern (MakeRouterLsaHeader (routerId, 1, changed), changed),
+                             changed, "same seq, other content");
+      Ptr<RouterLsa> next = MakeRouterLsa (1);
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::Intern (MakeRouterLsaHeader (routerId, 2, next), next), next,
+                             "same content, next seq");
+      NS_TEST_EXPECT_MSG_EQ (LsaPool::GetNLsas (), before + 3, "three bodies");
+
+      // Copies are private
+      Ptr<RouterLsa> copy = DynamicCast<RouterLsa> (first->Copy ());
+      NS_TEST_EXPECT_MSG_EQ (copy->IsInterned (), false, "copy is mutable");
+      copy->AddLink (RouterLink (Ipv4Address ("10.1.1.3").Get (), routerId, 1, 1));
+      NS_TEST_EXPECT_MSG_EQ (first->GetNLink (), 1, "original unchanged");
+    }
+    NS_TEST_EXPECT_MSG_EQ (LsaPool::GetNLsas (), before, "released with the last reference");
+  }
+};
+
+class OspfLsaPoolLsUpdateTestCase : public TestCase
+{
+public:
+  OspfLsaPoolLsUpdateTestCase ()
+    : TestCase ("LsUpdate decodes each flooded LSA body once")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    const uint32_t routerId = Ipv4Address ("10.2.2.2").Get ();
+    Ptr<RouterLsa> originated = MakeRouterLsa (7);
+    LsaHeader header = MakeRouterLsaHeader (routerId, 3, originated);
+    originated = LsaPool::Intern (header, originated);
+
+    Ptr<LsUpdate> in = Create<LsUpdate> ();
+    in->AddLsa (header, originated);
+    Ptr<Packet> payload = in->ConstructPacket ();
+
+    // Every hop decodes the same packet
+    LsUpdate firstHop (payload->Copy ());
+    LsUpdate secondHop (payload->Copy ());
+    NS_TEST_EXPECT_MSG_EQ (firstHop.GetNLsa (), 1, "one LSA");
+    NS_TEST_EXPECT_MSG_EQ (firstHop.GetLsaList ()[0].second, originated,
+                           "originator's body reused");
+    NS_TEST_EXPECT_MSG_EQ (secondHop.GetLsaList ()[0].second, originated, "on every hop");
+
+    // Without the originator the first hop decodes and shares it
+    Ptr<RouterLsa> other = MakeRouterLsa (9);
+    LsaHeader otherHeader = MakeRouterLsaHeader (routerId, 4, other);
+    Ptr<LsUpdate> otherIn = Create<LsUpdate> ();
+    otherIn->AddLsa (otherHeader, other);
+    payload = otherIn->ConstructPacket ();
+    LsUpdate decoded (payload->Copy ());
+    LsUpdate again (payload->Copy ());
+    Ptr<Lsa> body = decoded.GetLsaList ()[0].second;
+    NS_TEST_EXPECT_MSG_EQ ((body != other), true, "decoded, not the sender's object");
+    NS_TEST_EXPECT_MSG_EQ (body->IsInterned (), true, "decoded body shared");
+    NS_TEST_EXPECT_MSG_EQ (again.GetLsaList ()[0].second, body, "second decode reuses it");
+    NS_TEST_EXPECT_MSG_EQ (DynamicCast<RouterLsa> (body)->GetLink (0).m_metric, 9, "content");
+  }
+};
+
+class OspfLsaPoolTestSuite : public TestSuite
+{
+public:
+  OspfLsaPoolTestSuite ()
+    : TestSuite ("ospf-lsa-pool", UNIT)
+  {
+    AddTestCase (new OspfLsaPoolInternTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsaPoolLsUpdateTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfLsaPoolTestSuite g_ospfLsaPoolTestSuite;
+
+} // namespace ns3
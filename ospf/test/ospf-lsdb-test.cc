@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include "../model/ospf-lsdb.h"
+
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+namespace {
+
+LsaHeader
+MakeHeader (uint8_t type, uint32_t lsId, uint32_t advertisingRouter, uint16_t seqNum)
+{
+  LsaHeader header (std::make_tuple (type, lsId, advertisingRouter));
+  header.SetSeqNum (seqNum);
+  return header;
+}
+
+void
+Reoriginate ()
+{
+}
+
+void
+RecordPendingOriginationDelay (const OspfLsdb *lsdb, Time *out)
+{
+  *out = lsdb->GetPendingOriginationDelay ();
+}
+
+} // namespace
+
+class OspfLsdbViewTestCase : public TestCase
+{
+public:
+  OspfLsdbViewTestCase ()
+    : TestCase ("OspfLsdb keeps one map per LSA type and iterates in Link-State ID order")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLsdb lsdb;
+    OspfLsdbView<RouterLsa> routers (lsdb);
+    OspfLsdbView<AreaLsa> areas (lsdb);
+    NS_TEST_EXPECT_MSG_EQ (routers.empty (), true, "empty");
+    NS_TEST_EXPECT_MSG_EQ ((routers.begin () == routers.end ()), true, "nothing to iterate");
+
+    for (uint32_t lsId : {30u, 10u, 20u, 40u})
+      {
+        routers[lsId] = std::make_pair (MakeHeader (LsaHeader::RouterLSAs, lsId, lsId, 1),
+                                        Create<RouterLsa> ());
+      }
+    // Same Link-State ID, another type
+    Ptr<AreaLsa> area = Create<AreaLsa> ();
+    areas[20] = std::make_pair (MakeHeader (LsaHeader::AreaLSAs, 20, 10, 3), area);
+    NS_TEST_EXPECT_MSG_EQ (routers.size (), 4, "four Router-LSAs");
+    NS_TEST_EXPECT_MSG_EQ (areas.size (), 1, "one Area-LSA");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNLsas (), 5, "five LSAs in all");
+
+    std::vector<uint32_t> order;
+    for (auto &[lsId, lsa] : routers)
+      {
+        order.push_back (lsId);
+      }
+    NS_TEST_EXPECT_MSG_EQ ((order == std::vector<uint32_t>{10, 20, 30, 40}), true,
+                           "Link-State ID order");
+    NS_TEST_EXPECT_MSG_EQ (routers.begin ()->first, 10, "lowest router ID first");
+
+    auto it = areas.find (20);
+    NS_TEST_EXPECT_MSG_EQ ((it != areas.end ()), true, "found");
+    NS_TEST_EXPECT_MSG_EQ (it->second.second, area, "same body");
+    NS_TEST_EXPECT_MSG_EQ ((areas.find (10) == areas.end ()), true, "router 10 is not an area");
+    NS_TEST_EXPECT_MSG_EQ (areas.count (20), 1, "count");
+
+    // Fetch finds any type; the advertising router is not part of the key
+    auto fetched = lsdb.Fetch (std::make_tuple (LsaHeader::AreaLSAs, 20, 99));
+    NS_TEST_EXPECT_MSG_EQ (fetched.first.GetAdvertisingRouter (), 10, "installed instance");
+    NS_TEST_EXPECT_MSG_EQ (fetched.first.GetSeqNum (), 3, "its header");
+    NS_TEST_EXPECT_MSG_EQ ((lsdb.Fetch (std::make_tuple (LsaHeader::L2SummaryLSAs, 20, 10)).second ==
+                            nullptr),
+                           true, "no L2 Summary-LSA");
+
+    // Removing moves another entry but keeps the order
+    NS_TEST_EXPECT_MSG_EQ (routers.erase (10), 1, "erased");
+    NS_TEST_EXPECT_MSG_EQ (routers.erase (10), 0, "already erased");
+    order.clear ();
+    for (auto &[lsId, lsa] : routers)
+      {
+        order.push_back (lsId);
+      }
+    NS_TEST_EXPECT_MSG_EQ ((order == std::vector<uint32_t>{20, 30, 40}), true, "still in order");
+    NS_TEST_EXPECT_MSG_EQ (routers.find (40)->first, 40, "moved entry still found");
+
+    routers.clear ();
+    NS_TEST_EXPECT_MSG_EQ (routers.empty (), true, "routers cleared");
+    NS_TEST_EXPECT_MSG_EQ (areas.size (), 1, "areas kept");
+  }
+};
+
+class OspfLsdbSeqNumTestCase : public TestCase
+{
+public:
+  OspfLsdbSeqNumTestCase ()
+    : TestCase ("OspfLsdb keeps sequence numbers per advertising router across growth and removal")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLsdb lsdb;
+    OspfLsdbView<RouterLsa> routers (lsdb);
+    auto key = std::make_tuple (uint8_t (LsaHeader::AreaLSAs), 7u, 1u);
+    auto otherLeader = std::make_tuple (uint8_t (LsaHeader::AreaLSAs), 7u, 2u);
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (key), 0, "nothing heard");
+    lsdb.SetSeqNum (key, 5);
+    lsdb.SetSeqNum (otherLeader, 9);
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (key), 5, "first leader");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (otherLeader), 9, "second leader");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNKeys (), 1, "one key for both");
+
+    // Enough keys to grow the table several times
+    for (uint32_t lsId = 1; lsId <= 1000; lsId++)
+      {
+        routers[lsId] = std::make_pair (MakeHeader (LsaHeader::RouterLSAs, lsId, lsId, lsId),
+                                        Create<RouterLsa> ());
+        lsdb.SetSeqNum (std::make_tuple (uint8_t (LsaHeader::RouterLSAs), lsId, lsId), lsId);
+      }
+    for (uint32_t lsId = 1; lsId <= 1000; lsId += 2)
+      {
+        routers.erase (lsId);
+      }
+    bool found = true;
+    bool seqNums = true;
+    for (uint32_t lsId = 1; lsId <= 1000; lsId++)
+      {
+        found = found && routers.count (lsId) == (lsId % 2 == 0);
+        seqNums = seqNums &&
+                  lsdb.GetSeqNum (std::make_tuple (uint8_t (LsaHeader::RouterLSAs), lsId, lsId)) ==
+                      lsId;
+      }
+    NS_TEST_EXPECT_MSG_EQ (found, true, "even Router-LSAs left");
+    NS_TEST_EXPECT_MSG_EQ (seqNums, true, "sequence numbers outlive the LSAs");
+    NS_TEST_EXPECT_MSG_EQ (routers.size (), 500, "500 Router-LSAs");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (otherLeader), 9, "unrelated key kept");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNKeys (), 1001, "keys outlive the LSAs");
+
+    for (uint32_t lsId = 1; lsId <= 1000; lsId++)
+      {
+        lsdb.EraseSeqNum (std::make_tuple (uint8_t (LsaHeader::RouterLSAs), lsId, lsId));
+      }
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNKeys (), 501, "keys of removed LSAs erased");
+    NS_TEST_EXPECT_MSG_EQ (routers.size (), 500, "installed LSAs kept");
+    NS_TEST_EXPECT_MSG_EQ (routers.count (2), 1, "installed LSA found");
+    lsdb.EraseSeqNum (key);
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (key), 0, "sequence number forgotten");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (otherLeader), 9, "other advertising router kept");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNKeys (), 501, "key still in use");
+
+    OspfLsdb::Origination &origination = lsdb.GetOrigination (key);
+    origination.originated = true;
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetOrigination (key).originated, true, "origination state");
+
+    lsdb.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNLsas (), 0, "no LSAs");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetNKeys (), 0, "no keys");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetSeqNum (key), 0, "sequence numbers cleared");
+    NS_TEST_EXPECT_MSG_EQ (routers.empty (), true, "views cleared");
+  }
+};
+
+class OspfLsdbDigestTestCase : public TestCase
+{
+public:
+  OspfLsdbDigestTestCase ()
+    : TestCase ("OspfLsdb digests follow installs and removals in any order")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLsdb first;
+    OspfLsdb second;
+    OspfLsdbView<RouterLsa> firstRouters (first);
+    OspfLsdbView<RouterLsa> secondRouters (second);
+    OspfLsdbView<L1SummaryLsa> summaries (first);
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<RouterLsa> (), 0, "empty");
+
+    std::vector<Ptr<RouterLsa>> bodies;
+    for (uint32_t lsId = 1; lsId <= 3; lsId++)
+      {
+        Ptr<RouterLsa> body = Create<RouterLsa> ();
+        body->AddLink (RouterLink (lsId + 1, lsId, 1, lsId));
+        bodies.push_back (body);
+      }
+    for (uint32_t lsId : {1u, 2u, 3u})
+      {
+        firstRouters[lsId] =
+            std::make_pair (MakeHeader (LsaHeader::RouterLSAs, lsId, lsId, 1), bodies[lsId - 1]);
+      }
+    // Other order, other sequence numbers
+    for (uint32_t lsId : {3u, 1u, 2u})
+      {
+        secondRouters[lsId] =
+            std::make_pair (MakeHeader (LsaHeader::RouterLSAs, lsId, lsId, 5), bodies[lsId - 1]);
+      }
+    uint64_t digest = first.GetDigest<RouterLsa> ();
+    NS_TEST_EXPECT_MSG_NE (digest, 0, "three LSAs");
+    NS_TEST_EXPECT_MSG_EQ (second.GetDigest<RouterLsa> (), digest, "order-independent");
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<L1SummaryLsa> (), 0, "per type");
+
+    // Reading through operator [] changes nothing
+    NS_TEST_EXPECT_MSG_EQ (firstRouters[2].first.GetSeqNum (), 1, "read");
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<RouterLsa> (), digest, "unchanged by reads");
+
+    // A new body with other content, then the old one again
+    Ptr<RouterLsa> changed = Create<RouterLsa> ();
+    changed->AddLink (RouterLink (3, 2, 1, 10));
+    firstRouters[2] = std::make_pair (MakeHeader (LsaHeader::RouterLSAs, 2, 2, 2), changed);
+    NS_TEST_EXPECT_MSG_NE (first.GetDigest<RouterLsa> (), digest, "changed metric");
+    firstRouters[2] = std::make_pair (MakeHeader (LsaHeader::RouterLSAs, 2, 2, 3), bodies[1]);
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<RouterLsa> (), digest, "back to the same content");
+
+    // Removal, with and without a digest read in between
+    secondRouters.erase (3);
+    uint64_t twoLsas = second.GetDigest<RouterLsa> ();
+    firstRouters[3] = std::make_pair (MakeHeader (LsaHeader::RouterLSAs, 3, 3, 2), changed);
+    firstRouters.erase (3);
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<RouterLsa> (), twoLsas, "removed");
+    firstRouters.erase (1);
+    firstRouters.erase (2);
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<RouterLsa> (), 0, "empty again");
+
+    Ptr<L1SummaryLsa> routes = Create<L1SummaryLsa> ();
+    routes->AddRoute (SummaryRoute (0x0a000000, 0xffffff00, 1));
+    summaries[7] = std::make_pair (MakeHeader (LsaHeader::L1SummaryLSAs, 7, 7, 1), routes);
+    NS_TEST_EXPECT_MSG_NE (first.GetDigest<L1SummaryLsa> (), 0, "summary counted");
+    first.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (first.GetDigest<L1SummaryLsa> (), 0, "cleared");
+  }
+};
+
+class OspfLsdbPendingOriginationTestCase : public TestCase
+{
+public:
+  OspfLsdbPendingOriginationTestCase ()
+    : TestCase ("OspfLsdb tracks the first deferred re-origination through firing and cancels")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfLsdb lsdb;
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetPendingOriginationDelay (), Time::Max (), "nothing deferred");
+
+    auto first = std::make_tuple (LsaHeader::RouterLSAs, 1u, 1u);
+    auto second = std::make_tuple (LsaHeader::RouterLSAs, 2u, 2u);
+    auto third = std::make_tuple (LsaHeader::L1SummaryLSAs, 3u, 3u);
+    lsdb.DeferOrigination (first, Simulator::Schedule (MilliSeconds (30), &Reoriginate));
+    lsdb.DeferOrigination (second, Simulator::Schedule (MilliSeconds (10), &Reoriginate));
+    lsdb.DeferOrigination (third, Simulator::Schedule (MilliSeconds (20), &Reoriginate));
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetPendingOriginationDelay (), MilliSeconds (10), "earliest");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetOrigination (second).pending.IsRunning (), true,
+                           "stored with the key");
+
+    Simulator::Cancel (lsdb.GetOrigination (second).pending);
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetPendingOriginationDelay (), MilliSeconds (20), "cancelled");
+
+    Time afterThird;
+    Time afterAll;
+    Simulator::Schedule (MilliSeconds (25), &RecordPendingOriginationDelay, &lsdb, &afterThird);
+    Simulator::Schedule (MilliSeconds (35), &RecordPendingOriginationDelay, &lsdb, &afterAll);
+    Simulator::Run ();
+    NS_TEST_EXPECT_MSG_EQ (afterThird, MilliSeconds (5), "fired");
+    NS_TEST_EXPECT_MSG_EQ (afterAll, Time::Max (), "all fired");
+
+    lsdb.DeferOrigination (first, Simulator::Schedule (MilliSeconds (10), &Reoriginate));
+    EventId pending = lsdb.GetOrigination (first).pending;
+    lsdb.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (pending.IsRunning (), false, "cancelled by Clear");
+    NS_TEST_EXPECT_MSG_EQ (lsdb.GetPendingOriginationDelay (), Time::Max (), "cleared");
+    Simulator::Destroy ();
+  }
+};
+
+class OspfLsdbTestSuite : public TestSuite
+{
+public:
+  OspfLsdbTestSuite ()
+    : TestSuite ("ospf-lsdb", UNIT)
+  {
+    AddTestCase (new OspfLsdbViewTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsdbSeqNumTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsdbDigestTestCase, TestCase::QUICK);
+    AddTestCase (new OspfLsdbPendingOriginationTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfLsdbTestSuite g_ospfLsdbTestSuite;
+
+} // namespace ns3
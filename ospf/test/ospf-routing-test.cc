@@ -3,6 +3,7 @@
 #include "ns3/test.h"
 #include "ns3/ospf-app.h"
 #include "ns3/ospf-app-helper.h"
+#include "ns3/ospf-routing-helper.h"
 #include "ns3/node-container.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/point-to-point-helper.h"
@@ -12,11 +13,167 @@
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/string.h"
 #include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+
+#include "ospf-test-utils.h"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <vector>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("OspfRoutingTest");
 
+namespace {
+
+void
+CountRoutes (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, uint32_t *count)
+{
+  Ipv4StaticRoutingHelper helper;
+  Ptr<Ipv4StaticRouting> routing = helper.GetStaticRouting (node->GetObject<Ipv4> ());
+  *count = 0;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); ++i)
+    {
+      Ipv4RoutingTableEntry entry = routing->GetRoute (i);
+      if (entry.IsNetwork () && entry.GetDestNetwork () == network &&
+          entry.GetDestNetworkMask () == mask)
+        {
+          ++*count;
+        }
+    }
+}
+
+void
+FindRouteIndex (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, int32_t *index)
+{
+  Ipv4StaticRoutingHelper helper;
+  Ptr<Ipv4StaticRouting> routing = helper.GetStaticRouting (node->GetObject<Ipv4> ());
+  *index = -1;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); ++i)
+    {
+      Ipv4RoutingTableEntry entry = routing->GetRoute (i);
+      if (entry.IsNetwork () && entry.GetDestNetwork () == network &&
+          entry.GetDestNetworkMask () == mask)
+        {
+          *index = i;
+          return;
+        }
+    }
+}
+
+void
+RecordOutputGateway (Ptr<Node> node, Ipv4Address dest, Ipv4Address *gateway)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route =
+      node->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (nullptr, header, nullptr,
+                                                                     sockerr);
+  *gateway = route == nullptr ? Ipv4Address::GetAny () : route->GetGateway ();
+}
+
+void
+CountOspfPaths (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, uint32_t *count)
+{
+  Ptr<OspfRoutingProtocol> routing =
+      OspfRoutingHelper::GetOspfRouting (node->GetObject<Ipv4> ());
+  *count = routing == nullptr ? 0 : routing->GetPaths (network, mask).size ();
+}
+
+// Look up each destination in turn; record the gateway of the last one and
+// the cache hits and misses of the probe
+void
+ProbeFlowCache (Ptr<Node> node, std::vector<Ipv4Address> dests, Ipv4Address *gateway,
+                uint64_t *hits, uint64_t *misses)
+{
+  Ptr<OspfRoutingProtocol> routing =
+      OspfRoutingHelper::GetOspfRouting (node->GetObject<Ipv4> ());
+  routing->ResetFlowCacheStats ();
+  for (auto &dest : dests)
+    {
+      RecordOutputGateway (node, dest, gateway);
+    }
+  *hits = routing->GetFlowCacheHits ();
+  *misses = routing->GetFlowCacheMisses ();
+}
+
+void
+RecordLazyFibStats (Ptr<OspfApp> app, OspfApp::LazyFibStats *stats)
+{
+  *stats = app->GetLazyFibStats ();
+}
+
+void
+RecordFibCompressionStats (Ptr<OspfApp> app, OspfApp::FibCompressionStats *stats)
+{
+  *stats = app->GetFibCompressionStats ();
+}
+
+void
+RecordL2SummaryRoutes (Ptr<OspfApp> app, uint32_t areaId, std::set<SummaryRoute> *routes)
+{
+  auto lsdb = app->GetL2SummaryLsdb ();
+  auto it = lsdb.find (areaId);
+  *routes = it == lsdb.end () ? std::set<SummaryRoute> () : it->second.second->GetRoutes ();
+}
+
+void
+RecordDiscardRoute (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, bool *discard)
+{
+  Ptr<OspfRoutingProtocol> routing =
+      OspfRoutingHelper::GetOspfRouting (node->GetObject<Ipv4> ());
+  *discard = routing != nullptr && routing->IsDiscardRoute (network, mask);
+}
+
+// Note when a route first shows up in the static routing table
+void
+RecordFirstInstall (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, Time *first)
+{
+  uint32_t count;
+  CountRoutes (node, network, mask, &count);
+  if (count > 0 && first->IsZero ())
+    {
+      *first = Simulator::Now ();
+    }
+}
+
+void
+RecordMaxPendingPrefixes (Ptr<OspfApp> app, uint32_t *pending)
+{
+  *pending = std::max (*pending, app->GetFibWriteStats ().pending);
+}
+
+// Same size, different route: only a check of the entries notices
+void
+ReplaceRouteGateway (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, Ipv4Address gateway)
+{
+  Ipv4StaticRoutingHelper helper;
+  Ptr<Ipv4StaticRouting> routing = helper.GetStaticRouting (node->GetObject<Ipv4> ());
+  for (uint32_t i = 0; i < routing->GetNRoutes (); ++i)
+    {
+      Ipv4RoutingTableEntry entry = routing->GetRoute (i);
+      if (entry.IsNetwork () && entry.GetDestNetwork () == network &&
+          entry.GetDestNetworkMask () == mask)
+        {
+          uint32_t metric = routing->GetMetric (i);
+          routing->RemoveRoute (i);
+          routing->AddNetworkRouteTo (network, mask, gateway, entry.GetInterface (), metric);
+          return;
+        }
+    }
+}
+
+void
+SnapshotRoutingTableInSync (Ptr<OspfApp> app, bool *inSync)
+{
+  *inSync = app->IsRoutingTableInSync ();
+}
+
+} // namespace
+
 /**
  * \ingroup ospf-test
  * \brief Test UpdateRouting installs L1 routes
@@ -241,6 +398,661 @@ OspfRoutingCleanupTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup ospf-test
+ * \brief Test partial route updates when a remote summary LSA changes
+ */
+class OspfPartialRouteUpdateTest : public TestCase
+{
+public:
+  OspfPartialRouteUpdateTest ();
+  virtual ~OspfPartialRouteUpdateTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfPartialRouteUpdateTest::OspfPartialRouteUpdateTest ()
+    : TestCase ("Test that summary LSA changes update only the affected prefixes")
+{
+}
+
+OspfPartialRouteUpdateTest::~OspfPartialRouteUpdateTest ()
+{
+}
+
+void
+OspfPartialRouteUpdateTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer devices01 = p2p.Install (nodes.Get (0), nodes.Get (1));
+  NetDeviceContainer devices12 = p2p.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (devices01);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  address.Assign (devices12);
+
+  OspfAppHelper ospfHelper;
+  ospf_test_utils::ConfigureFastColdStart (ospfHelper);
+  ospfHelper.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.0")));
+  ApplicationContainer ospfApps = ospfHelper.Install (nodes);
+
+  // Node 2 starts with no prefixes; node 1 advertises its links
+  NodeContainer advertisers (nodes.Get (0), nodes.Get (1));
+  ospfHelper.ConfigureReachablePrefixesFromInterfaces (advertisers);
+  ospfApps.Start (Seconds (0.5));
+
+  // Node 2 announces one prefix, then replaces it with another
+  Ptr<OspfApp> app2 = DynamicCast<OspfApp> (ospfApps.Get (2));
+  NS_TEST_ASSERT_MSG_NE (app2, nullptr, "expected OspfApp");
+  void (OspfApp::*addReachable) (uint32_t, Ipv4Address, Ipv4Mask, Ipv4Address, uint32_t) =
+      &OspfApp::AddReachableAddress;
+  Simulator::Schedule (Seconds (2.0), addReachable, app2, 1, Ipv4Address ("10.252.0.0"),
+                       Ipv4Mask ("255.255.0.0"), Ipv4Address ("10.252.0.1"), 1);
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> replaced;
+  replaced.emplace_back (1, Ipv4Address ("10.253.0.0").Get (), Ipv4Mask ("255.255.0.0").Get (),
+                         Ipv4Address ("10.253.0.1").Get (), 1);
+  Simulator::Schedule (Seconds (4.0), &OspfApp::SetReachableAddresses, app2, replaced);
+
+  const Ipv4Mask mask16 ("255.255.0.0");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  uint32_t added = 0, link12Before = 0, withdrawn = 0, replacement = 0, link12After = 0;
+  Simulator::Schedule (Seconds (3.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.252.0.0"),
+                       mask16, &added);
+  Simulator::Schedule (Seconds (3.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask24, &link12Before);
+  Simulator::Schedule (Seconds (5.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.252.0.0"),
+                       mask16, &withdrawn);
+  Simulator::Schedule (Seconds (5.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.253.0.0"),
+                       mask16, &replacement);
+  Simulator::Schedule (Seconds (5.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask24, &link12After);
+
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (added, 1, "Node 0 should learn the announced prefix once");
+  NS_TEST_ASSERT_MSG_EQ (link12Before, 1, "Node 0 should learn node 1's link prefix once");
+  NS_TEST_ASSERT_MSG_EQ (withdrawn, 0, "Node 0 should drop the withdrawn prefix");
+  NS_TEST_ASSERT_MSG_EQ (replacement, 1, "Node 0 should learn the replacement prefix once");
+  NS_TEST_ASSERT_MSG_EQ (link12After, 1, "Unrelated prefixes should stay installed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test that routing updates only touch routes that changed
+ */
+class OspfDeltaRoutingUpdateTest : public TestCase
+{
+public:
+  OspfDeltaRoutingUpdateTest ();
+  virtual ~OspfDeltaRoutingUpdateTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfDeltaRoutingUpdateTest::OspfDeltaRoutingUpdateTest ()
+    : TestCase ("Test that unchanged routes stay installed across routing updates")
+{
+}
+
+OspfDeltaRoutingUpdateTest::~OspfDeltaRoutingUpdateTest ()
+{
+}
+
+void
+OspfDeltaRoutingUpdateTest::DoRun (void)
+{
+  ospf_test_utils::FourRouterLine line = ospf_test_utils::BuildFourRouterLine ();
+  NodeContainer &nodes = line.nodes;
+  ApplicationContainer &ospfApps = line.apps;
+
+  // A stub prefix behind node 3 that sorts before every link prefix
+  Ptr<OspfApp> app3 = DynamicCast<OspfApp> (ospfApps.Get (3));
+  NS_TEST_ASSERT_MSG_NE (app3, nullptr, "expected OspfApp");
+  app3->AddReachableAddress (1, Ipv4Address ("10.0.9.0"), Ipv4Mask ("255.255.255.0"),
+                             Ipv4Address ("10.0.9.1"), 1);
+
+  // Cut node 0 off from nodes 2 and 3, then reconnect
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (4.0), false);
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (5.0), true);
+
+  const Ipv4Mask mask24 ("255.255.255.0");
+  int32_t stubBefore = -1, link12Before = -1, stubDown = -1, link12Down = -1;
+  int32_t stubUp = -1, link12Up = -1;
+  Simulator::Schedule (Seconds (3.5), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.0.9.0"),
+                       mask24, &stubBefore);
+  Simulator::Schedule (Seconds (3.5), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask24, &link12Before);
+  Simulator::Schedule (Seconds (4.8), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.0.9.0"),
+                       mask24, &stubDown);
+  Simulator::Schedule (Seconds (4.8), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask24, &link12Down);
+  Simulator::Schedule (Seconds (7.5), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.0.9.0"),
+                       mask24, &stubUp);
+  Simulator::Schedule (Seconds (7.5), &FindRouteIndex, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask24, &link12Up);
+
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (ospfApps.Get (0));
+  bool inSyncBefore = false, inSyncDown = false, inSyncUp = false, inSyncReplaced = true;
+  Simulator::Schedule (Seconds (3.5), &SnapshotRoutingTableInSync, app0, &inSyncBefore);
+  Simulator::Schedule (Seconds (4.8), &SnapshotRoutingTableInSync, app0, &inSyncDown);
+  Simulator::Schedule (Seconds (7.5), &SnapshotRoutingTableInSync, app0, &inSyncUp);
+  Simulator::Schedule (Seconds (8.0), &ReplaceRouteGateway, nodes.Get (0),
+                       Ipv4Address ("10.1.2.0"), mask24, Ipv4Address ("10.1.1.1"));
+  Simulator::Schedule (Seconds (8.0), &SnapshotRoutingTableInSync, app0, &inSyncReplaced);
+
+  Simulator::Stop (Seconds (9.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_NE (stubBefore, -1, "Node 0 should learn the stub prefix");
+  NS_TEST_ASSERT_MSG_NE (link12Before, -1, "Node 0 should learn the (1,2) link prefix");
+  NS_TEST_ASSERT_MSG_EQ (stubDown, -1, "Node 0 should drop the stub prefix after link-down");
+  NS_TEST_ASSERT_MSG_NE (link12Down, -1, "Node 1 still advertises the (1,2) link prefix");
+  NS_TEST_ASSERT_MSG_NE (stubUp, -1, "Node 0 should re-learn the stub prefix after link-up");
+  // The surviving route was never reinstalled, so the re-learned one lands after it
+  NS_TEST_ASSERT_MSG_GT (stubUp, link12Up, "Unchanged routes should not be reinstalled");
+  NS_TEST_ASSERT_MSG_EQ (inSyncBefore, true, "Routes should match the shadow RIB");
+  NS_TEST_ASSERT_MSG_EQ (inSyncDown, true, "Routes should match the shadow RIB after link-down");
+  NS_TEST_ASSERT_MSG_EQ (inSyncUp, true, "Routes should match the shadow RIB after link-up");
+  NS_TEST_ASSERT_MSG_EQ (inSyncReplaced, false, "A replaced route should be noticed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test that OSPF programs an OspfRoutingProtocol installed by OspfRoutingHelper
+ */
+class OspfNativeRoutingTest : public TestCase
+{
+public:
+  OspfNativeRoutingTest ();
+  virtual ~OspfNativeRoutingTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfNativeRoutingTest::OspfNativeRoutingTest ()
+    : TestCase ("Test that OSPF routes go only to the OspfRoutingHelper table")
+{
+}
+
+OspfNativeRoutingTest::~OspfNativeRoutingTest ()
+{
+}
+
+void
+OspfNativeRoutingTest::DoRun (void)
+{
+  OspfRoutingHelper routingHelper;
+  ospf_test_utils::FourRouterLine line =
+      ospf_test_utils::BuildFourRouterLine ("", EmptyAttributeValue (), &routingHelper);
+  NodeContainer &nodes = line.nodes;
+  ApplicationContainer &ospfApps = line.apps;
+
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (ospfApps.Get (0));
+  NS_TEST_ASSERT_MSG_NE (app0, nullptr, "expected OspfApp");
+  NS_TEST_ASSERT_MSG_EQ (app0->GetMultipathRouting (),
+                         OspfRoutingHelper::GetOspfRouting (nodes.Get (0)->GetObject<Ipv4> ()),
+                         "OspfAppHelper should hand the installed table to the app");
+
+  // Cut node 0 off from nodes 2 and 3, then reconnect
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (4.0), false);
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (5.0), true);
+
+  const Ipv4Address link23 ("10.1.3.0");
+  const Ipv4Address node3 ("10.1.3.2");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  uint32_t staticRoutes = 1, ospfPaths = 0;
+  Ipv4Address gatewayBefore, gatewayDown, gatewayUp;
+  Simulator::Schedule (Seconds (3.5), &CountRoutes, nodes.Get (0), link23, mask24,
+                       &staticRoutes);
+  Simulator::Schedule (Seconds (3.5), &CountOspfPaths, nodes.Get (0), link23, mask24,
+                       &ospfPaths);
+  Simulator::Schedule (Seconds (3.5), &RecordOutputGateway, nodes.Get (0), node3,
+                       &gatewayBefore);
+  Simulator::Schedule (Seconds (4.8), &RecordOutputGateway, nodes.Get (0), node3, &gatewayDown);
+  Simulator::Schedule (Seconds (7.5), &RecordOutputGateway, nodes.Get (0), node3, &gatewayUp);
+
+  Simulator::Stop (Seconds (9.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (staticRoutes, 0, "OSPF routes should stay out of static routing");
+  NS_TEST_ASSERT_MSG_EQ (ospfPaths, 1, "Node 0 should learn the (2,3) link prefix");
+  NS_TEST_ASSERT_MSG_EQ (gatewayBefore, Ipv4Address ("10.1.1.2"), "Forward through node 1");
+  NS_TEST_ASSERT_MSG_EQ (gatewayDown, Ipv4Address::GetAny (),
+                         "Node 0 should drop the route after link-down");
+  NS_TEST_ASSERT_MSG_EQ (gatewayUp, Ipv4Address ("10.1.1.2"),
+                         "Node 0 should re-learn the route after link-up");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test the OspfRoutingProtocol lookup cache
+ */
+class OspfFlowCacheTest : public TestCase
+{
+public:
+  OspfFlowCacheTest ();
+  virtual ~OspfFlowCacheTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfFlowCacheTest::OspfFlowCacheTest ()
+    : TestCase ("Test that the lookup cache evicts and follows routing changes")
+{
+}
+
+OspfFlowCacheTest::~OspfFlowCacheTest ()
+{
+}
+
+void
+OspfFlowCacheTest::DoRun (void)
+{
+  OspfRoutingHelper routingHelper;
+  routingHelper.Set ("FlowCacheSize", UintegerValue (1));
+  ospf_test_utils::FourRouterLine line =
+      ospf_test_utils::BuildFourRouterLine ("", EmptyAttributeValue (), &routingHelper);
+  NodeContainer &nodes = line.nodes;
+
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (4.0), false);
+
+  // Repeats hit; with one entry, every other destination evicts
+  const Ipv4Address node2 ("10.1.2.2");
+  const Ipv4Address node3 ("10.1.3.2");
+  Ipv4Address gatewayBefore, gatewayEvicted, gatewayDown;
+  uint64_t hitsBefore = 0, missesBefore = 0, hitsEvicted = 0, missesEvicted = 0;
+  uint64_t hitsDown = 0, missesDown = 0;
+  Simulator::Schedule (Seconds (3.5), &ProbeFlowCache, nodes.Get (0),
+                       std::vector<Ipv4Address>{node3, node3, node3}, &gatewayBefore,
+                       &hitsBefore, &missesBefore);
+  Simulator::Schedule (Seconds (3.6), &ProbeFlowCache, nodes.Get (0),
+                       std::vector<Ipv4Address>{node2, node3}, &gatewayEvicted, &hitsEvicted,
+                       &missesEvicted);
+  // The cached route must not outlive the link
+  Simulator::Schedule (Seconds (4.8), &ProbeFlowCache, nodes.Get (0),
+                       std::vector<Ipv4Address>{node3}, &gatewayDown, &hitsDown, &missesDown);
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (gatewayBefore, Ipv4Address ("10.1.1.2"), "Forward through node 1");
+  NS_TEST_ASSERT_MSG_EQ (missesBefore, 1, "Only the first lookup should miss");
+  NS_TEST_ASSERT_MSG_EQ (hitsBefore, 2, "Repeated lookups should hit");
+  NS_TEST_ASSERT_MSG_EQ (gatewayEvicted, Ipv4Address ("10.1.1.2"),
+                         "Evicted entry is looked up again");
+  NS_TEST_ASSERT_MSG_EQ (missesEvicted, 2, "A full cache should evict");
+  NS_TEST_ASSERT_MSG_EQ (hitsEvicted, 0, "Nothing should hit after eviction");
+  NS_TEST_ASSERT_MSG_EQ (gatewayDown, Ipv4Address::GetAny (),
+                         "A routing change should invalidate the cache");
+  NS_TEST_ASSERT_MSG_EQ (missesDown, 1, "A stale entry counts as a miss");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test that LazyFib resolves routes on lookup and drops them on change
+ */
+class OspfLazyFibTest : public TestCase
+{
+public:
+  OspfLazyFibTest ();
+  virtual ~OspfLazyFibTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfLazyFibTest::OspfLazyFibTest ()
+    : TestCase ("Test that LazyFib installs routes on first lookup only")
+{
+}
+
+OspfLazyFibTest::~OspfLazyFibTest ()
+{
+}
+
+void
+OspfLazyFibTest::DoRun (void)
+{
+  ospf_test_utils::FourRouterLine line =
+      ospf_test_utils::BuildFourRouterLine ("LazyFib", BooleanValue (true));
+  NodeContainer &nodes = line.nodes;
+
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (line.apps.Get (0));
+  NS_TEST_ASSERT_MSG_NE (app0, nullptr, "expected OspfApp");
+
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (4.0), false);
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (5.0), true);
+
+  const Ipv4Address node3 ("10.1.3.2");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  uint32_t staticRoutes = 1;
+  Ipv4Address gatewayBefore, gatewayDown, gatewayUp;
+  OspfApp::LazyFibStats idle, resolved, down;
+  Simulator::Schedule (Seconds (3.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.1.3.0"),
+                       mask24, &staticRoutes);
+  Simulator::Schedule (Seconds (3.5), &RecordLazyFibStats, app0, &idle);
+  Simulator::Schedule (Seconds (3.5), &RecordOutputGateway, nodes.Get (0), node3,
+                       &gatewayBefore);
+  Simulator::Schedule (Seconds (3.5), &RecordOutputGateway, nodes.Get (0), node3,
+                       &gatewayBefore);
+  Simulator::Schedule (Seconds (3.5), &RecordLazyFibStats, app0, &resolved);
+  Simulator::Schedule (Seconds (4.8), &RecordLazyFibStats, app0, &down);
+  Simulator::Schedule (Seconds (4.8), &RecordOutputGateway, nodes.Get (0), node3, &gatewayDown);
+  Simulator::Schedule (Seconds (7.5), &RecordOutputGateway, nodes.Get (0), node3, &gatewayUp);
+
+  Simulator::Stop (Seconds (9.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (staticRoutes, 0, "OSPF routes should stay out of static routing");
+  NS_TEST_ASSERT_MSG_EQ (idle.materialized, 0, "Nothing should be installed before a lookup");
+  NS_TEST_ASSERT_MSG_EQ (gatewayBefore, Ipv4Address ("10.1.1.2"), "Forward through node 1");
+  NS_TEST_ASSERT_MSG_EQ (resolved.materialized, 1, "The destination should be installed");
+  NS_TEST_ASSERT_MSG_EQ (resolved.resolutions - idle.resolutions, 1,
+                         "The repeated lookup should use the installed route");
+  NS_TEST_ASSERT_MSG_EQ (down.materialized, 0, "The link-down update should drop the route");
+  NS_TEST_ASSERT_MSG_GT (down.invalidations, idle.invalidations, "Drop counted");
+  NS_TEST_ASSERT_MSG_EQ (gatewayDown, Ipv4Address::GetAny (),
+                         "Node 0 should have no route after link-down");
+  NS_TEST_ASSERT_MSG_EQ (gatewayUp, Ipv4Address ("10.1.1.2"),
+                         "Node 0 should resolve the route again after link-up");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test that FibCompression installs aggregates that forward the same way
+ */
+class OspfFibCompressionTest : public TestCase
+{
+public:
+  OspfFibCompressionTest ();
+  virtual ~OspfFibCompressionTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfFibCompressionTest::OspfFibCompressionTest ()
+    : TestCase ("Test that FibCompression aggregates prefixes with the same next hops")
+{
+}
+
+OspfFibCompressionTest::~OspfFibCompressionTest ()
+{
+}
+
+void
+OspfFibCompressionTest::DoRun (void)
+{
+  ospf_test_utils::FourRouterLine line =
+      ospf_test_utils::BuildFourRouterLine ("FibCompression", BooleanValue (true));
+  NodeContainer &nodes = line.nodes;
+
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (line.apps.Get (0));
+  NS_TEST_ASSERT_MSG_NE (app0, nullptr, "expected OspfApp");
+
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (4.0), false);
+  ospf_test_utils::ScheduleLinkState (line.devices12, Seconds (5.0), true);
+
+  // 10.1.2.0/24 and 10.1.3.0/24 are both behind node 1
+  const Ipv4Address node3 ("10.1.3.2");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  const Ipv4Mask mask23 ("255.255.254.0");
+  uint32_t staticRoutes = 1;
+  uint32_t prefixPaths = 1;
+  uint32_t aggregatePaths = 0;
+  Ipv4Address gatewayBefore, gatewayDown, gatewayUp;
+  OspfApp::FibCompressionStats stats;
+  Simulator::Schedule (Seconds (3.5), &CountRoutes, nodes.Get (0), Ipv4Address ("10.1.3.0"),
+                       mask24, &staticRoutes);
+  Simulator::Schedule (Seconds (3.5), &CountOspfPaths, nodes.Get (0), Ipv4Address ("10.1.3.0"),
+                       mask24, &prefixPaths);
+  Simulator::Schedule (Seconds (3.5), &CountOspfPaths, nodes.Get (0), Ipv4Address ("10.1.2.0"),
+                       mask23, &aggregatePaths);
+  Simulator::Schedule (Seconds (3.5), &RecordFibCompressionStats, app0, &stats);
+  Simulator::Schedule (Seconds (3.5), &RecordOutputGateway, nodes.Get (0), node3,
+                       &gatewayBefore);
+  Simulator::Schedule (Seconds (4.8), &RecordOutputGateway, nodes.Get (0), node3, &gatewayDown);
+  Simulator::Schedule (Seconds (7.5), &RecordOutputGateway, nodes.Get (0), node3, &gatewayUp);
+
+  Simulator::Stop (Seconds (9.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (staticRoutes, 0, "OSPF routes should stay out of static routing");
+  NS_TEST_ASSERT_MSG_EQ (prefixPaths, 0, "10.1.3.0/24 should be aggregated away");
+  NS_TEST_ASSERT_MSG_EQ (aggregatePaths, 1, "10.1.2.0/23 should cover both prefixes");
+  NS_TEST_ASSERT_MSG_LT (stats.entries, stats.prefixes, "Fewer entries than prefixes");
+  NS_TEST_ASSERT_MSG_LT (stats.ratio, 1.0, "Compression ratio below 1");
+  NS_TEST_ASSERT_MSG_EQ (gatewayBefore, Ipv4Address ("10.1.1.2"), "Forward through node 1");
+  NS_TEST_ASSERT_MSG_EQ (gatewayDown, Ipv4Address::GetAny (),
+                         "Node 0 should have no route after link-down");
+  NS_TEST_ASSERT_MSG_EQ (gatewayUp, Ipv4Address ("10.1.1.2"),
+                         "Node 0 should route through node 1 again after link-up");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test prioritized, batched prefix installation
+ */
+class OspfPrefixPriorityTest : public TestCase
+{
+public:
+  OspfPrefixPriorityTest ();
+  virtual ~OspfPrefixPriorityTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfPrefixPriorityTest::OspfPrefixPriorityTest ()
+    : TestCase ("Test that FibWriteBatchSize installs high-priority prefixes first")
+{
+}
+
+OspfPrefixPriorityTest::~OspfPrefixPriorityTest ()
+{
+}
+
+void
+OspfPrefixPriorityTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer devices01 = p2p.Install (nodes.Get (0), nodes.Get (1));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (devices01);
+
+  OspfAppHelper ospfHelper;
+  ospf_test_utils::ConfigureFastColdStart (ospfHelper);
+  ospfHelper.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.0")));
+  ospfHelper.SetAttribute ("HighPriorityPrefixLength", UintegerValue (28));
+  ospfHelper.SetAttribute ("FibWriteBatchSize", UintegerValue (5));
+  ospfHelper.SetAttribute ("FibWriteInterval", TimeValue (MilliSeconds (100)));
+  ApplicationContainer ospfApps = ospfHelper.Install (nodes);
+  ospfHelper.ConfigureReachablePrefixesFromInterfaces (nodes);
+
+  // Node 1 advertises 40 /24s and a /28 service prefix
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (ospfApps.Get (0));
+  Ptr<OspfApp> app1 = DynamicCast<OspfApp> (ospfApps.Get (1));
+  NS_TEST_ASSERT_MSG_NE (app0, nullptr, "expected OspfApp");
+  NS_TEST_ASSERT_MSG_NE (app1, nullptr, "expected OspfApp");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  const Ipv4Mask mask28 ("255.255.255.240");
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> routes;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      routes.emplace_back (1, Ipv4Address ("10.200.0.0").Get () + (i << 8), mask24.Get (), 0, 0);
+    }
+  routes.emplace_back (1, Ipv4Address ("10.250.0.0").Get (), mask28.Get (), 0, 0);
+  app1->SetReachableAddresses (routes);
+  // The last /24 by a prefix list
+  app0->SetPrefixPriority (Ipv4Address ("10.200.39.0"), mask24, 0);
+  ospfApps.Start (Seconds (0.5));
+
+  Time service;
+  Time listed;
+  Time first24;
+  Time last24;
+  uint32_t pending = 0;
+  for (Time t = Seconds (0.5); t < Seconds (4.0); t += MilliSeconds (10))
+    {
+      Simulator::Schedule (t, &RecordFirstInstall, nodes.Get (0), Ipv4Address ("10.250.0.0"),
+                           mask28, &service);
+      Simulator::Schedule (t, &RecordFirstInstall, nodes.Get (0), Ipv4Address ("10.200.39.0"),
+                           mask24, &listed);
+      Simulator::Schedule (t, &RecordFirstInstall, nodes.Get (0), Ipv4Address ("10.200.0.0"),
+                           mask24, &first24);
+      Simulator::Schedule (t, &RecordFirstInstall, nodes.Get (0), Ipv4Address ("10.200.38.0"),
+                           mask24, &last24);
+      Simulator::Schedule (t, &RecordMaxPendingPrefixes, app0, &pending);
+    }
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  OspfApp::FibWriteStats stats = app0->GetFibWriteStats ();
+  uint32_t routes24 = 0;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      uint32_t count;
+      CountRoutes (nodes.Get (0), Ipv4Address (Ipv4Address ("10.200.0.0").Get () + (i << 8)),
+                   mask24, &count);
+      routes24 += count;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (service.IsZero (), false, "the /28 should be installed");
+  NS_TEST_ASSERT_MSG_EQ (last24.IsZero (), false, "the /24s should be installed");
+  NS_TEST_ASSERT_MSG_EQ (listed, service, "both high-priority prefixes in the first batch");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (service, first24, "the /28 goes ahead of the /24s");
+  NS_TEST_ASSERT_MSG_GT (last24 - service, MilliSeconds (500),
+                         "forty prefixes take eight batches 100 ms apart");
+  NS_TEST_ASSERT_MSG_GT (pending, 0, "prefixes waited for later batches");
+  NS_TEST_ASSERT_MSG_EQ (stats.pending, 0, "every prefix is written in the end");
+  NS_TEST_ASSERT_MSG_GT (stats.deferredBatches, 0, "later batches ran");
+  NS_TEST_ASSERT_MSG_EQ (routes24, 40, "every /24 is installed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup ospf-test
+ * \brief Test area ranges in the L2 Summary-LSA
+ */
+class OspfAreaRangeTest : public TestCase
+{
+public:
+  OspfAreaRangeTest ();
+  virtual ~OspfAreaRangeTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+OspfAreaRangeTest::OspfAreaRangeTest ()
+    : TestCase ("Test that an area range replaces its prefixes in the L2 Summary-LSA")
+{
+}
+
+OspfAreaRangeTest::~OspfAreaRangeTest ()
+{
+}
+
+void
+OspfAreaRangeTest::DoRun (void)
+{
+  ospf_test_utils::FourRouterLine line = ospf_test_utils::BuildFourRouterLine (
+      "EnableAreaProxy", BooleanValue (true), nullptr,
+      [] (OspfAppHelper &ospf) {
+        ospf.SetAttribute ("EnableNextHopGroups", BooleanValue (true));
+      },
+      Ipv4Mask ("255.255.255.252"));
+  NodeContainer &nodes = line.nodes;
+  ApplicationContainer &ospfApps = line.apps;
+
+  // (0, 1) in area 0, (2, 3) in area 1
+  Ptr<OspfApp> app0 = DynamicCast<OspfApp> (ospfApps.Get (0));
+  NS_TEST_ASSERT_MSG_NE (app0, nullptr, "expected OspfApp");
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      DynamicCast<OspfApp> (ospfApps.Get (i))->SetArea (i / 2);
+    }
+
+  // Two stub networks behind node 3, summarized by every router of area 1
+  const Ipv4Address range ("10.252.0.0");
+  const Ipv4Mask mask16 ("255.255.0.0");
+  const Ipv4Mask mask24 ("255.255.255.0");
+  Ptr<OspfApp> app3 = DynamicCast<OspfApp> (ospfApps.Get (3));
+  app3->AddReachableAddress (1, Ipv4Address ("10.252.0.0"), mask24, Ipv4Address ("10.252.0.1"),
+                             1);
+  app3->AddReachableAddress (1, Ipv4Address ("10.252.1.0"), mask24, Ipv4Address ("10.252.1.1"),
+                             4);
+  DynamicCast<OspfApp> (ospfApps.Get (2))->AddAreaRange (range, mask16);
+  app3->AddAreaRange (range, mask16);
+
+  std::set<SummaryRoute> summary;
+  Ipv4Address gateway;
+  bool discard0 = true;
+  bool discard3 = false;
+  Simulator::Schedule (Seconds (3.5), &RecordL2SummaryRoutes, app0, 1, &summary);
+  Simulator::Schedule (Seconds (3.5), &RecordOutputGateway, nodes.Get (0),
+                       Ipv4Address ("10.252.1.1"), &gateway);
+  Simulator::Schedule (Seconds (3.5), &RecordDiscardRoute, nodes.Get (0), range, mask16,
+                       &discard0);
+  Simulator::Schedule (Seconds (3.5), &RecordDiscardRoute, nodes.Get (3), range, mask16,
+                       &discard3);
+
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (summary.count (SummaryRoute (range.Get (), mask16.Get (), 4)), 1,
+                         "Area 1 should advertise 10.252.0.0/16 with the highest metric");
+  for (auto &route : summary)
+    {
+      NS_TEST_ASSERT_MSG_NE (route.m_mask, mask24.Get (), "The /24s should be summarized away");
+    }
+  NS_TEST_ASSERT_MSG_EQ (gateway, Ipv4Address ("10.1.1.2"), "Forward to area 1 through node 1");
+  NS_TEST_ASSERT_MSG_EQ (discard0, false, "Area 0 should route the range");
+  NS_TEST_ASSERT_MSG_EQ (discard3, true, "Area 1 should discard the gaps in the range");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup ospf-test
  * \brief Test Suite for Routing
@@ -257,6 +1069,14 @@ OspfRoutingTestSuite::OspfRoutingTestSuite () : TestSuite ("ospf-routing", UNIT)
   AddTestCase (new OspfScheduleL1SpfTest, TestCase::QUICK);
   AddTestCase (new OspfScheduleL2SpfTest, TestCase::QUICK);
   AddTestCase (new OspfRoutingCleanupTest, TestCase::QUICK);
+  AddTestCase (new OspfPartialRouteUpdateTest, TestCase::QUICK);
+  AddTestCase (new OspfDeltaRoutingUpdateTest, TestCase::QUICK);
+  AddTestCase (new OspfNativeRoutingTest, TestCase::QUICK);
+  AddTestCase (new OspfFlowCacheTest, TestCase::QUICK);
+  AddTestCase (new OspfLazyFibTest, TestCase::QUICK);
+  AddTestCase (new OspfFibCompressionTest, TestCase::QUICK);
+  AddTestCase (new OspfAreaRangeTest, TestCase::QUICK);
+  AddTestCase (new OspfPrefixPriorityTest, TestCase::QUICK);
 }
 
 static OspfRoutingTestSuite g_ospfRoutingTestSuite;
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+
+#include "../model/ospf-spf-cache.h"
+#include "../model/ospf-spf-graph.h"
+
+#include <memory>
+
+#include <vector>
+
+namespace ns3 {
+
+class OspfSpfGraphEdgeUpdateTestCase : public TestCase
+{
+public:
+  OspfSpfGraphEdgeUpdateTestCase ()
+    : TestCase ("OspfSpfGraph replaces, grows and clears out-edges in place")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    OspfSpfGraph graph;
+    graph.SetEdges (10, {{20, 1}, {30, 2}});
+    graph.SetEdges (20, {{10, 1}});
+
+    const uint32_t v10 = graph.FindVertex (10);
+    const uint32_t v20 = graph.FindVertex (20);
+    const uint32_t v30 = graph.FindVertex (30);
+    NS_TEST_EXPECT_MSG_EQ (graph.GetNVertices (), 3, "edge heads are added as vertices");
+    NS_TEST_EXPECT_MSG_NE (v30, OspfSpfGraph::NO_VERTEX, "vertex without edges is indexed");
+    NS_TEST_EXPECT_MSG_EQ (graph.FindVertex (40), OspfSpfGraph::NO_VERTEX, "unknown ID");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetId (v20), 20, "index maps back to the ID");
+
+    // Growing a slot that is not the last one moves it
+    graph.SetEdges (10, {{20, 5}, {30, 6}, {40, 7}});
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesEnd (v10) - graph.EdgesBegin (v10), 3, "grown degree");
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesBegin (v10)[2].head, graph.FindVertex (40), "new head");
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesBegin (v10)[0].metric, 5, "replaced metric");
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesBegin (v20)->head, v10, "other slots are untouched");
+
+    // Repeated churn triggers compaction without losing edges
+    for (uint32_t i = 0; i < 50; i++)
+      {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for (uint32_t j = 0; j <= i % 7; j++)
+          {
+            edges.emplace_back (100 + j, i + j);
+          }
+        graph.SetEdges (20 + i % 3 * 10, edges);
+      }
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesEnd (v10) - graph.EdgesBegin (v10), 3,
+                           "untouched vertex keeps its edges");
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesBegin (v10)[1].metric, 6, "untouched edge metric");
+
+    graph.ClearEdges (10);
+    NS_TEST_EXPECT_MSG_EQ (graph.EdgesEnd (v10) - graph.EdgesBegin (v10), 0, "cleared edges");
+    NS_TEST_EXPECT_MSG_EQ (graph.FindVertex (10), v10, "cleared vertex keeps its index");
+  }
+};
+
+class OspfSpfGraphShortestPathTestCase : public TestCase
+{
+public:
+  OspfSpfGraphShortestPathTestCase ()
+    : TestCase ("OspfSpfGraph Dijkstra settles ties by ID and reuses its scratch arrays")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    // 1 -> 3 -> 4 and 1 -> 2 -> 4 at equal cost, 5 unreachable
+    OspfSpfGraph graph;
+    graph.SetEdges (1, {{3, 1}, {2, 1}});
+    graph.SetEdges (3, {{4, 2}});
+    graph.SetEdges (2, {{4, 2}});
+    graph.SetEdges (5, {{1, 1}});
+
+    const uint32_t root = graph.FindVertex (1);
+    graph.ComputeShortestPaths (root);
+    const uint32_t v4 = graph.FindVertex (4);
+    const uint32_t v5 = graph.FindVertex (5);
+    NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (v4), 3, "distance to 4");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetId (graph.GetParent (v4)), 2,
+                           "equal-cost parent with the lowest ID wins");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetParent (root), OspfSpfGraph::NO_VERTEX, "root has no parent");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetId (graph.GetFirstHop (v4)), 2, "first hop follows the parent");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetFirstHop (graph.FindVertex (2)), graph.FindVertex (2),
+                           "neighbor of the root is its own first hop");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetFirstHop (root), OspfSpfGraph::NO_VERTEX, "root has no first hop");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (v5), OspfSpfGraph::INFINITE_DISTANCE,
+                           "unreachable vertex");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetReached ().size (), 4, "reached vertices");
+
+    // A second run from another root starts from clean scratch arrays
+    graph.ClearEdges (2);
+    graph.ComputeShortestPaths (graph.FindVertex (3));
+    NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (v4), 2, "distance from the new root");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetFirstHop (v4), v4, "first hop from the new root");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (root), OspfSpfGraph::INFINITE_DISTANCE,
+                           "old root is reset");
+    NS_TEST_EXPECT_MSG_EQ (graph.GetReached ().size (), 2, "reached vertices");
+  }
+};
+
+class OspfSpfGraphBucketQueueTestCase : public TestCase
+{
+public:
+  OspfSpfGraphBucketQueueTestCase ()
+    : TestCase ("OspfSpfGraph bucket queue matches the binary heap and falls back on zero metrics")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    // 6x6 grid with metrics in [1, 4] and a few equal-cost ties
+    OspfSpfGraph graph;
+    const uint32_t width = 6;
+    for (uint32_t v = 0; v < width * width; v++)
+      {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        uint32_t row = v / width;
+        uint32_t col = v % width;
+        if (col > 0)
+          {
+            edges.emplace_back (v - 1, 1 + (v * 7 + v - 1) % 4);
+          }
+        if (col + 1 < width)
+          {
+            edges.emplace_back (v + 1, 1 + (v * 7 + v + 1) % 4);
+          }
+        if (row > 0)
+          {
+            edges.emplace_back (v - width, 1 + (v * 3 + v - width) % 4);
+          }
+        if (row + 1 < width)
+          {
+            edges.emplace_back (v + width, 1 + (v * 3 + v + width) % 4);
+          }
+        graph.SetEdges (v, edges);
+      }
+    NS_TEST_EXPECT_MSG_EQ (graph.CanUseBucketQueue (), true, "small nonzero metrics");
+
+    for (uint32_t root = 0; root < graph.GetNVertices (); root += 5)
+      {
+        graph.SetQueue (OspfSpfGraph::BINARY_HEAP);
+        graph.ComputeShortestPaths (root);
+        std::vector<uint32_t> distance;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> firstHop;
+        for (uint32_t v = 0; v < graph.GetNVertices (); v++)
+          {
+            distance.push_back (graph.GetDistance (v));
+            parent.push_back (graph.GetParent (v));
+            firstHop.push_back (graph.GetFirstHop (v));
+          }
+        graph.SetQueue (OspfSpfGraph::BUCKET_QUEUE);
+        graph.ComputeShortestPaths (root);
+        for (uint32_t v = 0; v < graph.GetNVertices (); v++)
+          {
+            NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (v), distance[v], "same distance");
+            NS_TEST_EXPECT_MSG_EQ (graph.GetParent (v), parent[v], "same equal-cost parent");
+            NS_TEST_EXPECT_MSG_EQ (graph.GetFirstHop (v), firstHop[v], "same first hop");
+          }
+      }
+
+    // A zero-cost link or a metric above the bucket range disables it
+    graph.SetEdges (0, {{1, 0}, {width, 1}});
+    NS_TEST_EXPECT_MSG_EQ (graph.CanUseBucketQueue (), false, "zero metric");
+    graph.SetEdges (0, {{1, OspfSpfGraph::MAX_BUCKET_METRIC + 1}, {width, 1}});
+    NS_TEST_EXPECT_MSG_EQ (graph.CanUseBucketQueue (), false, "large metric");
+    graph.ComputeShortestPaths (graph.FindVertex (0));
+    // 0 -> 6 -> 7 -> 1 at 1 + 2 + 3 beats the direct link
+    NS_TEST_EXPECT_MSG_EQ (graph.GetDistance (graph.FindVertex (1)), 6, "heap fallback still runs");
+    graph.ClearEdges (0);
+    NS_TEST_EXPECT_MSG_EQ (graph.CanUseBucketQueue (), true, "offending edges removed");
+  }
+};
+
+class OspfSpfCacheTestCase : public TestCase
+{
+public:
+  OspfSpfCacheTestCase ()
+    : TestCase ("Shared SPF graphs live while held and are rebuilt afterwards")
+  {
+  }
+
+private:
+  void
+  DoRun () override
+  {
+    uint32_t builds = 0;
+    auto builder = [&builds] (OspfSpfGraph &graph) {
+      builds++;
+      graph.SetEdges (1, {{2, 1}});
+      graph.SetEdges (2, {{1, 1}});
+    };
+    const uint64_t digest =
+        OspfSpfCache::DigestEdges (1, {{2, 1}}) + OspfSpfCache::DigestEdges (2, {{1, 1}});
+    NS_TEST_EXPECT_MSG_NE (OspfSpfCache::DigestEdges (1, {{2, 1}}),
+                           OspfSpfCache::DigestEdges (1, {{2, 2}}), "metric is digested");
+    NS_TEST_EXPECT_MSG_NE (OspfSpfCache::DigestEdges (1, {{2, 1}}),
+                           OspfSpfCache::DigestEdges (2, {{1, 1}}), "router is digested");
+
+    bool hit = true;
+    std::shared_ptr<OspfSpfGraph> a = OspfSpfCache::Lookup (digest, builder, hit);
+    NS_TEST_EXPECT_MSG_EQ (hit, false, "first lookup builds");
+    std::shared_ptr<OspfSpfGraph> b = OspfSpfCache::Lookup (digest, builder, hit);
+    NS_TEST_EXPECT_MSG_EQ (hit, true, "second lookup shares");
+    NS_TEST_EXPECT_MSG_EQ (a.get (), b.get (), "same graph");
+    NS_TEST_EXPECT_MSG_EQ (builds, 1, "built once");
+
+    a.reset ();
+    b.reset ();
+    b = OspfSpfCache::Lookup (digest, builder, hit);
+    NS_TEST_EXPECT_MSG_EQ (hit, false, "released graph is rebuilt");
+    NS_TEST_EXPECT_MSG_EQ (builds, 2, "built again");
+    NS_TEST_EXPECT_MSG_EQ (b->GetNVertices (), 2, "builder ran on the new graph");
+  }
+};
+
+class OspfSpfGraphTestSuite : public TestSuite
+{
+public:
+  OspfSpfGraphTestSuite ()
+    : TestSuite ("ospf-spf-graph", UNIT)
+  {
+    AddTestCase (new OspfSpfGraphEdgeUpdateTestCase, TestCase::QUICK);
+    AddTestCase (new OspfSpfGraphShortestPathTestCase, TestCase::QUICK);
+    AddTestCase (new OspfSpfGraphBucketQueueTestCase, TestCase::QUICK);
+    AddTestCase (new OspfSpfCacheTestCase, TestCase::QUICK);
+  }
+};
+
+static OspfSpfGraphTestSuite g_ospfSpfGraphTestSuite;
+
+} // namespace ns3
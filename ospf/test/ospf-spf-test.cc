@@ -3,6 +3,7 @@
 #include "ns3/test.h"
 
 #include "ns3/core-module.h"
+#include "ns3/error-model.h"
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/rng-seed-manager.h"
@@ -11,16 +12,119 @@
 #include "ns3/ospf-app-helper.h"
 
 #include "ospf-test-utils.h"
+#include "../model/ospf-spf-backoff.h"
 
+#include <map>
 #include <optional>
+#include <set>
 #include <sstream>
+#include <tuple>
 #include <vector>
 namespace ns3 {
 
 namespace {
 
 using ospf_test_utils::FindStaticRoute;
+using ospf_test_utils::BuildTwoPathTopology;
 using ospf_test_utils::ConfigureFastColdStart;
+using ospf_test_utils::ScheduleLinkState;
+using ospf_test_utils::TwoPathTopology;
+
+void
+RecordGateway (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask,
+               std::optional<Ipv4Address> *out)
+{
+  const auto r = FindStaticRoute (node, network, mask);
+  *out = r ? std::optional<Ipv4Address> (r->gateway) : std::nullopt;
+}
+
+void
+RecordGroupGateway (Ptr<OspfApp> app, Ipv4Address network, Ipv4Mask mask,
+                    std::optional<Ipv4Address> *out)
+{
+  Ptr<OspfRoutingProtocol> table = app->GetMultipathRouting ();
+  std::vector<OspfRoutingProtocol::Path> paths;
+  if (table != nullptr)
+    {
+      paths = table->GetPaths (network, mask);
+    }
+  *out = paths.empty () ? std::nullopt : std::optional<Ipv4Address> (paths.front ().first);
+}
+
+// Advertise count /24 prefixes from 10.200.0.0 instead of the interfaces
+void
+InjectPrefixes (Ptr<OspfApp> app, uint32_t count)
+{
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> routes;
+  for (uint32_t i = 0; i < count; i++)
+    {
+      routes.emplace_back (1, Ipv4Address ("10.200.0.0").Get () + (i << 8),
+                           Ipv4Mask ("255.255.255.0").Get (), 0, 0);
+    }
+  app->SetReachableAddresses (routes);
+}
+
+void
+RecordStubRouterState (Ptr<OspfApp> app, bool *stub, bool *draining, bool *enabled)
+{
+  *stub = app->IsStubRouter ();
+  *draining = app->IsDraining ();
+  *enabled = app->IsEnabled ();
+}
+
+// Record the route and app state every millisecond while app runs, and
+// the time it stopped
+void
+RecordUntilDisabled (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask, Ptr<OspfApp> app,
+                     std::optional<Ipv4Address> *gateway, bool *state, Time *disabledAt)
+{
+  if (!app->IsEnabled ())
+    {
+      *disabledAt = Simulator::Now ();
+      return;
+    }
+  RecordGateway (node, network, mask, gateway);
+  RecordStubRouterState (app, &state[0], &state[1], &state[2]);
+  Simulator::Schedule (MilliSeconds (1), &RecordUntilDisabled, node, network, mask, app, gateway,
+                       state, disabledAt);
+}
+
+// Drop every frame a device receives, or none
+void
+SetReceiveErrorRate (Ptr<NetDevice> device, double rate)
+{
+  Ptr<RateErrorModel> model = CreateObject<RateErrorModel> ();
+  model->SetRate (rate);
+  device->SetAttribute ("ReceiveErrorModel", PointerValue (model));
+}
+
+// Follow gateways towards a network from every router; count the walks
+// that come back to a router they already left
+void
+CountForwardingLoops (NodeContainer routers, const std::map<Ipv4Address, uint32_t> *owners,
+                      Ipv4Address network, Ipv4Mask mask, uint32_t *loops)
+{
+  for (uint32_t i = 0; i < routers.GetN (); i++)
+    {
+      std::set<uint32_t> visited;
+      uint32_t node = i;
+      while (visited.insert (node).second)
+        {
+          const auto r = FindStaticRoute (routers.Get (node), network, mask);
+          auto it = r ? owners->find (r->gateway) : owners->end ();
+          if (it == owners->end ())
+            {
+              node = routers.GetN ();
+              break;
+            }
+          node = it->second;
+        }
+      if (node < routers.GetN ())
+        {
+          (*loops)++;
+        }
+    }
+}
 
 } // namespace
 
@@ -485,6 +589,945 @@ public:
   }
 };
 
+class OspfL1IncrementalSpfMatchesFullSpfTest : public TestCase
+{
+public:
+  OspfL1IncrementalSpfMatchesFullSpfTest ()
+    : TestCase ("L1 incremental SPF reroutes like full SPF across link down/up")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> down;
+      std::optional<Ipv4Address> up;
+      OspfApp::SpfStats stats;
+      Ipv4Address viaR1;
+      Ipv4Address viaR3;
+    };
+
+    // On the two-path topology the (1,2) link goes down and comes back up
+    // after convergence.
+    auto run = [] (bool incremental) {
+      TwoPathTopology topology =
+          BuildTwoPathTopology (4, "10.30", "10.40", "EnableIncrementalSpf",
+                                BooleanValue (incremental));
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+
+      ScheduleLinkState (topology.d12, Seconds (3.0), false);
+      ScheduleLinkState (topology.d12, Seconds (5.0), true);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (2.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.down);
+      Simulator::Schedule (Seconds (7.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.up);
+
+      Simulator::Stop (Seconds (8.0));
+      Simulator::Run ();
+
+      result.stats = DynamicCast<OspfApp> (apps.Get (0))->GetSpfStats ();
+      result.viaR1 = topology.if01.GetAddress (1);
+      result.viaR3 = topology.if03.GetAddress (1);
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult full = run (false);
+    const RunResult incr = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (full.before.has_value (), true, "full SPF: route before link-down");
+    NS_TEST_ASSERT_MSG_EQ (full.down.has_value (), true, "full SPF: route while link is down");
+    NS_TEST_ASSERT_MSG_EQ (full.up.has_value (), true, "full SPF: route after link-up");
+    if (full.before && full.down && full.up)
+      {
+        NS_TEST_ASSERT_MSG_EQ (*full.before, full.viaR1, "full SPF should use r1 initially");
+        NS_TEST_ASSERT_MSG_EQ (*full.down, full.viaR3, "full SPF should fail over to r3");
+        NS_TEST_ASSERT_MSG_EQ (*full.up, full.viaR1, "full SPF should return to r1");
+      }
+    NS_TEST_ASSERT_MSG_EQ (full.stats.incrementalRuns, 0,
+                           "incremental SPF must not run when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((incr.before == full.before), true,
+                           "incremental SPF should match full SPF before link-down");
+    NS_TEST_ASSERT_MSG_EQ ((incr.down == full.down), true,
+                           "incremental SPF should match full SPF while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((incr.up == full.up), true,
+                           "incremental SPF should match full SPF after link-up");
+    NS_TEST_ASSERT_MSG_GT (incr.stats.incrementalRuns, 0,
+                           "later SPF runs should be incremental");
+    NS_TEST_ASSERT_MSG_GT (incr.stats.fullRuns, 0, "the first SPF run should be full");
+  }
+};
+
+class OspfL1EcmpMultipathTest : public TestCase
+{
+public:
+  OspfL1EcmpMultipathTest ()
+    : TestCase ("L1 ECMP installs every equal-cost next hop when MaxEcmpPaths allows it")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      bool hasMultipath = false;
+      std::vector<OspfRoutingProtocol::Path> paths;
+      std::optional<Ipv4Address> gateway;
+      Ipv4Address viaR1;
+      Ipv4Address viaR2;
+    };
+
+    // Routers r0..r3, stub network behind r3.
+    //   r0 - r1 - r3
+    //   r0 - r2 - r3
+    // Both paths cost 2 with the default interface metrics.
+    auto run = [] (uint32_t maxEcmpPaths) {
+      RngSeedManager::SetSeed (5);
+      RngSeedManager::SetRun (1);
+
+      NodeContainer routers;
+      routers.Create (4);
+      Ptr<Node> stub = CreateObject<Node> ();
+
+      NodeContainer all;
+      all.Add (routers);
+      all.Add (stub);
+
+      InternetStackHelper internet;
+      internet.Install (all);
+
+      PointToPointHelper p2p;
+      p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+      p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+      NetDeviceContainer d01 = p2p.Install (NodeContainer (routers.Get (0), routers.Get (1)));
+      NetDeviceContainer d02 = p2p.Install (NodeContainer (routers.Get (0), routers.Get (2)));
+      NetDeviceContainer d13 = p2p.Install (NodeContainer (routers.Get (1), routers.Get (3)));
+      NetDeviceContainer d23 = p2p.Install (NodeContainer (routers.Get (2), routers.Get (3)));
+      NetDeviceContainer d3h = p2p.Install (NodeContainer (routers.Get (3), stub));
+
+      Ipv4AddressHelper ipv4;
+      ipv4.SetBase ("10.50.1.0", "255.255.255.252");
+      Ipv4InterfaceContainer if01 = ipv4.Assign (d01);
+      ipv4.SetBase ("10.50.2.0", "255.255.255.252");
+      Ipv4InterfaceContainer if02 = ipv4.Assign (d02);
+      ipv4.SetBase ("10.50.3.0", "255.255.255.252");
+      ipv4.Assign (d13);
+      ipv4.SetBase ("10.50.4.0", "255.255.255.252");
+      ipv4.Assign (d23);
+      ipv4.SetBase ("10.99.0.0", "255.255.255.252");
+      ipv4.Assign (d3h);
+
+      OspfAppHelper ospf;
+      ConfigureFastColdStart (ospf);
+      ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+      ospf.SetAttribute ("MaxEcmpPaths", UintegerValue (maxEcmpPaths));
+
+      ApplicationContainer apps = ospf.Install (routers);
+      ospf.ConfigureReachablePrefixesFromInterfaces (routers);
+      apps.Start (Seconds (0.5));
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.gateway);
+
+      Simulator::Stop (Seconds (5.0));
+      Simulator::Run ();
+
+      Ptr<OspfRoutingProtocol> multipath =
+          DynamicCast<OspfApp> (apps.Get (0))->GetMultipathRouting ();
+      result.hasMultipath = multipath != nullptr;
+      if (multipath != nullptr)
+        {
+          result.paths = multipath->GetPaths (network, mask);
+        }
+      result.viaR1 = if01.GetAddress (1);
+      result.viaR2 = if02.GetAddress (1);
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult single = run (1);
+    NS_TEST_ASSERT_MSG_EQ (single.hasMultipath, false,
+                           "no multipath table should be created by default");
+    NS_TEST_ASSERT_MSG_EQ (single.gateway.has_value (), true,
+                           "single-path run should install the stub route");
+
+    const RunResult ecmp = run (2);
+    NS_TEST_ASSERT_MSG_EQ (ecmp.hasMultipath, true, "ECMP run should create the multipath table");
+    NS_TEST_ASSERT_MSG_EQ (ecmp.paths.size (), 2, "both equal-cost next hops should be installed");
+    bool viaR1 = false;
+    bool viaR2 = false;
+    for (const auto &path : ecmp.paths)
+      {
+        viaR1 |= path.first == ecmp.viaR1;
+        viaR2 |= path.first == ecmp.viaR2;
+      }
+    NS_TEST_ASSERT_MSG_EQ (viaR1, true, "ECMP should use r1");
+    NS_TEST_ASSERT_MSG_EQ (viaR2, true, "ECMP should use r2");
+    NS_TEST_ASSERT_MSG_EQ (ecmp.gateway.has_value (), true,
+                           "the static table should keep a single-path copy");
+    NS_TEST_ASSERT_MSG_EQ ((ecmp.gateway == single.gateway), true,
+                           "the single-path copy should match the default run");
+  }
+};
+
+class OspfL1SharedSpfGraphTest : public TestCase
+{
+public:
+  OspfL1SharedSpfGraphTest ()
+    : TestCase ("L1 SPF on graphs shared between routers reroutes like per-router SPF")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> down;
+      std::optional<Ipv4Address> up;
+      uint64_t fullRuns = 0;
+      uint64_t sharedGraphHits = 0;
+      uint64_t unchangedRuns = 0;
+    };
+
+    // On the two-path topology the (1,2) link goes down and comes back up
+    // after convergence.
+    auto run = [] (bool share) {
+      TwoPathTopology topology = BuildTwoPathTopology (6, "10.60", "10.70", "ShareSpfGraph",
+                                                       BooleanValue (share));
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+
+      ScheduleLinkState (topology.d12, Seconds (3.0), false);
+      ScheduleLinkState (topology.d12, Seconds (5.0), true);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (2.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.down);
+      Simulator::Schedule (Seconds (7.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.up);
+
+      Simulator::Stop (Seconds (8.0));
+      Simulator::Run ();
+
+      for (uint32_t i = 0; i < apps.GetN (); i++)
+        {
+          OspfApp::SpfStats stats = DynamicCast<OspfApp> (apps.Get (i))->GetSpfStats ();
+          result.fullRuns += stats.fullRuns;
+          result.sharedGraphHits += stats.sharedGraphHits;
+          result.unchangedRuns += stats.unchangedRuns;
+        }
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult own = run (false);
+    const RunResult shared = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (own.before.has_value (), true, "route before link-down");
+    NS_TEST_ASSERT_MSG_EQ (own.down.has_value (), true, "route while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((own.down != own.before), true, "the link-down should reroute");
+    NS_TEST_ASSERT_MSG_EQ (own.sharedGraphHits + own.unchangedRuns, 0,
+                           "nothing is shared when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((shared.before == own.before), true,
+                           "shared SPF should match per-router SPF before link-down");
+    NS_TEST_ASSERT_MSG_EQ ((shared.down == own.down), true,
+                           "shared SPF should match per-router SPF while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((shared.up == own.up), true,
+                           "shared SPF should match per-router SPF after link-up");
+    NS_TEST_ASSERT_MSG_GT (shared.sharedGraphHits, 0,
+                           "routers with the same LSDB should reuse each other's graph");
+    NS_TEST_ASSERT_MSG_LT (shared.sharedGraphHits, shared.fullRuns,
+                           "someone has to build each graph");
+  }
+};
+
+class OspfL1BatchedSpfTest : public TestCase
+{
+public:
+  OspfL1BatchedSpfTest ()
+    : TestCase ("L1 SPF batched on a worker pool installs the same routes as serial SPF")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> down;
+      std::optional<Ipv4Address> up;
+      uint64_t fullRuns = 0;
+      uint64_t batchedRuns = 0;
+    };
+
+    // On the two-path topology the (1,2) link goes down and comes back up
+    // after convergence.
+    auto run = [] (uint32_t threads) {
+      TwoPathTopology topology = BuildTwoPathTopology (6, "10.60", "10.70", "ParallelSpfThreads",
+                                                       UintegerValue (threads));
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+
+      ScheduleLinkState (topology.d12, Seconds (3.0), false);
+      ScheduleLinkState (topology.d12, Seconds (5.0), true);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (2.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.down);
+      Simulator::Schedule (Seconds (7.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.up);
+
+      Simulator::Stop (Seconds (8.0));
+      Simulator::Run ();
+
+      for (uint32_t i = 0; i < apps.GetN (); i++)
+        {
+          OspfApp::SpfStats stats = DynamicCast<OspfApp> (apps.Get (i))->GetSpfStats ();
+          result.fullRuns += stats.fullRuns;
+          result.batchedRuns += stats.batchedRuns;
+        }
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult serial = run (0);
+    const RunResult batched = run (4);
+    const RunResult again = run (4);
+
+    NS_TEST_ASSERT_MSG_EQ (serial.before.has_value (), true, "route before link-down");
+    NS_TEST_ASSERT_MSG_EQ (serial.down.has_value (), true, "route while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((serial.down != serial.before), true, "the link-down should reroute");
+    NS_TEST_ASSERT_MSG_EQ (serial.batchedRuns, 0, "nothing is batched when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((batched.before == serial.before), true,
+                           "batched SPF should match serial SPF before link-down");
+    NS_TEST_ASSERT_MSG_EQ ((batched.down == serial.down), true,
+                           "batched SPF should match serial SPF while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((batched.up == serial.up), true,
+                           "batched SPF should match serial SPF after link-up");
+    NS_TEST_ASSERT_MSG_GT (batched.batchedRuns, 0, "scheduled runs should be batched");
+
+    NS_TEST_ASSERT_MSG_EQ ((again.down == batched.down && again.up == batched.up), true,
+                           "batched runs should be reproducible");
+    NS_TEST_ASSERT_MSG_EQ (again.fullRuns, batched.fullRuns, "same runs on every repetition");
+  }
+};
+
+class OspfL1LoopFreeAlternateTest : public TestCase
+{
+public:
+  OspfL1LoopFreeAlternateTest ()
+    : TestCase ("Loop-free alternates repair a lost adjacency ahead of SPF")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> early;
+      std::optional<Ipv4Address> down;
+      OspfApp::LfaStats lfa;
+    };
+
+    // On the two-path topology the (0,1) link goes down after convergence;
+    // r0's alternate to r2 is r3, loop-free and node-protecting. A slow SPF
+    // leaves the early sample to the local repair.
+    auto run = [] (bool lfa) {
+      TwoPathTopology topology = BuildTwoPathTopology (
+          6, "10.60", "10.70", "EnableLfa", BooleanValue (lfa), [] (OspfAppHelper &ospf) {
+            ospf.SetAttribute ("ShortestPathUpdateDelay", TimeValue (Seconds (1)));
+          });
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+
+      ScheduleLinkState (topology.d01, Seconds (6.0), false);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (5.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (6.3), &RecordGateway, routers.Get (0), network, mask,
+                           &result.early);
+      Simulator::Schedule (Seconds (8.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.down);
+
+      Simulator::Stop (Seconds (9.0));
+      Simulator::Run ();
+
+      result.lfa = DynamicCast<OspfApp> (apps.Get (0))->GetLfaStats ();
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult plain = run (false);
+    const RunResult repaired = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (plain.before.has_value (), true, "route before link-down");
+    NS_TEST_ASSERT_MSG_EQ (plain.down.has_value (), true, "route after reconvergence");
+    NS_TEST_ASSERT_MSG_EQ ((plain.down != plain.before), true, "the link-down should reroute");
+    NS_TEST_ASSERT_MSG_EQ ((plain.early != plain.down), true,
+                           "without LFA the reroute waits for SPF");
+    NS_TEST_ASSERT_MSG_EQ (plain.lfa.protectedDestinations, 0, "no alternates when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((repaired.before == plain.before), true, "same primary route");
+    NS_TEST_ASSERT_MSG_EQ ((repaired.early == plain.down), true,
+                           "the alternate should carry traffic before SPF");
+    NS_TEST_ASSERT_MSG_EQ ((repaired.down == plain.down), true, "same route after SPF");
+    NS_TEST_ASSERT_MSG_GT (repaired.lfa.activations, 0, "the alternate was activated");
+    NS_TEST_ASSERT_MSG_GT (repaired.lfa.destinations, 0, "r0 has destinations");
+    NS_TEST_ASSERT_MSG_GT (repaired.lfa.protectedDestinations, 0, "some are protected");
+  }
+};
+
+class OspfNextHopGroupRerouteTest : public TestCase
+{
+public:
+  OspfNextHopGroupRerouteTest ()
+    : TestCase ("Next-hop groups reroute every prefix behind a router with one group write")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> down;
+      OspfApp::NextHopGroupStats stats;
+    };
+
+    // On the two-path topology r2 advertises 200 prefixes instead of its
+    // interfaces. The (0,1) link goes down after convergence and every
+    // prefix moves to r3.
+    auto run = [] (bool groups) {
+      TwoPathTopology topology = BuildTwoPathTopology (7, "10.80", "10.90", "EnableNextHopGroups",
+                                                       BooleanValue (groups));
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+      Ptr<OspfApp> app0 = DynamicCast<OspfApp> (apps.Get (0));
+      Simulator::Schedule (Seconds (1.0), &InjectPrefixes, DynamicCast<OspfApp> (apps.Get (2)),
+                           200);
+
+      Simulator::Schedule (Seconds (5.95), &OspfApp::ResetNextHopGroupStats, app0);
+      ScheduleLinkState (topology.d01, Seconds (6.0), false);
+
+      RunResult result;
+      const Ipv4Address network ("10.200.5.0");
+      const Ipv4Mask mask ("255.255.255.0");
+      if (groups)
+        {
+          Simulator::Schedule (Seconds (5.9), &RecordGroupGateway, app0, network, mask,
+                               &result.before);
+          Simulator::Schedule (Seconds (8.9), &RecordGroupGateway, app0, network, mask,
+                               &result.down);
+        }
+      else
+        {
+          Simulator::Schedule (Seconds (5.9), &RecordGateway, routers.Get (0), network, mask,
+                               &result.before);
+          Simulator::Schedule (Seconds (8.9), &RecordGateway, routers.Get (0), network, mask,
+                               &result.down);
+        }
+
+      Simulator::Stop (Seconds (9.0));
+      Simulator::Run ();
+
+      result.stats = app0->GetNextHopGroupStats ();
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult perPrefix = run (false);
+    const RunResult grouped = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (perPrefix.before.has_value (), true, "route before link-down");
+    NS_TEST_ASSERT_MSG_EQ (perPrefix.down.has_value (), true, "route after reconvergence");
+    NS_TEST_ASSERT_MSG_EQ ((perPrefix.down != perPrefix.before), true,
+                           "the link-down should reroute");
+    NS_TEST_ASSERT_MSG_GT (perPrefix.stats.routeUpdates, 200,
+                           "every prefix is rewritten in the static table");
+
+    NS_TEST_ASSERT_MSG_EQ ((grouped.before == perPrefix.before), true, "same route before");
+    NS_TEST_ASSERT_MSG_EQ ((grouped.down == perPrefix.down), true, "same route after");
+    NS_TEST_ASSERT_MSG_LT (grouped.stats.groups, grouped.stats.prefixes / 10,
+                           "the prefixes share a few groups");
+    NS_TEST_ASSERT_MSG_GT (grouped.stats.groupUpdates, 0, "the groups were rerouted");
+    NS_TEST_ASSERT_MSG_LT (grouped.stats.routeUpdates * 10, perPrefix.stats.routeUpdates,
+                           "the prefixes themselves are left alone");
+  }
+};
+
+class OspfSpfBackoffRerouteTest : public TestCase
+{
+public:
+  OspfSpfBackoffRerouteTest ()
+    : TestCase ("SPF back-off reacts to an isolated failure within the initial delay")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> early;
+      std::optional<Ipv4Address> down;
+      std::optional<Ipv4Address> up;
+      OspfApp::SpfBackoffStats backoff;
+    };
+
+    // On the two-path topology the (1,2) link goes down and comes back up
+    // after convergence.
+    auto run = [] (bool backoff) {
+      TwoPathTopology topology = BuildTwoPathTopology (
+          6, "10.60", "10.70", "EnableSpfBackoff", BooleanValue (backoff),
+          [backoff] (OspfAppHelper &ospf) {
+            if (backoff)
+              {
+                // The fixed delay would be far too slow for the early sample
+                ospf.SetAttribute ("ShortestPathUpdateDelay", TimeValue (Seconds (2)));
+                ospf.SetAttribute ("LongSpfDelay", TimeValue (Seconds (1)));
+                ospf.SetAttribute ("HoldDown", TimeValue (Seconds (1)));
+              }
+          });
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+
+      ScheduleLinkState (topology.d12, Seconds (3.0), false);
+      ScheduleLinkState (topology.d12, Seconds (5.0), true);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (2.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (3.3), &RecordGateway, routers.Get (0), network, mask,
+                           &result.early);
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.down);
+      Simulator::Schedule (Seconds (7.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.up);
+
+      Simulator::Stop (Seconds (8.0));
+      Simulator::Run ();
+
+      for (uint32_t i = 0; i < apps.GetN (); i++)
+        {
+          OspfApp::SpfBackoffStats stats =
+              DynamicCast<OspfApp> (apps.Get (i))->GetSpfBackoffStats ();
+          result.backoff.events += stats.events;
+          result.backoff.quietToShortWait += stats.quietToShortWait;
+          result.backoff.shortWaitToQuiet += stats.shortWaitToQuiet;
+          result.backoff.longWaitToQuiet += stats.longWaitToQuiet;
+        }
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult fixed = run (false);
+    const RunResult fast = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (fixed.down.has_value (), true, "route while link is down");
+    NS_TEST_ASSERT_MSG_EQ ((fixed.down != fixed.before), true, "the link-down should reroute");
+    NS_TEST_ASSERT_MSG_EQ (fixed.backoff.events, 0, "no back-off when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((fast.before == fixed.before), true, "same route before link-down");
+    NS_TEST_ASSERT_MSG_EQ ((fast.early == fixed.down), true,
+                           "the back-off should reroute within 300 ms of the failure");
+    NS_TEST_ASSERT_MSG_EQ ((fast.up == fixed.up), true, "same route after link-up");
+    // Cold start and the failure each start from QUIET
+    NS_TEST_ASSERT_MSG_GT (fast.backoff.quietToShortWait, 5, "routers left QUIET again");
+    NS_TEST_ASSERT_MSG_GT (fast.backoff.shortWaitToQuiet + fast.backoff.longWaitToQuiet, 0,
+                           "the back-off should settle between events");
+  }
+};
+
+class OspfSpfBackoffStateMachineTest : public TestCase
+{
+public:
+  OspfSpfBackoffStateMachineTest ()
+    : TestCase ("SPF back-off walks QUIET, SHORT_WAIT, LONG_WAIT and back")
+  {
+  }
+
+private:
+  static void
+  Trigger (OspfSpfBackoff *backoff, OspfSpfBackoff::Config config, std::vector<Time> *delays)
+  {
+    delays->push_back (backoff->Trigger (config));
+  }
+
+  static void
+  RecordState (OspfSpfBackoff *backoff, std::vector<OspfSpfBackoff::State> *states)
+  {
+    states->push_back (backoff->GetState ());
+  }
+
+  void
+  DoRun () override
+  {
+    OspfSpfBackoff::Config config;
+    config.initialDelay = MilliSeconds (50);
+    config.shortDelay = MilliSeconds (200);
+    config.longDelay = Seconds (5);
+    config.holdDown = Seconds (2);
+    config.timeToLearn = MilliSeconds (500);
+
+    OspfSpfBackoff backoff;
+    std::vector<Time> delays;
+    std::vector<OspfSpfBackoff::State> states;
+    // A burst at 1 s, a lone event at 10 s
+    for (double t : {1.0, 1.1, 1.4, 1.6, 3.0, 10.0})
+      {
+        Simulator::Schedule (Seconds (t), &Trigger, &backoff, config, &delays);
+      }
+    for (double t : {0.5, 1.2, 1.7, 4.9, 5.1, 10.1})
+      {
+        Simulator::Schedule (Seconds (t), &RecordState, &backoff, &states);
+      }
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    const std::vector<Time> expectedDelays = {MilliSeconds (50), MilliSeconds (200),
+                                              MilliSeconds (200), Seconds (5),
+                                              Seconds (5), MilliSeconds (50)};
+    NS_TEST_ASSERT_MSG_EQ (delays.size (), expectedDelays.size (), "one delay per event");
+    for (uint32_t i = 0; i < delays.size (); i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ (delays[i], expectedDelays[i], "delay of event " << i);
+      }
+    // The event at 3 s pushes the hold-down from 3.6 s to 5 s
+    const std::vector<OspfSpfBackoff::State> expectedStates = {
+        OspfSpfBackoff::QUIET,     OspfSpfBackoff::SHORT_WAIT, OspfSpfBackoff::LONG_WAIT,
+        OspfSpfBackoff::LONG_WAIT, OspfSpfBackoff::QUIET,      OspfSpfBackoff::SHORT_WAIT};
+    NS_TEST_ASSERT_MSG_EQ (states.size (), expectedStates.size (), "one state per sample");
+    for (uint32_t i = 0; i < states.size (); i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ (states[i], expectedStates[i], "state at sample " << i);
+      }
+
+    const OspfSpfBackoff::Stats &stats = backoff.GetStats ();
+    NS_TEST_EXPECT_MSG_EQ (stats.events, 6, "every event counted");
+    NS_TEST_EXPECT_MSG_EQ (stats.quietToShortWait, 2, "burst and lone event");
+    // The lone event's learn timer still fires before its hold-down
+    NS_TEST_EXPECT_MSG_EQ (stats.shortToLongWait, 2, "TimeToLearn passed twice");
+    NS_TEST_EXPECT_MSG_EQ (stats.longWaitToQuiet, 2, "both settle");
+    NS_TEST_EXPECT_MSG_EQ (stats.shortWaitToQuiet, 0, "hold-down outlasts TimeToLearn");
+    NS_TEST_EXPECT_MSG_EQ (backoff.GetState (), OspfSpfBackoff::QUIET, "quiet at the end");
+  }
+};
+
+class OspfOrderedFibTest : public TestCase
+{
+public:
+  OspfOrderedFibTest ()
+    : TestCase ("Ordered FIB updates keep a grid loop-free while it reconverges")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> before;
+      std::optional<Ipv4Address> down;
+      std::optional<Ipv4Address> up;
+      uint32_t loops = 0;
+      uint64_t holds = 0;
+    };
+
+    // 3x3 grid of routers, stub network behind r8:
+    //   r0 - r1 - r2
+    //   |    |    |
+    //   r3 - r4 - r5
+    //   |    |    |
+    //   r6 - r7 - r8 - stub
+    // As in ospf-grid-random-error, the (5,8) link drops every frame for a
+    // while, then recovers. Every router's next hop towards the stub is
+    // followed every 5 ms from the failure until after the recovery.
+    // r4 -> r7 costs 2, so r4 reaches the stub through r5 until the failure,
+    // and r4 takes 400 ms to update its FIB. Without ordering, r5 moves to
+    // r4 first and traffic loops between them until r4 catches up.
+    auto run = [] (bool ordered) {
+      RngSeedManager::SetSeed (7);
+      RngSeedManager::SetRun (1);
+
+      NodeContainer routers;
+      routers.Create (9);
+      Ptr<Node> stub = CreateObject<Node> ();
+
+      NodeContainer all;
+      all.Add (routers);
+      all.Add (stub);
+
+      InternetStackHelper internet;
+      internet.Install (all);
+
+      PointToPointHelper p2p;
+      p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+      p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+      Ipv4AddressHelper ipv4;
+      uint32_t subnet = 0;
+      NetDeviceContainer d47;
+      NetDeviceContainer d58;
+      auto connect = [&] (uint32_t a, uint32_t b) {
+        NetDeviceContainer devices =
+            p2p.Install (NodeContainer (routers.Get (a), routers.Get (b)));
+        const std::string base = "10.80." + std::to_string (++subnet) + ".0";
+        ipv4.SetBase (base.c_str (), "255.255.255.252");
+        ipv4.Assign (devices);
+        return devices;
+      };
+      for (uint32_t row = 0; row < 3; row++)
+        {
+          for (uint32_t col = 0; col < 3; col++)
+            {
+              const uint32_t i = row * 3 + col;
+              if (col < 2)
+                {
+                  connect (i, i + 1);
+                }
+              if (row < 2)
+                {
+                  NetDeviceContainer devices = connect (i, i + 3);
+                  if (i == 4)
+                    {
+                      d47 = devices;
+                    }
+                  if (i == 5)
+                    {
+                      d58 = devices;
+                    }
+                }
+            }
+        }
+      NetDeviceContainer d8h = p2p.Install (NodeContainer (routers.Get (8), stub));
+      ipv4.SetBase ("10.99.0.0", "255.255.255.252");
+      ipv4.Assign (d8h);
+
+      OspfAppHelper ospf;
+      ConfigureFastColdStart (ospf);
+      ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+      ospf.SetAttribute ("EnableOrderedFib", BooleanValue (ordered));
+      // Longer than r4 takes to update
+      ospf.SetAttribute ("OrderedFibDelay", TimeValue (MilliSeconds (500)));
+
+      ApplicationContainer apps = ospf.Install (routers);
+      ospf.ConfigureReachablePrefixesFromInterfaces (routers);
+      Ptr<OspfApp> app4 = DynamicCast<OspfApp> (apps.Get (4));
+      app4->SetAttribute ("ShortestPathUpdateDelay", TimeValue (MilliSeconds (400)));
+      std::vector<uint32_t> metrics;
+      for (uint32_t i = 0; i < routers.Get (4)->GetNDevices (); i++)
+        {
+          metrics.push_back (app4->GetMetric (i));
+        }
+      metrics[d47.Get (0)->GetIfIndex ()] = 2;
+      app4->SetMetrices (metrics);
+      apps.Start (Seconds (0.5));
+
+      std::map<Ipv4Address, uint32_t> owners;
+      for (uint32_t i = 0; i < routers.GetN (); i++)
+        {
+          Ptr<Ipv4> ip = routers.Get (i)->GetObject<Ipv4> ();
+          for (uint32_t j = 1; j < ip->GetNInterfaces (); j++)
+            {
+              owners[ip->GetAddress (j, 0).GetLocal ()] = i;
+            }
+        }
+
+      Simulator::Schedule (Seconds (6.0), &SetReceiveErrorRate, d58.Get (0), 1.0);
+      Simulator::Schedule (Seconds (6.0), &SetReceiveErrorRate, d58.Get (1), 1.0);
+      Simulator::Schedule (Seconds (10.0), &SetReceiveErrorRate, d58.Get (0), 0.0);
+      Simulator::Schedule (Seconds (10.0), &SetReceiveErrorRate, d58.Get (1), 0.0);
+
+      RunResult result;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      for (Time t = Seconds (6.0); t < Seconds (14.0); t += MilliSeconds (5))
+        {
+          Simulator::Schedule (t, &CountForwardingLoops, routers, &owners, network, mask,
+                               &result.loops);
+        }
+      Simulator::Schedule (Seconds (5.9), &RecordGateway, routers.Get (5), network, mask,
+                           &result.before);
+      Simulator::Schedule (Seconds (9.9), &RecordGateway, routers.Get (5), network, mask,
+                           &result.down);
+      Simulator::Schedule (Seconds (13.9), &RecordGateway, routers.Get (5), network, mask,
+                           &result.up);
+
+      Simulator::Stop (Seconds (14.0));
+      Simulator::Run ();
+
+      for (uint32_t i = 0; i < apps.GetN (); i++)
+        {
+          result.holds += DynamicCast<OspfApp> (apps.Get (i))->GetOrderedFibStats ().holds;
+        }
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult plain = run (false);
+    const RunResult ordered = run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (plain.before.has_value (), true, "route before the failure");
+    NS_TEST_ASSERT_MSG_EQ (plain.down.has_value (), true, "route while the link is down");
+    NS_TEST_ASSERT_MSG_EQ ((plain.down != plain.before), true, "the failure should reroute r5");
+    NS_TEST_ASSERT_MSG_EQ ((plain.up == plain.before), true, "the recovery should restore it");
+    NS_TEST_ASSERT_MSG_EQ (plain.holds, 0, "no holds when disabled");
+    NS_TEST_ASSERT_MSG_GT (plain.loops, 0, "r5 and r4 should loop without ordering");
+
+    NS_TEST_ASSERT_MSG_EQ ((ordered.before == plain.before), true, "same route before");
+    NS_TEST_ASSERT_MSG_EQ ((ordered.down == plain.down), true, "same route while down");
+    NS_TEST_ASSERT_MSG_EQ ((ordered.up == plain.up), true, "same route after recovery");
+    NS_TEST_ASSERT_MSG_GT (ordered.holds, 0, "some routers waited for their rank");
+    NS_TEST_ASSERT_MSG_EQ (ordered.loops, 0, "no forwarding loop while reconverging");
+  }
+};
+
+class OspfStubRouterTest : public TestCase
+{
+public:
+  OspfStubRouterTest ()
+    : TestCase ("Stub-router mode keeps transit off a starting or draining router")
+  {
+  }
+
+  void
+  DoRun () override
+  {
+    struct RunResult
+    {
+      std::optional<Ipv4Address> start;
+      std::optional<Ipv4Address> early;
+      std::optional<Ipv4Address> up;
+      std::optional<Ipv4Address> draining;
+      std::optional<Ipv4Address> drained;
+      bool stubEarly = false;
+      bool stubUp = false;
+      bool drainingState[3] = {false, false, false}; // stub, draining, enabled
+      bool drainedState[3] = {false, false, false};
+      Time disabledAt = Time::Max ();
+    };
+
+    // On the two-path topology r1 starts at 5 s, after the others converged
+    // on the long path, and is drained at 10 s with a 3 s DrainTime. The
+    // draining samples are the last ones taken before r1 stops.
+    auto run = [] (Time stubPeriod, bool untilSync) {
+      TwoPathTopology topology = BuildTwoPathTopology (
+          8, "10.61", "10.71", "StubRouterPeriod", TimeValue (stubPeriod),
+          [untilSync] (OspfAppHelper &ospf) {
+            ospf.SetAttribute ("StubRouterUntilSync", BooleanValue (untilSync));
+            ospf.SetAttribute ("DrainTime", TimeValue (Seconds (3)));
+          });
+      NodeContainer &routers = topology.routers;
+      ApplicationContainer &apps = topology.apps;
+      apps.Get (1)->SetStartTime (Seconds (5.0));
+
+      Ptr<OspfApp> app1 = DynamicCast<OspfApp> (apps.Get (1));
+      Simulator::Schedule (Seconds (10.0), &OspfApp::Drain, app1);
+
+      RunResult result;
+      bool enabled;
+      bool draining;
+      const Ipv4Address network ("10.99.0.0");
+      const Ipv4Mask mask ("255.255.255.252");
+      Simulator::Schedule (Seconds (4.9), &RecordGateway, routers.Get (0), network, mask,
+                           &result.start);
+      Simulator::Schedule (Seconds (6.0), &RecordGateway, routers.Get (0), network, mask,
+                           &result.early);
+      Simulator::Schedule (Seconds (6.0), &RecordStubRouterState, app1, &result.stubEarly,
+                           &draining, &enabled);
+      Simulator::Schedule (Seconds (9.0), &RecordGateway, routers.Get (0), network, mask,
+                           &result.up);
+      Simulator::Schedule (Seconds (9.0), &RecordStubRouterState, app1, &result.stubUp,
+                           &draining, &enabled);
+      Simulator::Schedule (Seconds (10.0), &RecordUntilDisabled, routers.Get (0), network, mask,
+                           app1, &result.draining, result.drainingState, &result.disabledAt);
+      Simulator::Schedule (Seconds (14.0), &RecordGateway, routers.Get (0), network, mask,
+                           &result.drained);
+      Simulator::Schedule (Seconds (14.0), &RecordStubRouterState, app1,
+                           &result.drainedState[0], &result.drainedState[1],
+                           &result.drainedState[2]);
+
+      Simulator::Stop (Seconds (14.5));
+      Simulator::Run ();
+      Simulator::Destroy ();
+      return result;
+    };
+
+    const RunResult plain = run (Seconds (0), true);
+    const RunResult period = run (Seconds (3), false);
+    const RunResult synced = run (Seconds (30), true);
+
+    NS_TEST_ASSERT_MSG_EQ (plain.start.has_value (), true, "route around r1 before it starts");
+    NS_TEST_ASSERT_MSG_EQ (plain.up.has_value (), true, "route once r1 is up");
+    NS_TEST_ASSERT_MSG_EQ ((plain.up != plain.start), true, "r1 is on the shorter path");
+    NS_TEST_ASSERT_MSG_EQ ((plain.early == plain.up), true,
+                           "without stub-router mode r1 carries transit at once");
+    NS_TEST_ASSERT_MSG_EQ (plain.stubEarly, false, "not a stub router when disabled");
+
+    NS_TEST_ASSERT_MSG_EQ ((period.early == plain.start), true,
+                           "no transit through r1 within StubRouterPeriod");
+    NS_TEST_ASSERT_MSG_EQ (period.stubEarly, true, "r1 is a stub router within the period");
+    NS_TEST_ASSERT_MSG_EQ ((period.up == plain.up), true, "transit through r1 after it");
+    NS_TEST_ASSERT_MSG_EQ (period.stubUp, false, "the period is over");
+
+    NS_TEST_ASSERT_MSG_EQ ((synced.up == plain.up), true,
+                           "the period ends once r1's LSDB is synchronized");
+    NS_TEST_ASSERT_MSG_EQ (synced.stubUp, false, "well before StubRouterPeriod");
+
+    for (const RunResult *result : {&plain, &period, &synced})
+      {
+        NS_TEST_ASSERT_MSG_EQ ((result->draining == plain.start), true,
+                               "traffic moves off r1 while it drains");
+        NS_TEST_ASSERT_MSG_EQ (result->drainingState[0], true, "draining r1 is a stub router");
+        NS_TEST_ASSERT_MSG_EQ (result->drainingState[1], true, "r1 is draining");
+        NS_TEST_ASSERT_MSG_EQ (result->drainingState[2], true, "r1 runs while it drains");
+        NS_TEST_ASSERT_MSG_LT (result->disabledAt, Seconds (13.0),
+                               "r1 stops once the others routed around it, before DrainTime");
+        NS_TEST_ASSERT_MSG_EQ ((result->drained == plain.start), true, "same route once r1 is off");
+        NS_TEST_ASSERT_MSG_EQ (result->drainedState[1], false, "the drain is over");
+        NS_TEST_ASSERT_MSG_EQ (result->drainedState[2], false, "r1 is disabled");
+      }
+  }
+};
+
 class OspfSpfTestSuite : public TestSuite
 {
 public:
@@ -494,6 +1537,16 @@ public:
     AddTestCase (new OspfL1ShortestPathLinearColdStartTest, TestCase::QUICK);
     AddTestCase (new OspfL1TwoPathShortestHopCountTest, TestCase::QUICK);
     AddTestCase (new OspfL2MultiAreaShortestAreaPathTest, TestCase::QUICK);
+    AddTestCase (new OspfL1IncrementalSpfMatchesFullSpfTest, TestCase::QUICK);
+    AddTestCase (new OspfL1EcmpMultipathTest, TestCase::QUICK);
+    AddTestCase (new OspfL1SharedSpfGraphTest, TestCase::QUICK);
+    AddTestCase (new OspfL1BatchedSpfTest, TestCase::QUICK);
+    AddTestCase (new OspfL1LoopFreeAlternateTest, TestCase::QUICK);
+    AddTestCase (new OspfNextHopGroupRerouteTest, TestCase::QUICK);
+    AddTestCase (new OspfSpfBackoffRerouteTest, TestCase::QUICK);
+    AddTestCase (new OspfSpfBackoffStateMachineTest, TestCase::QUICK);
+    AddTestCase (new OspfOrderedFibTest, TestCase::QUICK);
+    AddTestCase (new OspfStubRouterTest, TestCase::QUICK);
   }
 };
 
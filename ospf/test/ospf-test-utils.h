@@ -5,11 +5,14 @@
 
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
 
 #include "ns3/ospf-app-helper.h"
+#include "ns3/ospf-routing-helper.h"
 
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <initializer_list>
 #include <optional>
 #include <sstream>
@@ -128,6 +131,163 @@ ConfigureFastColdStart (OspfAppHelper &ospf)
   ospf.SetAttribute ("LSUInterval", TimeValue (MilliSeconds (500)));
 }
 
+// Routers r0..r4 on two paths, stub network 10.99.0.0/30 behind r2:
+//   short: r0 - r1 - r2    (/30s from shortNet.1.0)
+//   long:  r0 - r3 - r4 - r2    (/30s from longNet.1.0)
+struct TwoPathTopology
+{
+  NodeContainer routers;
+  NetDeviceContainer d01;
+  NetDeviceContainer d12;
+  Ipv4InterfaceContainer if01;
+  Ipv4InterfaceContainer if03;
+  ApplicationContainer apps;
+};
+
+// Build the two-path topology with the given seed, and start OSPF at 0.5 s
+// with fast cold-start timers, interface tracking and attribute set to
+// value. configure may set further attributes on the helper.
+inline TwoPathTopology
+BuildTwoPathTopology (uint32_t seed, const std::string &shortNet, const std::string &longNet,
+                      const std::string &attribute, const AttributeValue &value,
+                      const std::function<void (OspfAppHelper &)> &configure = nullptr)
+{
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (1);
+
+  TwoPathTopology topology;
+  NodeContainer &routers = topology.routers;
+  routers.Create (5);
+  Ptr<Node> stub = CreateObject<Node> ();
+
+  NodeContainer all;
+  all.Add (routers);
+  all.Add (stub);
+
+  InternetStackHelper internet;
+  internet.Install (all);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+  topology.d01 = p2p.Install (NodeContainer (routers.Get (0), routers.Get (1)));
+  topology.d12 = p2p.Install (NodeContainer (routers.Get (1), routers.Get (2)));
+  NetDeviceContainer d03 = p2p.Install (NodeContainer (routers.Get (0), routers.Get (3)));
+  NetDeviceContainer d34 = p2p.Install (NodeContainer (routers.Get (3), routers.Get (4)));
+  NetDeviceContainer d42 = p2p.Install (NodeContainer (routers.Get (4), routers.Get (2)));
+  NetDeviceContainer d2h = p2p.Install (NodeContainer (routers.Get (2), stub));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ((shortNet + ".1.0").c_str (), "255.255.255.252");
+  topology.if01 = ipv4.Assign (topology.d01);
+  ipv4.SetBase ((shortNet + ".2.0").c_str (), "255.255.255.252");
+  ipv4.Assign (topology.d12);
+  ipv4.SetBase ((longNet + ".1.0").c_str (), "255.255.255.252");
+  topology.if03 = ipv4.Assign (d03);
+  ipv4.SetBase ((longNet + ".2.0").c_str (), "255.255.255.252");
+  ipv4.Assign (d34);
+  ipv4.SetBase ((longNet + ".3.0").c_str (), "255.255.255.252");
+  ipv4.Assign (d42);
+  ipv4.SetBase ("10.99.0.0", "255.255.255.252");
+  ipv4.Assign (d2h);
+
+  OspfAppHelper ospf;
+  ConfigureFastColdStart (ospf);
+  ospf.SetAttribute ("AreaMask", Ipv4MaskValue (Ipv4Mask ("255.255.255.252")));
+  ospf.SetAttribute ("AutoSyncInterfaces", BooleanValue (true));
+  ospf.SetAttribute ("InterfaceSyncInterval", TimeValue (MilliSeconds (50)));
+  ospf.SetAttribute (attribute, value);
+  if (configure)
+    {
+      configure (ospf);
+    }
+
+  topology.apps = ospf.Install (routers);
+  ospf.ConfigureReachablePrefixesFromInterfaces (routers);
+  topology.apps.Start (Seconds (0.5));
+  return topology;
+}
+
+// Bring both ends of a point-to-point link down or up at the given time
+inline void
+ScheduleLinkState (const NetDeviceContainer &link, Time at, bool up)
+{
+  for (uint32_t i = 0; i < link.GetN (); i++)
+    {
+      Ptr<NetDevice> device = link.Get (i);
+      Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+      const uint32_t interface = ipv4->GetInterfaceForDevice (device);
+      Simulator::Schedule (at, up ? &Ipv4::SetUp : &Ipv4::SetDown, ipv4, interface);
+    }
+}
+
+// Routers n0 - n1 - n2 - n3 in a line, links 10.1.1.0, 10.1.2.0 and 10.1.3.0
+struct FourRouterLine
+{
+  NodeContainer nodes;
+  NetDeviceContainer devices12;
+  ApplicationContainer apps;
+};
+
+// Build the line with 2 ms links, and start OSPF at 0.5 s with fast
+// cold-start timers, interface tracking and attribute, if any, set to
+// value. routing, if given, is installed before OSPF; configure may set
+// further attributes on the helper.
+inline FourRouterLine
+BuildFourRouterLine (const std::string &attribute = "",
+                     const AttributeValue &value = EmptyAttributeValue (),
+                     const OspfRoutingHelper *routing = nullptr,
+                     const std::function<void (OspfAppHelper &)> &configure = nullptr,
+                     Ipv4Mask mask = Ipv4Mask ("255.255.255.0"))
+{
+  FourRouterLine line;
+  NodeContainer &nodes = line.nodes;
+  nodes.Create (4);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer devices01 = p2p.Install (nodes.Get (0), nodes.Get (1));
+  line.devices12 = p2p.Install (nodes.Get (1), nodes.Get (2));
+  NetDeviceContainer devices23 = p2p.Install (nodes.Get (2), nodes.Get (3));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", mask);
+  address.Assign (devices01);
+  address.SetBase ("10.1.2.0", mask);
+  address.Assign (line.devices12);
+  address.SetBase ("10.1.3.0", mask);
+  address.Assign (devices23);
+
+  if (routing != nullptr)
+    {
+      routing->Install (nodes);
+    }
+
+  OspfAppHelper ospfHelper;
+  ConfigureFastColdStart (ospfHelper);
+  ospfHelper.SetAttribute ("AreaMask", Ipv4MaskValue (mask));
+  ospfHelper.SetAttribute ("AutoSyncInterfaces", BooleanValue (true));
+  ospfHelper.SetAttribute ("InterfaceSyncInterval", TimeValue (MilliSeconds (50)));
+  if (!attribute.empty ())
+    {
+      ospfHelper.SetAttribute (attribute, value);
+    }
+  if (configure)
+    {
+      configure (ospfHelper);
+    }
+  line.apps = ospfHelper.Install (nodes);
+  ospfHelper.ConfigureReachablePrefixesFromInterfaces (nodes);
+  line.apps.Start (Seconds (0.5));
+  return line;
+}
+
 } // namespace ns3::ospf_test_utils
 
 #endif // OSPF_TEST_UTILS_H